@@ -32,6 +32,7 @@ list (APPEND MAIN_SOURCE_FILES
         opm/core/flowdiagnostics/AnisotropicEikonal.cpp
         opm/core/flowdiagnostics/DGBasis.cpp
         opm/core/flowdiagnostics/FlowDiagnostics.cpp
+        opm/core/flowdiagnostics/StreamlineTracer.cpp
         opm/core/flowdiagnostics/TofDiscGalReorder.cpp
         opm/core/flowdiagnostics/TofReorder.cpp
         opm/core/linalg/LinearSolverFactory.cpp
@@ -49,6 +50,8 @@ list (APPEND MAIN_SOURCE_FILES
         opm/core/pressure/mimetic/mimetic.c
         opm/core/pressure/msmfem/dfs.c
         opm/core/pressure/msmfem/partition.c
+        opm/core/pressure/tpfa/cell_graph_matrix.c
+        opm/core/pressure/tpfa/cfs_tpfa_kernels.cpp
         opm/core/pressure/tpfa/cfs_tpfa_residual.c
         opm/core/pressure/tpfa/ifs_tpfa.c
         opm/core/pressure/tpfa/trans_tpfa.c
@@ -66,6 +69,7 @@ list (APPEND MAIN_SOURCE_FILES
         opm/core/props/satfunc/SaturationPropsBasic.cpp
         opm/core/props/satfunc/SaturationPropsFromDeck.cpp
         opm/core/simulator/BlackoilState.cpp
+        opm/core/simulator/SequentialSplittingStepper.cpp
         opm/core/simulator/TwophaseState.cpp
         opm/core/simulator/SimulatorReport.cpp
         opm/core/transport/TransportSolverTwophaseInterface.cpp
@@ -76,7 +80,10 @@ list (APPEND MAIN_SOURCE_FILES
         opm/core/transport/reorder/TransportSolverTwophaseReorder.cpp
         opm/core/transport/reorder/reordersequence.cpp
         opm/core/transport/reorder/tarjan.c
+        opm/core/utility/BufferedLog.cpp
         opm/core/utility/Event.cpp
+        opm/core/utility/GridRenumbering.cpp
+        opm/core/utility/Instrumentation.cpp
         opm/core/utility/MonotCubicInterpolator.cpp
         opm/core/utility/NullStream.cpp
         opm/core/utility/VelocityInterpolation.cpp
@@ -88,6 +95,8 @@ list (APPEND MAIN_SOURCE_FILES
         opm/core/wells/InjectionSpecification.cpp
         opm/core/wells/ProductionSpecification.cpp
         opm/core/wells/WellCollection.cpp
+        opm/core/wells/WellGeometryCache.cpp
+        opm/core/wells/WellGroupTree.cpp
         opm/core/wells/WellsGroup.cpp
         opm/core/wells/WellsManager.cpp
         opm/core/wells/well_controls.c
@@ -100,18 +109,29 @@ list (APPEND TEST_SOURCE_FILES
 	tests/test_compressedpropertyaccess.cpp
 	tests/test_dgbasis.cpp
 	tests/test_cubic.cpp
+	tests/test_bufferedlog.cpp
+	tests/test_cell_graph_matrix.cpp
+	tests/test_cfs_tpfa_kernels.cpp
 	tests/test_event.cpp
+	tests/test_instrumentation.cpp
+	tests/test_rootfinders.cpp
 	tests/test_flowdiagnostics.cpp
+	tests/test_gridrenumbering.cpp
 	tests/test_nonuniformtablelinear.cpp
 	tests/test_parallelistlinformation.cpp
 	tests/test_sparsevector.cpp
+	tests/test_streamlinetracer.cpp
+	tests/test_transportsolvertwophasereorder.cpp
+	tests/test_transportsource.cpp
        tests/test_velocityinterpolation.cpp
 	tests/test_uniformtablelinear.cpp
 	tests/test_wells.cpp
 	tests/test_wachspresscoord.cpp
 	tests/test_linearsolver.cpp
 	tests/test_parallel_linearsolver.cpp
+	tests/test_umfpacksolver.cpp
 	tests/test_satfunc.cpp
+	tests/test_sequentialsplitting.cpp
 	tests/test_shadow.cpp
 	tests/test_equil.cpp
 	tests/test_regionmapping.cpp
@@ -138,6 +158,7 @@ list (APPEND TEST_DATA_FILES
 	tests/deadfluids.DATA
 	tests/equil_livegas.DATA
 	tests/equil_liveoil.DATA
+	tests/equil_liveoil_column.DATA
 	tests/equil_rsvd_and_rvvd.DATA
 	tests/wetgas.DATA
 	tests/satfuncStandard.DATA
@@ -195,6 +216,7 @@ list (APPEND PUBLIC_HEADER_FILES
         opm/core/flowdiagnostics/AnisotropicEikonal.hpp
         opm/core/flowdiagnostics/DGBasis.hpp
         opm/core/flowdiagnostics/FlowDiagnostics.hpp
+        opm/core/flowdiagnostics/StreamlineTracer.hpp
         opm/core/flowdiagnostics/TofDiscGalReorder.hpp
         opm/core/flowdiagnostics/TofReorder.hpp
         opm/core/linalg/LinearSolverFactory.hpp
@@ -216,6 +238,8 @@ list (APPEND PUBLIC_HEADER_FILES
         opm/core/pressure/msmfem/partition.h
         opm/core/pressure/tpfa/TransTpfa.hpp
         opm/core/pressure/tpfa/TransTpfa_impl.hpp
+        opm/core/pressure/tpfa/cell_graph_matrix.h
+        opm/core/pressure/tpfa/cfs_tpfa_kernels.h
         opm/core/pressure/tpfa/cfs_tpfa_residual.h
         opm/core/pressure/tpfa/compr_quant_general.h
         opm/core/pressure/tpfa/compr_source.h
@@ -250,6 +274,7 @@ list (APPEND PUBLIC_HEADER_FILES
         opm/core/simulator/EquilibrationHelpers.hpp
         opm/core/simulator/ExplicitArraysFluidState.hpp
         opm/core/simulator/ExplicitArraysSatDerivativesFluidState.hpp
+        opm/core/simulator/SequentialSplittingStepper.hpp
         opm/core/simulator/SimulatorReport.hpp
         opm/core/simulator/TwophaseState.hpp
         opm/core/simulator/WellState.hpp
@@ -275,12 +300,15 @@ list (APPEND PUBLIC_HEADER_FILES
         opm/core/transport/reorder/reordersequence.h
         opm/core/transport/reorder/tarjan.h
         opm/core/utility/Average.hpp
+        opm/core/utility/BufferedLog.hpp
         opm/core/utility/CompressedPropertyAccess.hpp
         opm/core/utility/DataMap.hpp
         opm/core/utility/Event.hpp
         opm/core/utility/Event_impl.hpp
         opm/core/utility/Factory.hpp
         opm/core/utility/initHydroCarbonState.hpp
+        opm/core/utility/GridRenumbering.hpp
+        opm/core/utility/Instrumentation.hpp
         opm/core/utility/MonotCubicInterpolator.hpp
         opm/core/utility/NonuniformTableLinear.hpp
         opm/core/utility/NullStream.hpp
@@ -304,6 +332,8 @@ list (APPEND PUBLIC_HEADER_FILES
         opm/core/wells/InjectionSpecification.hpp
         opm/core/wells/ProductionSpecification.hpp
         opm/core/wells/WellCollection.hpp
+        opm/core/wells/WellGeometryCache.hpp
+        opm/core/wells/WellGroupTree.hpp
         opm/core/wells/WellsGroup.hpp
         opm/core/wells/WellsManager.hpp
         opm/core/wells/DynamicListEconLimited.hpp
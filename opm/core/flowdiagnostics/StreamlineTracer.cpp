@@ -0,0 +1,311 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/flowdiagnostics/StreamlineTracer.hpp>
+#include <opm/core/utility/VelocityInterpolation.hpp>
+#include <opm/core/utility/Instrumentation.hpp>
+#include <opm/core/grid.h>
+#include <opm/common/ErrorMacros.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Opm
+{
+
+    namespace
+    {
+        enum { MaxDim = 3 };
+
+        // Signed distance (scaled by face area) from the plane of a
+        // face to x, positive on the outside of the given cell.
+        double outsideDistance(const UnstructuredGrid& grid,
+                               const int cell,
+                               const int face,
+                               const double* x)
+        {
+            const int dim = grid.dimensions;
+            const double* n = grid.face_normals + dim*face;
+            const double* c = grid.face_centroids + dim*face;
+            double dist = 0.0;
+            for (int dd = 0; dd < dim; ++dd) {
+                dist += n[dd]*(x[dd] - c[dd]);
+            }
+            return grid.face_cells[2*face] == cell ? dist : -dist;
+        }
+
+        double norm(const double* v, const int dim)
+        {
+            double n2 = 0.0;
+            for (int dd = 0; dd < dim; ++dd) {
+                n2 += v[dd]*v[dd];
+            }
+            return std::sqrt(n2);
+        }
+    } // anonymous namespace
+
+
+
+
+    // --------  Methods of class StreamlineTracer  --------
+
+
+    /// Construct tracer.
+    StreamlineTracer::StreamlineTracer(const UnstructuredGrid& grid,
+                                       const VelocityInterpolationInterface& velocity,
+                                       const double* porevolume,
+                                       const int steps_per_cell,
+                                       const int max_cells)
+        : grid_(grid),
+          velocity_(velocity),
+          porevolume_(porevolume),
+          steps_per_cell_(steps_per_cell),
+          max_cells_(max_cells)
+    {
+        if (grid.dimensions > MaxDim) {
+            OPM_THROW(std::runtime_error, "StreamlineTracer requires a grid with at most "
+                      << MaxDim << " dimensions.");
+        }
+        if (steps_per_cell < 1 || max_cells < 1) {
+            OPM_THROW(std::runtime_error, "StreamlineTracer requires positive steps_per_cell and max_cells.");
+        }
+    }
+
+
+
+
+    /// Trace streamlines from a number of seed points.
+    void StreamlineTracer::trace(const int num_seeds,
+                                 const int* seed_cells,
+                                 const double* seed_points,
+                                 const Direction direction,
+                                 const Consumer& consumer,
+                                 const int chunk_size) const
+    {
+        OPM_TIMER_SCOPE("streamline tracing");
+        const int dim = grid_.dimensions;
+        // The streamline buffers are reused from chunk to chunk.
+        std::vector<Streamline> chunk(std::max(1, std::min(chunk_size, num_seeds)));
+        for (int begin = 0; begin < num_seeds; begin += chunk.size()) {
+            const int num_chunk = std::min(int(chunk.size()), num_seeds - begin);
+            // Streamline lengths vary a lot, so distribute dynamically.
+#pragma omp parallel for schedule(dynamic, 16)
+            for (int i = 0; i < num_chunk; ++i) {
+                const int seed = begin + i;
+                traceOne(seed_cells[seed], seed_points + dim*seed, direction, chunk[i]);
+                chunk[i].seed = seed;
+            }
+            for (int i = 0; i < num_chunk; ++i) {
+                consumer(chunk[i]);
+            }
+        }
+    }
+
+
+
+
+    /// Trace a single streamline.
+    void StreamlineTracer::traceOne(const int seed_cell,
+                                    const double* seed_point,
+                                    const Direction direction,
+                                    Streamline& streamline) const
+    {
+        const int dim = grid_.dimensions;
+        const double sign = (direction == Forward) ? 1.0 : -1.0;
+        // Allow for curved paths and slow regions before giving up on
+        // leaving a cell.
+        const int max_steps = 10*steps_per_cell_;
+
+        streamline.seed = -1;
+        streamline.cells.clear();
+        streamline.exit_tof.clear();
+        streamline.termination = Streamline::ReachedMaxCells;
+
+        double x[MaxDim];
+        double xm[MaxDim];
+        double xn[MaxDim];
+        double v[MaxDim];
+        std::copy(seed_point, seed_point + dim, x);
+        int cell = seed_cell;
+        double tof = 0.0;
+        for (int visit = 0; visit < max_cells_; ++visit) {
+            streamline.cells.push_back(cell);
+            const double phi = porevolume_[cell] / grid_.cell_volumes[cell];
+            const double step_length = std::pow(grid_.cell_volumes[cell], 1.0/dim) / steps_per_cell_;
+            int exit_face = -1;
+            for (int step = 0; step < max_steps; ++step) {
+                // Midpoint step of fixed length in the current cell.
+                velocity_.interpolate(cell, x, v);
+                const double speed = norm(v, dim);
+                if (speed == 0.0) {
+                    break;
+                }
+                const double dtau = step_length / speed;
+                for (int dd = 0; dd < dim; ++dd) {
+                    xm[dd] = x[dd] + 0.5*sign*dtau*v[dd];
+                }
+                velocity_.interpolate(cell, xm, v);
+                for (int dd = 0; dd < dim; ++dd) {
+                    xn[dd] = x[dd] + sign*dtau*v[dd];
+                }
+                // Find the first face plane crossed by the step, if any.
+                double alpha = 1.0;
+                for (int hface = grid_.cell_facepos[cell]; hface < grid_.cell_facepos[cell + 1]; ++hface) {
+                    const int face = grid_.cell_faces[hface];
+                    const double d0 = outsideDistance(grid_, cell, face, x);
+                    const double d1 = outsideDistance(grid_, cell, face, xn);
+                    if (d1 > 0.0 && d1 > d0) {
+                        const double face_alpha = d0 < 0.0 ? d0/(d0 - d1) : 0.0;
+                        if (exit_face < 0 || face_alpha < alpha) {
+                            alpha = face_alpha;
+                            exit_face = face;
+                        }
+                    }
+                }
+                for (int dd = 0; dd < dim; ++dd) {
+                    x[dd] += alpha*(xn[dd] - x[dd]);
+                }
+                tof += phi*alpha*dtau;
+                if (exit_face >= 0) {
+                    break;
+                }
+            }
+            streamline.exit_tof.push_back(tof);
+            if (exit_face < 0) {
+                streamline.termination = Streamline::StoppedInCell;
+                return;
+            }
+            const int next = grid_.face_cells[2*exit_face] == cell
+                ? grid_.face_cells[2*exit_face + 1]
+                : grid_.face_cells[2*exit_face];
+            if (next < 0) {
+                streamline.termination = Streamline::ReachedBoundary;
+                return;
+            }
+            cell = next;
+        }
+    }
+
+
+
+
+    /// Place one seed inside each given cell for every face through
+    /// which flow leaves the cell in the tracing direction.
+    void StreamlineTracer::seedsFromCells(const UnstructuredGrid& grid,
+                                          const double* darcyflux,
+                                          const std::vector<int>& cells,
+                                          const Direction direction,
+                                          std::vector<int>& seed_cells,
+                                          std::vector<double>& seed_points)
+    {
+        const int dim = grid.dimensions;
+        const double sign = (direction == Forward) ? 1.0 : -1.0;
+        for (const int cell : cells) {
+            const double* cc = grid.cell_centroids + dim*cell;
+            for (int hface = grid.cell_facepos[cell]; hface < grid.cell_facepos[cell + 1]; ++hface) {
+                const int face = grid.cell_faces[hface];
+                const double outflux = grid.face_cells[2*face] == cell ? darcyflux[face] : -darcyflux[face];
+                if (sign*outflux > 0.0) {
+                    const double* fc = grid.face_centroids + dim*face;
+                    seed_cells.push_back(cell);
+                    for (int dd = 0; dd < dim; ++dd) {
+                        seed_points.push_back(0.5*(cc[dd] + fc[dd]));
+                    }
+                }
+            }
+        }
+    }
+
+
+
+
+    // --------  Methods of class StreamlineCellAverages  --------
+
+
+    /// Construct with zero contributions.
+    StreamlineCellAverages::StreamlineCellAverages(const int num_cells, const int num_tracers)
+        : num_tracers_(num_tracers),
+          weight_(num_cells, 0.0),
+          weighted_tof_(num_cells, 0.0),
+          tracer_weight_(num_cells*num_tracers, 0.0)
+    {
+    }
+
+
+
+    /// Add the contributions of a streamline.
+    void StreamlineCellAverages::add(const Streamline& streamline, const double weight, const int tracer)
+    {
+        assert(tracer < num_tracers_);
+        double entry_tof = 0.0;
+        const int num_visits = streamline.cells.size();
+        for (int i = 0; i < num_visits; ++i) {
+            const int cell = streamline.cells[i];
+            const double exit_tof = streamline.exit_tof[i];
+            const double w = weight*(exit_tof - entry_tof);
+            weight_[cell] += w;
+            weighted_tof_[cell] += w*0.5*(entry_tof + exit_tof);
+            if (tracer >= 0) {
+                tracer_weight_[num_tracers_*cell + tracer] += w;
+            }
+            entry_tof = exit_tof;
+        }
+    }
+
+
+
+    /// Average time-of-flight per cell.
+    void StreamlineCellAverages::tof(std::vector<double>& tof) const
+    {
+        const int num_cells = weight_.size();
+        tof.assign(num_cells, 0.0);
+        for (int cell = 0; cell < num_cells; ++cell) {
+            if (weight_[cell] > 0.0) {
+                tof[cell] = weighted_tof_[cell] / weight_[cell];
+            }
+        }
+    }
+
+
+
+    /// Tracer fractions, num_tracers values per cell.
+    void StreamlineCellAverages::tracer(std::vector<double>& tracer) const
+    {
+        const int num_cells = weight_.size();
+        tracer.assign(num_cells*num_tracers_, 0.0);
+        for (int cell = 0; cell < num_cells; ++cell) {
+            if (weight_[cell] > 0.0) {
+                for (int t = 0; t < num_tracers_; ++t) {
+                    tracer[num_tracers_*cell + t] = tracer_weight_[num_tracers_*cell + t] / weight_[cell];
+                }
+            }
+        }
+    }
+
+
+
+    /// Total weight of contributions per cell.
+    const std::vector<double>& StreamlineCellAverages::cellWeight() const
+    {
+        return weight_;
+    }
+
+
+} // namespace Opm
@@ -0,0 +1,181 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_STREAMLINETRACER_HEADER_INCLUDED
+#define OPM_STREAMLINETRACER_HEADER_INCLUDED
+
+#include <functional>
+#include <vector>
+
+struct UnstructuredGrid;
+
+namespace Opm
+{
+
+    class VelocityInterpolationInterface;
+
+    /// A traced streamline, given as the sequence of cells it passes
+    /// through and the time-of-flight at which it leaves each of them.
+    struct Streamline
+    {
+        /// How the tracing of a streamline ended.
+        enum Termination { ReachedBoundary, StoppedInCell, ReachedMaxCells };
+
+        int seed;                     // Index of the seed the streamline started from.
+        std::vector<int> cells;       // Cells visited, in tracing order.
+        std::vector<double> exit_tof; // Time-of-flight on leaving each visited cell,
+                                      // or at the end point for the last cell.
+        Termination termination;
+    };
+
+
+
+
+    /// Traces streamlines through a velocity field given by a
+    /// velocity interpolation method, and computes the time-of-flight
+    ///     \f[\tau(s) = \int_0^s \frac{\phi}{|v|}\,ds\f]
+    /// along each of them.
+    ///
+    /// Within a cell the streamline is integrated with fixed-length
+    /// midpoint (RK2) steps, and it leaves the cell through the first
+    /// face plane it crosses, so cells must be convex with planar faces.
+    /// A streamline ends on the domain boundary, in a cell it cannot
+    /// leave (such as a well cell or a stagnation region), or after a
+    /// maximum number of cells.
+    ///
+    /// Streamlines are traced in parallel in chunks, and each finished
+    /// chunk is passed to a consumer in seed order before the next one
+    /// is traced, so that memory use is bounded by the chunk size and
+    /// not by the number of streamlines.
+    class StreamlineTracer
+    {
+    public:
+        /// Tracing direction: Forward along the velocity, for the
+        /// time-of-flight from injectors, or Backward against it, for
+        /// the time-of-flight to producers.
+        enum Direction { Forward, Backward };
+
+        /// Called once for each traced streamline, in seed order.
+        typedef std::function<void(const Streamline&)> Consumer;
+
+        /// Construct tracer.
+        /// \param[in] grid                A 2d or 3d grid.
+        /// \param[in] velocity            Velocity interpolation, with fluxes set up.
+        ///                                Must be safe to use from several threads.
+        /// \param[in] porevolume          Array of pore volumes.
+        /// \param[in] steps_per_cell      Number of integration steps used to cross a cell.
+        /// \param[in] max_cells           Maximum number of cells visited by a streamline.
+        StreamlineTracer(const UnstructuredGrid& grid,
+                         const VelocityInterpolationInterface& velocity,
+                         const double* porevolume,
+                         const int steps_per_cell = 10,
+                         const int max_cells = 100000);
+
+        /// Trace streamlines from a number of seed points.
+        /// \param[in] num_seeds           Number of seed points.
+        /// \param[in] seed_cells          Cell containing each seed point.
+        /// \param[in] seed_points         Coordinates of seed points,
+        ///                                grid.dimensions values per seed.
+        /// \param[in] direction           Tracing direction.
+        /// \param[in] consumer            Receives the streamlines, in seed order.
+        /// \param[in] chunk_size          Number of streamlines traced and kept at once.
+        void trace(const int num_seeds,
+                   const int* seed_cells,
+                   const double* seed_points,
+                   const Direction direction,
+                   const Consumer& consumer,
+                   const int chunk_size = 4096) const;
+
+        /// Trace a single streamline.
+        /// \param[in]  seed_cell          Cell containing the seed point.
+        /// \param[in]  seed_point         Coordinates of seed point.
+        /// \param[in]  direction          Tracing direction.
+        /// \param[out] streamline         The traced streamline, with seed set to -1.
+        void traceOne(const int seed_cell,
+                      const double* seed_point,
+                      const Direction direction,
+                      Streamline& streamline) const;
+
+        /// Place one seed inside each given cell for every face through
+        /// which flow leaves the cell in the tracing direction, halfway
+        /// between the cell centroid and the face centroid. Used to seed
+        /// from well cells.
+        /// \param[in]  grid               A 2d or 3d grid.
+        /// \param[in]  darcyflux          Array of signed face fluxes.
+        /// \param[in]  cells              Cells to seed from.
+        /// \param[in]  direction          Tracing direction.
+        /// \param[out] seed_cells         Cell of each seed point (appended to).
+        /// \param[out] seed_points        Coordinates of seed points (appended to).
+        static void seedsFromCells(const UnstructuredGrid& grid,
+                                   const double* darcyflux,
+                                   const std::vector<int>& cells,
+                                   const Direction direction,
+                                   std::vector<int>& seed_cells,
+                                   std::vector<double>& seed_points);
+
+    private:
+        const UnstructuredGrid& grid_;
+        const VelocityInterpolationInterface& velocity_;
+        const double* porevolume_;
+        int steps_per_cell_;
+        int max_cells_;
+    };
+
+
+
+
+    /// Maps streamline results back to cells. Each visit of a
+    /// streamline to a cell contributes its mean time-of-flight in the
+    /// cell, weighted by the streamline weight (such as the flux it
+    /// carries) times its residence time in the cell.
+    class StreamlineCellAverages
+    {
+    public:
+        /// Construct with zero contributions.
+        /// \param[in] num_cells           Number of grid cells.
+        /// \param[in] num_tracers         Number of tracers (streamline labels).
+        StreamlineCellAverages(const int num_cells, const int num_tracers);
+
+        /// Add the contributions of a streamline.
+        /// \param[in] streamline          A traced streamline.
+        /// \param[in] weight              Weight of the streamline.
+        /// \param[in] tracer              Tracer of the streamline,
+        ///                                in [0, num_tracers), or -1 for none.
+        void add(const Streamline& streamline, const double weight, const int tracer);
+
+        /// Average time-of-flight per cell, zero in cells without contributions.
+        void tof(std::vector<double>& tof) const;
+
+        /// Tracer fractions, num_tracers values per cell, zero in
+        /// cells without contributions.
+        void tracer(std::vector<double>& tracer) const;
+
+        /// Total weight of contributions per cell.
+        const std::vector<double>& cellWeight() const;
+
+    private:
+        int num_tracers_;
+        std::vector<double> weight_;
+        std::vector<double> weighted_tof_;
+        std::vector<double> tracer_weight_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_STREAMLINETRACER_HEADER_INCLUDED
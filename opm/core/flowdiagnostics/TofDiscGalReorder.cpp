@@ -48,7 +48,6 @@ namespace Opm
           limiter_method_(MinUpwindAverage),
           limiter_usage_(DuringComputations),
           coord_(grid.dimensions),
-          velocity_(grid.dimensions),
           gauss_seidel_tol_(1e-3)
     {
         const int dg_degree = param.getDefault("dg_degree", 0);
@@ -366,17 +365,25 @@ namespace Opm
             // const int deg_needed = 2*basis_func_->degree() - 1;
             const int deg_needed = 2*basis_func_->degree();
             CellQuadrature quad(grid_, cell, deg_needed);
-            for (int quad_pt = 0; quad_pt < quad.numQuadPts(); ++quad_pt) {
+            // Interpolate the velocity at all quadrature points at once.
+            const int num_quad_pts = quad.numQuadPts();
+            quad_coord_.resize(num_quad_pts*dim);
+            quad_velocity_.resize(num_quad_pts*dim);
+            for (int quad_pt = 0; quad_pt < num_quad_pts; ++quad_pt) {
+                quad.quadPtCoord(quad_pt, &quad_coord_[quad_pt*dim]);
+            }
+            velocity_interpolation_->interpolate(cell, num_quad_pts, dim, &quad_coord_[0], &quad_velocity_[0]);
+            for (int quad_pt = 0; quad_pt < num_quad_pts; ++quad_pt) {
                 // b_i (v \cdot \grad b_j)
-                quad.quadPtCoord(quad_pt, &coord_[0]);
-                basis_func_->eval(cell, &coord_[0], &basis_[0]);
-                basis_func_->evalGrad(cell, &coord_[0], &grad_basis_[0]);
-                velocity_interpolation_->interpolate(cell, &coord_[0], &velocity_[0]);
+                const double* coord = &quad_coord_[quad_pt*dim];
+                const double* velocity = &quad_velocity_[quad_pt*dim];
+                basis_func_->eval(cell, coord, &basis_[0]);
+                basis_func_->evalGrad(cell, coord, &grad_basis_[0]);
                 const double w = quad.quadPtWeight(quad_pt);
                 for (int j = 0; j < num_basis; ++j) {
                     for (int i = 0; i < num_basis; ++i) {
                         for (int dd = 0; dd < dim; ++dd) {
-                            jac_[j*num_basis + i] -= w * basis_[j] * grad_basis_[dim*i + dd] * velocity_[dd];
+                            jac_[j*num_basis + i] -= w * basis_[j] * grad_basis_[dim*i + dd] * velocity[dd];
                         }
                     }
                 }
@@ -160,7 +160,8 @@ namespace Opm
         mutable std::vector<double> basis_;
         mutable std::vector<double> basis_nb_;
         std::vector<double> grad_basis_;
-        std::vector<double> velocity_;
+        std::vector<double> quad_coord_;    // all quadrature points of a cell
+        std::vector<double> quad_velocity_; // velocities at quad_coord_
         int num_singlesolves_;
         // Used by solveMultiCell():
         double gauss_seidel_tol_;
@@ -125,6 +125,19 @@ namespace Opm
         return solver_->solve(size, nonzeros, ia, ja, sa, rhs, solution, add);
     }
 
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverFactory::solveBlock(const int block_size,
+                                    const int size,
+                                    const int nonzeros,
+                                    const int* ia,
+                                    const int* ja,
+                                    const double* sa,
+                                    const double* rhs,
+                                    double* solution) const
+    {
+        return solver_->solveBlock(block_size, size, nonzeros, ia, ja, sa, rhs, solution);
+    }
+
     void LinearSolverFactory::setTolerance(const double tol)
     {
         solver_->setTolerance(tol);
@@ -80,6 +80,17 @@ namespace Opm
                                          double* solution,
                                          const boost::any& add=boost::any()) const;
 
+        /// Solve a linear system, with a matrix given in block compressed
+        /// sparse row format, see LinearSolverInterface::solveBlock().
+        virtual LinearSolverReport solveBlock(const int block_size,
+                                              const int size,
+                                              const int nonzeros,
+                                              const int* ia,
+                                              const int* ja,
+                                              const double* sa,
+                                              const double* rhs,
+                                              double* solution) const;
+
         /// Set tolerance for the linear solver.
         /// \param[in] tol         tolerance value
         /// Not used for LinearSolverFactory
@@ -22,6 +22,10 @@
 #include <opm/core/linalg/LinearSolverInterface.hpp>
 #include <opm/core/linalg/sparse_sys.h>
 #include <opm/core/linalg/call_umfpack.h>
+#include <opm/core/utility/Instrumentation.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <stdexcept>
+#include <vector>
 
 namespace Opm
 {
@@ -38,7 +42,68 @@ namespace Opm
                                  const double* rhs,
                                  double* solution) const
     {
-        return solve(A->m, A->nnz, A->ia, A->ja, A->sa, rhs, solution);
+        OPM_TIMER_SCOPE("linear solve");
+        LinearSolverReport rep = solve(A->m, A->nnz, A->ia, A->ja, A->sa, rhs, solution);
+        OPM_COUNTER_ADD("linear iterations", rep.iterations);
+        return rep;
+    }
+
+
+
+
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverInterface::solve(const BlockCSRMatrix* A,
+                                 const double* rhs,
+                                 double* solution) const
+    {
+        OPM_TIMER_SCOPE("linear solve");
+        LinearSolverReport rep = solveBlock(A->bs, A->m, A->nnz, A->ia, A->ja, A->sa, rhs, solution);
+        OPM_COUNTER_ADD("linear iterations", rep.iterations);
+        return rep;
+    }
+
+
+
+
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverInterface::solveBlock(const int block_size,
+                                      const int size,
+                                      const int nonzeros,
+                                      const int* ia,
+                                      const int* ja,
+                                      const double* sa,
+                                      const double* rhs,
+                                      double* solution) const
+    {
+        if (block_size < 1 || block_size > 4) {
+            OPM_THROW(std::runtime_error, "Block size " << block_size << " is not supported, use 1 to 4.");
+        }
+        if (block_size == 1) {
+            return solve(size, nonzeros, ia, ja, sa, rhs, solution);
+        }
+
+        // Expand to scalar rows, keeping the columns of each row sorted
+        // if the block columns are.
+        const int bs = block_size;
+        const int bs2 = bs*bs;
+        std::vector<int> sia(size*bs + 1);
+        std::vector<int> sja(nonzeros*bs2);
+        std::vector<double> ssa(nonzeros*bs2);
+        int pos = 0;
+        sia[0] = 0;
+        for (int brow = 0; brow < size; ++brow) {
+            for (int r = 0; r < bs; ++r) {
+                for (int k = ia[brow]; k < ia[brow + 1]; ++k) {
+                    for (int c = 0; c < bs; ++c) {
+                        sja[pos] = bs*ja[k] + c;
+                        ssa[pos] = sa[bs2*k + bs*r + c];
+                        ++pos;
+                    }
+                }
+                sia[bs*brow + r + 1] = pos;
+            }
+        }
+        return solve(size*bs, nonzeros*bs2, &sia[0], &sja[0], &ssa[0], rhs, solution);
     }
 
 } // namespace Opm
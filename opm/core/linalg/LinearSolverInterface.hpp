@@ -23,6 +23,7 @@
 #include<boost/any.hpp>
 
 struct CSRMatrix;
+struct BlockCSRMatrix;
 
 namespace Opm
 {
@@ -73,6 +74,39 @@ namespace Opm
                                          double* solution,
                                          const boost::any& add=boost::any()) const = 0;
 
+        /// Solve a linear system, with a matrix given in block compressed sparse row format.
+        /// \param[in] A           matrix in BCSR format
+        /// \param[in] rhs         array of length A->m*A->bs containing the right hand side
+        /// \param[inout] solution array of length A->m*A->bs to which the solution will be written
+        /// Note: this method is a convenience method that calls the virtual solveBlock() method.
+        LinearSolverReport solve(const BlockCSRMatrix* A,
+                                 const double* rhs,
+                                 double* solution) const;
+
+        /// Solve a linear system, with a matrix of dense blocks given in
+        /// block compressed sparse row format. Unknowns and equations are
+        /// numbered block by block, so that entry r of block row i is row
+        /// block_size*i + r of the system.
+        /// The default implementation expands the blocks to a scalar CSR
+        /// matrix and calls solve(); solvers with block support override it.
+        /// \param[in] block_size  size of the dense blocks, 1 to 4
+        /// \param[in] size        # of block rows in matrix
+        /// \param[in] nonzeros    # of nonzero blocks in matrix
+        /// \param[in] ia          array of length (size + 1) containing start and end indices for each block row
+        /// \param[in] ja          array of length nonzeros containing block column numbers
+        /// \param[in] sa          array of length nonzeros*block_size*block_size containing the
+        ///                        elements of each block, in row major order
+        /// \param[in] rhs         array of length size*block_size containing the right hand side
+        /// \param[inout] solution array of length size*block_size to which the solution will be written
+        virtual LinearSolverReport solveBlock(const int block_size,
+                                              const int size,
+                                              const int nonzeros,
+                                              const int* ia,
+                                              const int* ja,
+                                              const double* sa,
+                                              const double* rhs,
+                                              double* solution) const;
+
         /// Set tolerance for the linear solver.
         /// \param[in] tol         tolerance value
         virtual void setTolerance(const double tol) = 0;
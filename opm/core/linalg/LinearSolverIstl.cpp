@@ -25,6 +25,8 @@
 #include <opm/core/linalg/LinearSolverIstl.hpp>
 #include <opm/core/linalg/ParallelIstlInformation.hpp>
 #include <opm/common/ErrorMacros.hpp>
+#include <opm/core/utility/BufferedLog.hpp>
+#include <opm/core/utility/Instrumentation.hpp>
 
 // Silence compatibility warning from DUNE headers since we don't use
 // the deprecated member anyway (in this compilation unit)
@@ -51,8 +53,10 @@
 
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
+#include <memory>
 #include <type_traits>
 
 namespace Opm
@@ -88,6 +92,20 @@ namespace Opm
         template<class O, class S, class C>
         LinearSolverInterface::LinearSolverReport
         solveBiCGStab_ILU0(O& A, Vector& x, Vector& b, S& sp, const C& comm, double tolerance, int maxit, int verbosity);
+
+        enum SinglePrecisionAMGType { SingleCG_AMG, SingleKAMG, SingleFastAMG };
+
+        LinearSolverInterface::LinearSolverReport
+        solveSinglePrecisionAMG(Operator& A, Vector& x, Vector& b, Dune::SeqScalarProduct<Vector>& sp,
+                                const Dune::Amg::SequentialInformation& comm, SinglePrecisionAMGType type,
+                                double tolerance, int maxit, int verbosity,
+                                double prolongateFactor, int smoothsteps);
+
+        template<class O, class S, class C>
+        LinearSolverInterface::LinearSolverReport
+        solveSinglePrecisionAMG(O& A, Vector& x, Vector& b, S& sp, const C& comm, SinglePrecisionAMGType type,
+                                double tolerance, int maxit, int verbosity,
+                                double prolongateFactor, int smoothsteps);
     } // anonymous namespace
 
 
@@ -100,7 +118,9 @@ namespace Opm
           linsolver_save_system_(false),
           linsolver_max_iterations_(0),
           linsolver_smooth_steps_(2),
-          linsolver_prolongate_factor_(1.6)
+          linsolver_prolongate_factor_(1.6),
+          linsolver_amg_single_precision_(false),
+          linsolver_amg_single_precision_max_iterations_(100)
     {
     }
 
@@ -114,7 +134,9 @@ namespace Opm
           linsolver_save_system_(false),
           linsolver_max_iterations_(0),
           linsolver_smooth_steps_(2),
-          linsolver_prolongate_factor_(1.6)
+          linsolver_prolongate_factor_(1.6),
+          linsolver_amg_single_precision_(false),
+          linsolver_amg_single_precision_max_iterations_(100)
     {
         linsolver_residual_tolerance_ = param.getDefault("linsolver_residual_tolerance", linsolver_residual_tolerance_);
         linsolver_verbosity_ = param.getDefault("linsolver_verbosity", linsolver_verbosity_);
@@ -126,6 +148,9 @@ namespace Opm
         linsolver_max_iterations_ = param.getDefault("linsolver_max_iterations", linsolver_max_iterations_);
         linsolver_smooth_steps_ = param.getDefault("linsolver_smooth_steps", linsolver_smooth_steps_);
         linsolver_prolongate_factor_ = param.getDefault("linsolver_prolongate_factor", linsolver_prolongate_factor_);
+        linsolver_amg_single_precision_ = param.getDefault("linsolver_amg_single_precision", linsolver_amg_single_precision_);
+        linsolver_amg_single_precision_max_iterations_ = param.getDefault("linsolver_amg_single_precision_max_iterations",
+                                                                          linsolver_amg_single_precision_max_iterations_);
     }
 
     LinearSolverIstl::~LinearSolverIstl()
@@ -210,6 +235,35 @@ namespace Opm
         }
 
         LinearSolverReport res;
+        res.converged = false;
+        res.iterations = 0;
+        const bool sequential = std::is_same<C, Dune::Amg::SequentialInformation>::value;
+        if (linsolver_amg_single_precision_ && sequential
+            && (linsolver_type_ == CG_AMG || linsolver_type_ == KAMG || linsolver_type_ == FastAMG)) {
+            const SinglePrecisionAMGType type = linsolver_type_ == CG_AMG ? SingleCG_AMG
+                : (linsolver_type_ == KAMG ? SingleKAMG : SingleFastAMG);
+            // Cap the single precision attempt, so that a stagnating
+            // solve does not cost a full maxit before the fallback.
+            const int single_maxit = std::min(maxit, linsolver_amg_single_precision_max_iterations_);
+            // The Krylov solver overwrites its right hand side with the
+            // defect, so give it a copy to keep b intact for the fallback.
+            Vector b_single(b);
+            res = solveSinglePrecisionAMG(opA, x, b_single, sp, comm, type, linsolver_residual_tolerance_, single_maxit,
+                                          linsolver_verbosity_, linsolver_prolongate_factor_,
+                                          linsolver_smooth_steps_);
+            if (res.converged) {
+                std::copy(x.begin(), x.end(), solution);
+                return res;
+            }
+            // Fall back to the double precision hierarchy, starting over
+            // in case the iterate has been spoilt.
+            OPM_BUFFERED_LOG(BufferedLog::Summary,
+                             "Single precision AMG did not converge in " << res.iterations
+                             << " iterations, retrying in double precision.");
+            BufferedLog::flush();
+            x = 0.0;
+        }
+        const int single_iterations = res.iterations;
         switch (linsolver_type_) {
         case CG_ILU0:
             res = solveCG_ILU0(opA, x, b, sp, comm, linsolver_residual_tolerance_, maxit, linsolver_verbosity_);
@@ -240,6 +294,7 @@ namespace Opm
             std::cerr << "Unknown linsolver_type: " << int(linsolver_type_) << '\n';
             throw std::runtime_error("Unknown linsolver_type");
         }
+        res.iterations += single_iterations;
         std::copy(x.begin(), x.end(), solution);
         return res;
     }
@@ -375,10 +430,14 @@ namespace Opm
         typename Precond::SmootherArgs smootherArgs;
         setUpCriterion(criterion, linsolver_prolongate_factor, verbosity,
                        linsolver_smooth_steps);
-        Precond precond(opA, criterion, smootherArgs, comm);
+        std::unique_ptr<Precond> precond;
+        {
+            OPM_TIMER_SCOPE("amg setup");
+            precond.reset(new Precond(opA, criterion, smootherArgs, comm));
+        }
 
         // Construct linear solver.
-        Dune::CGSolver<Vector> linsolve(opA, sp, precond, tolerance, maxit, verbosity);
+        Dune::CGSolver<Vector> linsolve(opA, sp, *precond, tolerance, maxit, verbosity);
 
         // Solve system.
         Dune::InverseOperatorResult result;
@@ -426,10 +485,14 @@ namespace Opm
         Criterion criterion;
         setUpCriterion(criterion, linsolver_prolongate_factor, verbosity,
                        linsolver_smooth_steps);
-        Precond precond(sOpA, criterion, smootherArgs);
+        std::unique_ptr<Precond> precond;
+        {
+            OPM_TIMER_SCOPE("amg setup");
+            precond.reset(new Precond(sOpA, criterion, smootherArgs));
+        }
 
         // Construct linear solver.
-        Dune::GeneralizedPCGSolver<Vector> linsolve(sOpA, precond, tolerance, maxit, verbosity);
+        Dune::GeneralizedPCGSolver<Vector> linsolve(sOpA, *precond, tolerance, maxit, verbosity);
 
         // Solve system.
         Dune::InverseOperatorResult result;
@@ -476,10 +539,14 @@ namespace Opm
         parms.setNoPreSmoothSteps(smooth_steps);
         parms.setNoPostSmoothSteps(smooth_steps);
         parms.setProlongationDampingFactor(linsolver_prolongate_factor);
-        Precond precond(sOpA, criterion, parms);
+        std::unique_ptr<Precond> precond;
+        {
+            OPM_TIMER_SCOPE("amg setup");
+            precond.reset(new Precond(sOpA, criterion, parms));
+        }
 
         // Construct linear solver.
-        Dune::GeneralizedPCGSolver<Vector> linsolve(sOpA, precond, tolerance, maxit, verbosity);
+        Dune::GeneralizedPCGSolver<Vector> linsolve(sOpA, *precond, tolerance, maxit, verbosity);
 
         // Solve system.
         Dune::InverseOperatorResult result;
@@ -519,8 +586,333 @@ namespace Opm
 
 
 
+    typedef Dune::FieldVector<float, 1   > VectorBlockTypeSingle;
+    typedef Dune::FieldMatrix<float, 1, 1> MatrixBlockTypeSingle;
+    typedef Dune::BCRSMatrix <MatrixBlockTypeSingle>                 MatSingle;
+    typedef Dune::BlockVector<VectorBlockTypeSingle>                 VectorSingle;
+    typedef Dune::MatrixAdapter<MatSingle,VectorSingle,VectorSingle> OperatorSingle;
+
+    // Copy of a matrix in single precision, with the same sparsity pattern.
+    std::unique_ptr<MatSingle> singlePrecisionCopy(const Mat& A)
+    {
+        std::unique_ptr<MatSingle> As(new MatSingle(A.N(), A.M(), A.nonzeroes(), MatSingle::row_wise));
+        for (MatSingle::CreateIterator row = As->createbegin(); row != As->createend(); ++row) {
+            const Mat::row_type& arow = A[row.index()];
+            for (Mat::ConstColIterator col = arow.begin(); col != arow.end(); ++col) {
+                row.insert(col.index());
+            }
+        }
+        for (Mat::ConstRowIterator row = A.begin(); row != A.end(); ++row) {
+            for (Mat::ConstColIterator col = row->begin(); col != row->end(); ++col) {
+                (*As)[row.index()][col.index()] = float((*col)[0][0]);
+            }
+        }
+        return As;
+    }
+
+    // Applies a preconditioner built on the single precision copy of a
+    // matrix to double precision vectors. The Krylov iteration and its
+    // residuals stay in double precision.
+    class SinglePrecisionPreconditioner : public Dune::Preconditioner<Vector, Vector>
+    {
+    public:
+        enum { category = Dune::SolverCategory::sequential };
+
+        SinglePrecisionPreconditioner(Dune::Preconditioner<VectorSingle, VectorSingle>& prec,
+                                      const std::size_t size)
+            : prec_(prec), v_(size), d_(size)
+        {
+        }
+
+        virtual void pre(Vector& x, Vector& b)
+        {
+            convert(x, v_);
+            convert(b, d_);
+            prec_.pre(v_, d_);
+        }
+
+        virtual void apply(Vector& v, const Vector& d)
+        {
+            convert(d, d_);
+            v_ = 0.0;
+            prec_.apply(v_, d_);
+            convert(v_, v);
+        }
+
+        virtual void post(Vector& x)
+        {
+            convert(x, v_);
+            prec_.post(v_);
+        }
+
+    private:
+        template<class From, class To>
+        static void convert(const From& from, To& to)
+        {
+            for (std::size_t i = 0; i < from.size(); ++i) {
+                to[i][0] = from[i][0];
+            }
+        }
+
+        Dune::Preconditioner<VectorSingle, VectorSingle>& prec_;
+        VectorSingle v_;
+        VectorSingle d_;
+    };
+
+    LinearSolverInterface::LinearSolverReport
+    solveSinglePrecisionAMG(Operator& opA, Vector& x, Vector& b, Dune::SeqScalarProduct<Vector>& /* sp */,
+                            const Dune::Amg::SequentialInformation& comm, SinglePrecisionAMGType type,
+                            double tolerance, int maxit, int verbosity,
+                            double linsolver_prolongate_factor, int linsolver_smooth_steps)
+    {
+        // Solve with an AMG hierarchy built in single precision.
+#if FIRST_DIAGONAL
+        typedef Dune::Amg::FirstDiagonal CouplingMetric;
+#else
+        typedef Dune::Amg::RowSum        CouplingMetric;
+#endif
+
+#if SYMMETRIC
+        typedef Dune::Amg::SymmetricCriterion<MatSingle,CouplingMetric>   CriterionBase;
+#else
+        typedef Dune::Amg::UnSymmetricCriterion<MatSingle,CouplingMetric> CriterionBase;
+#endif
+        typedef Dune::Amg::AggregationCriterion<Dune::Amg::SymmetricMatrixDependency<MatSingle,CouplingMetric> >
+            FastCriterionBase;
+
+#if SMOOTHER_ILU
+        typedef Dune::SeqILU0<MatSingle,VectorSingle,VectorSingle>        Smoother;
+#else
+        typedef Dune::SeqSOR<MatSingle,VectorSingle,VectorSingle>        Smoother;
+#endif
+        typedef Dune::Amg::CoarsenCriterion<CriterionBase> Criterion;
+        typedef Dune::Amg::CoarsenCriterion<FastCriterionBase> FastCriterion;
+        typedef Dune::Amg::AMG<OperatorSingle,VectorSingle,Smoother,Dune::Amg::SequentialInformation> AMGPrecond;
+        typedef Dune::Amg::KAMG<OperatorSingle,VectorSingle,Smoother,Dune::Amg::SequentialInformation> KAMGPrecond;
+        typedef Dune::Amg::FastAMG<OperatorSingle,VectorSingle> FastAMGPrecond;
+
+        // Construct preconditioner. The hierarchy keeps references to
+        // the matrix and operator, which must outlive it.
+        std::unique_ptr<MatSingle> As;
+        std::unique_ptr<OperatorSingle> opAs;
+        std::unique_ptr<Dune::Preconditioner<VectorSingle, VectorSingle> > precond;
+        {
+            OPM_TIMER_SCOPE("amg setup");
+            As = singlePrecisionCopy(opA.getmat());
+            opAs.reset(new OperatorSingle(*As));
+            switch (type) {
+            case SingleCG_AMG: {
+                Criterion criterion;
+                AMGPrecond::SmootherArgs smootherArgs;
+                setUpCriterion(criterion, linsolver_prolongate_factor, verbosity, linsolver_smooth_steps);
+                precond.reset(new AMGPrecond(*opAs, criterion, smootherArgs, comm));
+                break;
+            }
+            case SingleKAMG: {
+                Criterion criterion;
+                KAMGPrecond::SmootherArgs smootherArgs;
+                setUpCriterion(criterion, linsolver_prolongate_factor, verbosity, linsolver_smooth_steps);
+                precond.reset(new KAMGPrecond(*opAs, criterion, smootherArgs));
+                break;
+            }
+            case SingleFastAMG: {
+                FastCriterion criterion;
+                const int smooth_steps = 1;
+                setUpCriterion(criterion, linsolver_prolongate_factor, verbosity, smooth_steps);
+                Dune::Amg::Parameters parms;
+                parms.setDebugLevel(verbosity);
+                parms.setNoPreSmoothSteps(smooth_steps);
+                parms.setNoPostSmoothSteps(smooth_steps);
+                parms.setProlongationDampingFactor(linsolver_prolongate_factor);
+                precond.reset(new FastAMGPrecond(*opAs, criterion, parms));
+                break;
+            }
+            }
+        }
+        SinglePrecisionPreconditioner mixed(*precond, b.size());
+
+        // Construct linear solver. Rounding makes the preconditioner
+        // slightly nonlinear, so use the flexible variant of CG.
+        Dune::GeneralizedPCGSolver<Vector> linsolve(opA, mixed, tolerance, maxit, verbosity);
+
+        // Solve system.
+        Dune::InverseOperatorResult result;
+        linsolve.apply(x, b, result);
+
+        // Output results.
+        LinearSolverInterface::LinearSolverReport res;
+        res.converged = result.converged;
+        res.iterations = result.iterations;
+        res.residual_reduction = result.reduction;
+        return res;
+    }
+
+    // Only called for sequential runs, parallel runs use the double
+    // precision hierarchy.
+    template<class O, class S, class C>
+    LinearSolverInterface::LinearSolverReport
+    solveSinglePrecisionAMG(O& /* opA */, Vector& /* x */, Vector& /* b */, S& /* sp */, const C& /* comm */,
+                            SinglePrecisionAMGType /* type */, double /* tolerance */, int /* maxit */,
+                            int /* verbosity */, double /* linsolver_prolongate_factor */,
+                            int /* linsolver_smooth_steps */)
+    {
+        OPM_THROW(std::logic_error, "Single precision AMG is only available for sequential runs.");
+    }
+
+
+
 
     } // anonymous namespace
 
 
+
+
+    template<int B>
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverIstl::solveBlockSystem(const int size,
+                                       const int nonzeros,
+                                       const int* ia,
+                                       const int* ja,
+                                       const double* sa,
+                                       const double* rhs,
+                                       double* solution) const
+    {
+        typedef Dune::FieldVector<double, B   >             BlockVectorType;
+        typedef Dune::FieldMatrix<double, B, B>             BlockMatrixType;
+        typedef Dune::BCRSMatrix <BlockMatrixType>          BlockMat;
+        typedef Dune::BlockVector<BlockVectorType>          BlockVector;
+        typedef Dune::MatrixAdapter<BlockMat,BlockVector,BlockVector> BlockOperator;
+
+        // Build Istl structures from input.
+        BlockMat A(size, size, nonzeros, BlockMat::row_wise);
+        for (typename BlockMat::CreateIterator row = A.createbegin(); row != A.createend(); ++row) {
+            const int ri = row.index();
+            for (int i = ia[ri]; i < ia[ri + 1]; ++i) {
+                row.insert(ja[i]);
+            }
+        }
+        for (int ri = 0; ri < size; ++ri) {
+            for (int i = ia[ri]; i < ia[ri + 1]; ++i) {
+                BlockMatrixType& block = A[ri][ja[i]];
+                for (int r = 0; r < B; ++r) {
+                    for (int c = 0; c < B; ++c) {
+                        block[r][c] = sa[B*B*i + B*r + c];
+                    }
+                }
+            }
+        }
+        BlockVector b(size);
+        for (int ri = 0; ri < size; ++ri) {
+            for (int r = 0; r < B; ++r) {
+                b[ri][r] = rhs[B*ri + r];
+            }
+        }
+        BlockVector x(size);
+        x = 0.0;
+
+        int maxit = linsolver_max_iterations_;
+        if (maxit == 0) {
+            maxit = 5000;
+        }
+        const double tolerance = linsolver_residual_tolerance_;
+        const int verbosity = linsolver_verbosity_;
+
+        BlockOperator opA(A);
+        Dune::SeqScalarProduct<BlockVector> sp;
+        Dune::InverseOperatorResult result;
+        switch (linsolver_type_) {
+        case CG_ILU0: {
+            Dune::SeqILU0<BlockMat,BlockVector,BlockVector> precond(A, 1.0);
+            Dune::CGSolver<BlockVector> linsolve(opA, sp, precond, tolerance, maxit, verbosity);
+            linsolve.apply(x, b, result);
+            break;
+        }
+        case BiCGStab_ILU0: {
+            Dune::SeqILU0<BlockMat,BlockVector,BlockVector> precond(A, 1.0);
+            Dune::BiCGSTABSolver<BlockVector> linsolve(opA, sp, precond, tolerance, maxit, verbosity);
+            linsolve.apply(x, b, result);
+            break;
+        }
+        case CG_AMG: {
+#if FIRST_DIAGONAL
+            typedef Dune::Amg::FirstDiagonal CouplingMetric;
+#else
+            typedef Dune::Amg::RowSum        CouplingMetric;
+#endif
+
+#if SYMMETRIC
+            typedef Dune::Amg::SymmetricCriterion<BlockMat,CouplingMetric>   CriterionBase;
+#else
+            typedef Dune::Amg::UnSymmetricCriterion<BlockMat,CouplingMetric> CriterionBase;
+#endif
+
+#if SMOOTHER_ILU
+            typedef Dune::SeqILU0<BlockMat,BlockVector,BlockVector>        Smoother;
+#else
+            typedef Dune::SeqSOR<BlockMat,BlockVector,BlockVector>        Smoother;
+#endif
+            typedef Dune::Amg::CoarsenCriterion<CriterionBase> Criterion;
+            typedef Dune::Amg::AMG<BlockOperator,BlockVector,Smoother>   Precond;
+
+            Criterion criterion;
+            typename Precond::SmootherArgs smootherArgs;
+            setUpCriterion(criterion, linsolver_prolongate_factor_, verbosity,
+                           linsolver_smooth_steps_);
+            std::unique_ptr<Precond> precond;
+            {
+                OPM_TIMER_SCOPE("amg setup");
+                precond.reset(new Precond(opA, criterion, smootherArgs));
+            }
+            Dune::CGSolver<BlockVector> linsolve(opA, sp, *precond, tolerance, maxit, verbosity);
+            linsolve.apply(x, b, result);
+            break;
+        }
+        default:
+            OPM_THROW(std::runtime_error, "linsolver_type " << int(linsolver_type_)
+                      << " has no block matrix version.");
+        }
+
+        for (int ri = 0; ri < size; ++ri) {
+            for (int r = 0; r < B; ++r) {
+                solution[B*ri + r] = x[ri][r];
+            }
+        }
+
+        // Output results.
+        LinearSolverReport res;
+        res.converged = result.converged;
+        res.iterations = result.iterations;
+        res.residual_reduction = result.reduction;
+        return res;
+    }
+
+
+
+
+    LinearSolverInterface::LinearSolverReport
+    LinearSolverIstl::solveBlock(const int block_size,
+                                 const int size,
+                                 const int nonzeros,
+                                 const int* ia,
+                                 const int* ja,
+                                 const double* sa,
+                                 const double* rhs,
+                                 double* solution) const
+    {
+        if (block_size == 1 || linsolver_type_ == KAMG || linsolver_type_ == FastAMG) {
+            return LinearSolverInterface::solveBlock(block_size, size, nonzeros, ia, ja, sa, rhs, solution);
+        }
+        switch (block_size) {
+        case 2:
+            return solveBlockSystem<2>(size, nonzeros, ia, ja, sa, rhs, solution);
+        case 3:
+            return solveBlockSystem<3>(size, nonzeros, ia, ja, sa, rhs, solution);
+        case 4:
+            return solveBlockSystem<4>(size, nonzeros, ia, ja, sa, rhs, solution);
+        default:
+            OPM_THROW(std::runtime_error, "Block size " << block_size << " is not supported, use 1 to 4.");
+        }
+    }
+
+
 } // namespace Opm
@@ -47,6 +47,15 @@ namespace Opm
         ///   linsolver_smooth_steps        2
         ///   linsolver_prolongate_factor   1.6
         ///   linsolver_verbosity           0
+        ///   linsolver_amg_single_precision  false (build the AMG hierarchy of
+        ///                                 CG_AMG, KAMG and FastAMG in single
+        ///                                 precision, sequential runs only;
+        ///                                 falls back to double precision if
+        ///                                 the solve does not converge)
+        ///   linsolver_amg_single_precision_max_iterations  100 (iteration
+        ///                                 cap of the single precision solve
+        ///                                 before falling back, at most
+        ///                                 linsolver_max_iterations)
         LinearSolverIstl();
 
         /// Construct from parameters
@@ -77,6 +86,20 @@ namespace Opm
                                          double* solution,
                                          const boost::any& comm=boost::any()) const;
 
+        /// Solve a linear system, with a matrix given in block compressed
+        /// sparse row format, see LinearSolverInterface::solveBlock().
+        /// Block sizes 2 to 4 use dune-istl block matrices with
+        /// CG_ILU0, BiCGStab_ILU0 and CG_AMG. KAMG and FastAMG solve the
+        /// expanded scalar system. Sequential runs only.
+        virtual LinearSolverReport solveBlock(const int block_size,
+                                              const int size,
+                                              const int nonzeros,
+                                              const int* ia,
+                                              const int* ja,
+                                              const double* sa,
+                                              const double* rhs,
+                                              double* solution) const;
+
         /// Set tolerance for the residual in dune istl linear solver.
         /// \param[in] tol         tolerance value
         virtual void setTolerance(const double tol);
@@ -97,6 +120,13 @@ namespace Opm
         LinearSolverReport solveSystem(O& opA, double* solution, const double *rhs,
                                        S& sp, const C& comm, int maxit) const;
 
+        /// \brief Solve a block system with blocks of size B using ISTL
+        /// block matrices. Arguments as for solveBlock().
+        template<int B>
+        LinearSolverReport solveBlockSystem(const int size, const int nonzeros,
+                                            const int* ia, const int* ja, const double* sa,
+                                            const double* rhs, double* solution) const;
+
         double linsolver_residual_tolerance_;
         int linsolver_verbosity_;
         enum LinsolverType { CG_ILU0 = 0, CG_AMG = 1, BiCGStab_ILU0 = 2, FastAMG=3, KAMG=4 };
@@ -108,6 +138,10 @@ namespace Opm
         int linsolver_smooth_steps_;
         /** \brief The factor to scale the coarse grid correction with. */
         double linsolver_prolongate_factor_;
+        /** \brief Whether to build the AMG hierarchy in single precision. */
+        bool linsolver_amg_single_precision_;
+        /** \brief Iteration cap of the single precision AMG solve. */
+        int linsolver_amg_single_precision_max_iterations_;
 
     };
 
@@ -19,9 +19,10 @@
 */
 
 #include "config.h"
-#include <cstring>
 #include <opm/core/linalg/LinearSolverPetsc.hpp>
+#include <algorithm>
 #include <unordered_map>
+#include <vector>
 #define PETSC_CLANGUAGE_CXX 1 //enable CHKERRXX macro.
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 #include <petsc.h>
@@ -126,107 +127,65 @@ namespace{
         Map type_map_;
     };
 
-    struct OEM_DATA {
-        /* Convenience struct to handle automatic (de)allocation of some useful
-         * variables, as well as group them up for easier parameter passing
-         */
-        Vec x;
-        Vec b;
-        Mat A;
-        KSP ksp;
-        PC preconditioner;
-
-        OEM_DATA( const int size ) {
-            VecCreate( PETSC_COMM_WORLD, &b );
-            auto err = VecSetSizes( b, PETSC_DECIDE, size );
-            CHKERRXX( err );
-            VecSetFromOptions( b );
-
-            KSPCreate( PETSC_COMM_WORLD, &ksp );
-        }
+} // anonymous namespace.
 
-        ~OEM_DATA() {
+    /// PETSc objects kept from one solve to the next. The matrix is
+    /// created on copies of the CSR arrays, since PETSc keeps using
+    /// the arrays it is given, and is rebuilt only when the sparsity
+    /// pattern changes.
+    struct LinearSolverPetsc::PetscData
+    {
+        KSP ksp = nullptr;
+        Mat A = nullptr;
+        Vec x = nullptr;
+        Vec b = nullptr;
+        std::vector<PetscInt> ia;
+        std::vector<PetscInt> ja;
+        std::vector<PetscScalar> sa;
+        bool options_set = false;
+
+        ~PetscData()
+        {
             VecDestroy( &x );
             VecDestroy( &b );
             MatDestroy( &A );
             KSPDestroy( &ksp );
         }
-    };
-
-    Vec to_petsc_vec( const double* x, int size ) {
-        PetscScalar* vec;
-        Vec v;
-
-        VecCreate( PETSC_COMM_WORLD, &v );
-        VecSetSizes( v, PETSC_DECIDE, size );
-        VecSetFromOptions( v );
-
-        VecGetArray( v, &vec );
-        std::memcpy( vec, x,  size * sizeof( double ) );
-
-        VecRestoreArray( v, &vec );
-        return v;
-    }
-
-    void from_petsc_vec( double* x, Vec v ) {
-        if( !v ) OPM_THROW( std::runtime_error,
-                    "PETSc CopySolution: Invalid PETSc vector." );
-
-        PetscScalar* vec;
-        PetscInt size;
-
-        VecGetLocalSize( v, &size );
-        VecGetArray( v, &vec );
-
-        std::memcpy( x, vec, size * sizeof( double ) );
-        VecRestoreArray( v, &vec );
-    }
-
-    Mat to_petsc_mat( const int size, const int /* nonzeros */,
-            const int* ia, const int* ja, const double* sa ) {
 
-        Mat A;
-        auto err = MatCreateSeqAIJWithArrays( PETSC_COMM_WORLD, size, size, const_cast<int*>(ia), const_cast<int*>(ja), (double*)sa, &A );
-        CHKERRXX( err );
-        return A;
-    }
-
-
-    void solve_system( OEM_DATA& t, KSPType method, PCType pcname,
-            double rtol, double atol, double dtol, int maxits, int ksp_view ) {
-        PetscInt its;
-        PetscReal residual;
-        KSPConvergedReason reason;
-
-#if PETSC_VERSION_MAJOR <= 3 && PETSC_VERSION_MINOR < 5
-        KSPSetOperators( t.ksp, t.A, t.A, DIFFERENT_NONZERO_PATTERN );
-#else
-        KSPSetOperators( t.ksp, t.A, t.A );
-        KSPSetReusePreconditioner(t.ksp, PETSC_FALSE);
-#endif
-        KSPGetPC( t.ksp, &t.preconditioner );
-        auto err = KSPSetType( t.ksp, method );
-        CHKERRXX( err );
-        err = PCSetType( t.preconditioner, pcname );
-        CHKERRXX( err );
-        err = KSPSetTolerances( t.ksp, rtol, atol, dtol, maxits );
-        CHKERRXX( err );
-        err = KSPSetFromOptions( t.ksp );
-        CHKERRXX( err );
-        KSPSetInitialGuessNonzero( t.ksp, PETSC_FALSE );
-        KSPSolve( t.ksp, t.x, t.b );
-        KSPGetConvergedReason( t.ksp, &reason );
-        KSPGetIterationNumber( t.ksp, &its );
-        KSPGetResidualNorm( t.ksp, &residual );
+        bool samePattern( const int size, const int nonzeros,
+                          const int* ia_in, const int* ja_in ) const
+        {
+            return A
+                && int( ia.size() ) == size + 1
+                && int( ja.size() ) == nonzeros
+                && std::equal( ia.begin(), ia.end(), ia_in )
+                && std::equal( ja.begin(), ja.end(), ja_in );
+        }
 
-        if( ksp_view )
-            KSPView( t.ksp, PETSC_VIEWER_STDOUT_WORLD );
+        void createMatrix( const int size, const int nonzeros,
+                           const int* ia_in, const int* ja_in )
+        {
+            MatDestroy( &A );
+            ia.assign( ia_in, ia_in + size + 1 );
+            ja.assign( ja_in, ja_in + nonzeros );
+            sa.assign( nonzeros, 0.0 );
+            auto err = MatCreateSeqAIJWithArrays( PETSC_COMM_WORLD, size, size,
+                                                  ia.data(), ja.data(), sa.data(), &A );
+            CHKERRXX( err );
+        }
 
-        err = PetscPrintf( PETSC_COMM_WORLD, "KSP Iterations %D, Final Residual %g\n", its, (double)residual );
-        CHKERRXX( err );
-    }
+        void createVectors( const int size )
+        {
+            VecDestroy( &x );
+            VecDestroy( &b );
+            VecCreate( PETSC_COMM_WORLD, &b );
+            auto err = VecSetSizes( b, PETSC_DECIDE, size );
+            CHKERRXX( err );
+            VecSetFromOptions( b );
+            VecDuplicate( b, &x );
+        }
+    };
 
-} // anonymous namespace.
 
     LinearSolverPetsc::LinearSolverPetsc(const ParameterGroup& param)
         : ksp_type_( param.getDefault( std::string( "ksp_type" ), std::string( "gmres" ) ) )
@@ -236,6 +195,11 @@ namespace{
         , atol_( param.getDefault( std::string( "ksp_atol" ), 1e-50 ) )
         , dtol_( param.getDefault( std::string( "ksp_dtol" ), 1e5 ) )
         , maxits_( param.getDefault( std::string( "ksp_max_it" ), 1e5 ) )
+        , reuse_pc_( param.getDefault( std::string( "ksp_reuse_pc" ), false ) )
+        , initial_guess_nonzero_( param.getDefault( std::string( "ksp_initial_guess_nonzero" ), false ) )
+        , options_once_( param.getDefault( std::string( "ksp_set_from_options_once" ), true ) )
+        , ksp_create_count_( 0 )
+        , pc_setup_count_( 0 )
     {
         int argc = 0;
         char** argv = NULL;
@@ -245,7 +209,9 @@ namespace{
 
     LinearSolverPetsc::~LinearSolverPetsc()
     {
-       PetscFinalize();
+        // The PETSc objects must go before PETSc itself.
+        data_.reset();
+        PetscFinalize();
     }
 
 
@@ -259,20 +225,84 @@ namespace{
                                double* solution,
                                const boost::any&) const
     {
-        KSPTypeMap ksp(ksp_type_);
-        KSPType ksp_type = ksp.find(ksp_type_);
-        PCTypeMap pc(pc_type_);
-        PCType pc_type = pc.find(pc_type_);
+        if (!data_ || int( data_->ia.size() ) != size + 1) {
+            // New or resized system: start from scratch.
+            data_.reset( new PetscData );
+            KSPTypeMap ksp(ksp_type_);
+            PCTypeMap pc(pc_type_);
+            KSPCreate( PETSC_COMM_WORLD, &data_->ksp );
+            auto err = KSPSetType( data_->ksp, ksp.find(ksp_type_) );
+            CHKERRXX( err );
+            PC preconditioner;
+            KSPGetPC( data_->ksp, &preconditioner );
+            err = PCSetType( preconditioner, pc.find(pc_type_) );
+            CHKERRXX( err );
+            err = KSPSetTolerances( data_->ksp, rtol_, atol_, dtol_, maxits_ );
+            CHKERRXX( err );
+            data_->createVectors( size );
+            ++ksp_create_count_;
+        }
+        PetscData& t = *data_;
+
+        // The preconditioner can only be reused for the same pattern.
+        bool reuse_pc = reuse_pc_;
+        if (!t.samePattern( size, nonzeros, ia, ja )) {
+            t.createMatrix( size, nonzeros, ia, ja );
+            reuse_pc = false;
+        }
+        if (!reuse_pc) {
+            ++pc_setup_count_;
+        }
+        PetscScalar* values;
+        MatSeqAIJGetArray( t.A, &values );
+        std::copy( sa, sa + nonzeros, values );
+        MatSeqAIJRestoreArray( t.A, &values );
+
+#if PETSC_VERSION_MAJOR <= 3 && PETSC_VERSION_MINOR < 5
+        KSPSetOperators( t.ksp, t.A, t.A, reuse_pc ? SAME_PRECONDITIONER : SAME_NONZERO_PATTERN );
+#else
+        KSPSetOperators( t.ksp, t.A, t.A );
+        KSPSetReusePreconditioner( t.ksp, reuse_pc ? PETSC_TRUE : PETSC_FALSE );
+#endif
+        if (!options_once_ || !t.options_set) {
+            auto err = KSPSetFromOptions( t.ksp );
+            CHKERRXX( err );
+            t.options_set = true;
+        }
+
+        PetscScalar* vec;
+        VecGetArray( t.b, &vec );
+        std::copy( rhs, rhs + size, vec );
+        VecRestoreArray( t.b, &vec );
+        if (initial_guess_nonzero_) {
+            VecGetArray( t.x, &vec );
+            std::copy( solution, solution + size, vec );
+            VecRestoreArray( t.x, &vec );
+        }
+        KSPSetInitialGuessNonzero( t.ksp, initial_guess_nonzero_ ? PETSC_TRUE : PETSC_FALSE );
 
-        OEM_DATA t( size );
-        t.A = to_petsc_mat( size, nonzeros, ia, ja, sa );
-        t.x = to_petsc_vec( rhs, size );
+        KSPSolve( t.ksp, t.b, t.x );
+
+        PetscInt its;
+        PetscReal residual;
+        KSPConvergedReason reason;
+        KSPGetConvergedReason( t.ksp, &reason );
+        KSPGetIterationNumber( t.ksp, &its );
+        KSPGetResidualNorm( t.ksp, &residual );
+
+        if( ksp_view_ )
+            KSPView( t.ksp, PETSC_VIEWER_STDOUT_WORLD );
+
+        auto err = PetscPrintf( PETSC_COMM_WORLD, "KSP Iterations %D, Final Residual %g\n", its, (double)residual );
+        CHKERRXX( err );
 
-        solve_system( t, ksp_type, pc_type, rtol_, atol_, dtol_, maxits_, ksp_view_ );
-        from_petsc_vec( solution, t.b );
+        VecGetArray( t.x, &vec );
+        std::copy( vec, vec + size, solution );
+        VecRestoreArray( t.x, &vec );
 
         LinearSolverReport rep = {};
-        rep.converged = true;
+        rep.converged = reason > 0;
+        rep.iterations = its;
         return rep;
     }
 
@@ -22,6 +22,7 @@
 #define OPM_LINEARSOLVERPETSC_HEADER_INCLUDED
 #include <opm/core/linalg/LinearSolverInterface.hpp>
 #include <opm/core/utility/parameters/ParameterGroup.hpp>
+#include <memory>
 #include <string>
 
 namespace Opm
@@ -42,6 +43,15 @@ namespace Opm
         /// Construct from parameters
         /// Accepted parameters are, with defaults, listed in the
         /// default constructor.
+        ///
+        /// The KSP, preconditioner and matrix are kept between solves
+        /// of systems with the same sparsity pattern. How they are
+        /// reused is controlled by
+        ///   ksp_reuse_pc (false)               Keep the preconditioner built
+        ///                                      for the first matrix of a pattern.
+        ///   ksp_initial_guess_nonzero (false)  Start from the solution argument.
+        ///   ksp_set_from_options_once (true)   Apply the PETSc options database
+        ///                                      only in the first solve.
         LinearSolverPetsc(const ParameterGroup& param);
 
         /// Destructor.
@@ -74,6 +84,12 @@ namespace Opm
         /// Get tolerance ofthe linear solver.
         /// \param[out] tolerance value
         virtual double getTolerance() const;
+
+        /// Number of times a KSP object has been created.
+        int kspCreateCount() const { return ksp_create_count_; }
+
+        /// Number of solves that rebuilt the preconditioner.
+        int preconditionerSetupCount() const { return pc_setup_count_; }
     private:
         std::string     ksp_type_;
         std::string     pc_type_;
@@ -82,6 +98,14 @@ namespace Opm
         double          atol_;
         double          dtol_;
         int             maxits_;
+        bool            reuse_pc_;
+        bool            initial_guess_nonzero_;
+        bool            options_once_;
+
+        struct PetscData;
+        mutable std::unique_ptr<PetscData> data_;
+        mutable int     ksp_create_count_;
+        mutable int     pc_setup_count_;
     };
 
 
@@ -36,6 +36,7 @@
 #include "config.h"
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <umfpack.h>
 
@@ -104,7 +105,8 @@ static void
 csr_to_csc(const int        *ia,
            const int        *ja,
            const double     *sa,
-           struct CSCMatrix *csc)
+           struct CSCMatrix *csc,
+           UF_long          *map)
 /* ---------------------------------------------------------------------- */
 {
     UF_long i, nz;
@@ -131,6 +133,10 @@ csr_to_csc(const int        *ia,
             csc->i[ csc->p[ ja[nz] + 1 ] ] = i;      /* Insertion sort */
             csc->x[ csc->p[ ja[nz] + 1 ] ] = sa[nz]; /* Insert mat elem */
 
+            if (map != NULL) {                       /* CSR -> CSC index */
+                map[nz] = csc->p[ ja[nz] + 1 ];
+            }
+
             csc->p        [ ja[nz] + 1 ]  += 1;      /* Advance col ptr */
         }
     }
@@ -175,7 +181,7 @@ call_UMFPACK(struct CSRMatrix *A, const double *b, double *x)
     csc = csc_allocate(A->m, A->ia[A->m]);
 
     if (csc != NULL) {
-        csr_to_csc(A->ia, A->ja, A->sa, csc);
+        csr_to_csc(A->ia, A->ja, A->sa, csc, NULL);
 
         solve_umfpack(csc, b, x);
     }
@@ -183,3 +189,173 @@ call_UMFPACK(struct CSRMatrix *A, const double *b, double *x)
     csc_deallocate(csc);
 }
 
+
+
+struct UMFPACKSolver {
+    size_t            m;
+    size_t            nnz;
+
+    int              *ia;       /* Pattern of current symbolic analysis */
+    int              *ja;
+
+    struct CSCMatrix *csc;
+    UF_long          *map;      /* CSR non-zero -> CSC non-zero */
+
+    void             *Symbolic;
+    double            Control[UMFPACK_CONTROL];
+};
+
+
+/* ---------------------------------------------------------------------- */
+static void
+umfpack_solver_clear(struct UMFPACKSolver *s)
+/* ---------------------------------------------------------------------- */
+{
+    if (s->Symbolic != NULL) {
+        umfpack_dl_free_symbolic(&s->Symbolic);
+    }
+
+    csc_deallocate(s->csc);
+    free(s->map);
+    free(s->ja);
+    free(s->ia);
+
+    s->m   = s->nnz = 0;
+    s->ia  = s->ja  = NULL;
+    s->csc = NULL;
+    s->map = NULL;
+
+    s->Symbolic = NULL;
+}
+
+
+/* ---------------------------------------------------------------------- */
+static int
+umfpack_solver_same_pattern(const struct UMFPACKSolver *s,
+                            const struct CSRMatrix     *A)
+/* ---------------------------------------------------------------------- */
+{
+    return (s->Symbolic != NULL) && (s->m == A->m) &&
+        (s->nnz == (size_t) A->ia[A->m]) &&
+        (memcmp(s->ia, A->ia, (s->m + 1) * sizeof *s->ia) == 0) &&
+        (memcmp(s->ja, A->ja, s->nnz     * sizeof *s->ja) == 0);
+}
+
+
+/* Build CSC copy, index map and symbolic analysis of A's pattern. */
+/* ---------------------------------------------------------------------- */
+static int
+umfpack_solver_analyse(struct UMFPACKSolver *s, const struct CSRMatrix *A)
+/* ---------------------------------------------------------------------- */
+{
+    UF_long status;
+    double  Info[UMFPACK_INFO];
+
+    umfpack_solver_clear(s);
+
+    s->m   = A->m;
+    s->nnz = A->ia[A->m];
+
+    s->csc = csc_allocate(s->m, s->nnz);
+    s->map = malloc(s->nnz       * sizeof *s->map);
+    s->ia  = malloc((s->m + 1)   * sizeof *s->ia);
+    s->ja  = malloc(s->nnz       * sizeof *s->ja);
+
+    if ((s->csc == NULL) || (s->map == NULL) ||
+        (s->ia  == NULL) || (s->ja  == NULL)) {
+        umfpack_solver_clear(s);
+        return 0;
+    }
+
+    memcpy(s->ia, A->ia, (s->m + 1) * sizeof *s->ia);
+    memcpy(s->ja, A->ja, s->nnz     * sizeof *s->ja);
+
+    csr_to_csc(A->ia, A->ja, A->sa, s->csc, s->map);
+
+    status = umfpack_dl_symbolic(s->csc->n, s->csc->n,
+                                 s->csc->p, s->csc->i, s->csc->x,
+                                 &s->Symbolic, s->Control, Info);
+
+    if (status != UMFPACK_OK) {
+        umfpack_solver_clear(s);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+/* ---------------------------------------------------------------------- */
+struct UMFPACKSolver *
+umfpack_solver_new(void)
+/* ---------------------------------------------------------------------- */
+{
+    struct UMFPACKSolver *new;
+
+    new = malloc(1 * sizeof *new);
+
+    if (new != NULL) {
+        new->m   = new->nnz = 0;
+        new->ia  = new->ja  = NULL;
+        new->csc = NULL;
+        new->map = NULL;
+
+        new->Symbolic = NULL;
+
+        umfpack_dl_defaults(new->Control);
+    }
+
+    return new;
+}
+
+
+/* ---------------------------------------------------------------------- */
+void
+umfpack_solver_delete(struct UMFPACKSolver *s)
+/* ---------------------------------------------------------------------- */
+{
+    if (s != NULL) {
+        umfpack_solver_clear(s);
+    }
+
+    free(s);
+}
+
+
+/* ---------------------------------------------------------------------- */
+int
+umfpack_solver_solve(struct UMFPACKSolver   *s,
+                     const struct CSRMatrix *A,
+                     const double           *b,
+                     double                 *x)
+/* ---------------------------------------------------------------------- */
+{
+    size_t  nz;
+    UF_long status;
+    void   *Numeric;
+    double  Info[UMFPACK_INFO];
+
+    if (umfpack_solver_same_pattern(s, A)) {
+        /* Values only */
+        for (nz = 0; nz < s->nnz; nz++) {
+            s->csc->x[ s->map[nz] ] = A->sa[nz];
+        }
+    } else if (! umfpack_solver_analyse(s, A)) {
+        return 0;
+    }
+
+    status = umfpack_dl_numeric(s->csc->p, s->csc->i, s->csc->x,
+                                s->Symbolic, &Numeric, s->Control, Info);
+
+    if (status < 0) {
+        umfpack_dl_free_numeric(&Numeric);
+        return 0;
+    }
+
+    umfpack_dl_solve(UMFPACK_A, s->csc->p, s->csc->i, s->csc->x, x, b,
+                     Numeric, s->Control, Info);
+
+    umfpack_dl_free_numeric(&Numeric);
+
+    return 1;
+}
@@ -40,9 +40,29 @@ extern "C" {
 #endif
 
 struct CSRMatrix;
+struct UMFPACKSolver;
 
 void call_UMFPACK(struct CSRMatrix *A, const double *b, double *x);
 
+/* Persistent direct solver for a sequence of systems sharing one
+ * sparsity pattern.  The symbolic analysis is retained and reused for
+ * as long as the pattern of successive matrices is unchanged, and only
+ * the numeric factorisation is recomputed in each solve.
+ *
+ * umfpack_solver_solve() returns one if successful and zero in case of
+ * allocation or factorisation failure. */
+struct UMFPACKSolver *
+umfpack_solver_new(void);
+
+void
+umfpack_solver_delete(struct UMFPACKSolver *s);
+
+int
+umfpack_solver_solve(struct UMFPACKSolver   *s,
+                     const struct CSRMatrix *A,
+                     const double           *b,
+                     double                 *x);
+
 #ifdef __cplusplus
 }
 #endif
@@ -163,6 +163,29 @@ csrmatrix_elm_index(int i, int j, const struct CSRMatrix *A)
 }
 
 
+/* ---------------------------------------------------------------------- */
+int
+csrmatrix_rows_sorted(const struct CSRMatrix *A)
+/* ---------------------------------------------------------------------- */
+{
+    size_t i;
+    int    j, ok;
+
+    ok = (A->ia[0] == 0) && ((size_t) A->ia[A->m] == A->nnz);
+
+    for (i = 0; ok && (i < A->m); i++) {
+        ok = A->ia[i] <= A->ia[i + 1];
+
+        for (j = A->ia[i]; ok && (j < A->ia[i + 1]); j++) {
+            ok = (A->ja[j] >= 0) && ((size_t) A->ja[j] < A->m) &&
+                 ((j == A->ia[i]) || (A->ja[j - 1] <= A->ja[j]));
+        }
+    }
+
+    return ok;
+}
+
+
 /* ---------------------------------------------------------------------- */
 void
 csrmatrix_delete(struct CSRMatrix *A)
@@ -262,3 +285,173 @@ vector_write_stream(size_t n, const double *v, FILE *fp)
         fprintf(fp, "%26.18e\n", v[i]);
     }
 }
+
+
+/* ---------------------------------------------------------------------- */
+struct BlockCSRMatrix *
+bcsrmatrix_new_count_nnz(size_t m, int bs)
+/* ---------------------------------------------------------------------- */
+{
+    size_t                 i;
+    struct BlockCSRMatrix *new;
+
+    assert (m > 0);
+    assert ((1 <= bs) && (bs <= 4));
+
+    new = malloc(1 * sizeof *new);
+    if (new != NULL) {
+        new->ia = malloc((m + 1) * sizeof *new->ia);
+
+        if (new->ia != NULL) {
+            for (i = 0; i < m + 1; i++) { new->ia[i] = 0; }
+
+            new->m   = m;
+            new->nnz = 0;
+            new->bs  = bs;
+
+            new->ja  = NULL;
+            new->sa  = NULL;
+        } else {
+            new->ja = NULL;
+            new->sa = NULL;
+            bcsrmatrix_delete(new);
+            new = NULL;
+        }
+    }
+
+    return new;
+}
+
+
+/* ---------------------------------------------------------------------- */
+struct BlockCSRMatrix *
+bcsrmatrix_new_known_nnz(size_t m, size_t nnz, int bs)
+/* ---------------------------------------------------------------------- */
+{
+    struct BlockCSRMatrix *new;
+
+    assert ((1 <= bs) && (bs <= 4));
+
+    new = malloc(1 * sizeof *new);
+
+    if (new != NULL) {
+        new->ia = malloc((m + 1)          * sizeof *new->ia);
+        new->ja = malloc(nnz              * sizeof *new->ja);
+        new->sa = malloc(nnz * (bs * bs)  * sizeof *new->sa);
+
+        if ((new->ia == NULL) || (new->ja == NULL) || (new->sa == NULL)) {
+            bcsrmatrix_delete(new);
+            new = NULL;
+        } else {
+            new->m   = m;
+            new->nnz = nnz;
+            new->bs  = bs;
+        }
+    }
+
+    return new;
+}
+
+
+/* ---------------------------------------------------------------------- */
+size_t
+bcsrmatrix_new_elms_pushback(struct BlockCSRMatrix *A)
+/* ---------------------------------------------------------------------- */
+{
+    size_t i;
+
+    assert (A->ia[0] == 0);     /* Blocks for row 'i' in bin i+1 ... */
+
+    for (i = 1; i <= A->m; i++) {
+        A->ia[0] += A->ia[i];
+        A->ia[i]  = A->ia[0] - A->ia[i];
+    }
+
+    A->nnz = A->ia[0];
+    assert (A->nnz > 0);        /* Else not a real system. */
+
+    A->ia[0] = 0;
+
+    A->ja = malloc(A->nnz                   * sizeof *A->ja);
+    A->sa = malloc(A->nnz * (A->bs * A->bs) * sizeof *A->sa);
+
+    if ((A->ja == NULL) || (A->sa == NULL)) {
+        free(A->sa);   A->sa = NULL;
+        free(A->ja);   A->ja = NULL;
+
+        A->nnz = 0;
+    }
+
+    return A->nnz;
+}
+
+
+/* ---------------------------------------------------------------------- */
+size_t
+bcsrmatrix_elm_index(int i, int j, const struct BlockCSRMatrix *A)
+/* ---------------------------------------------------------------------- */
+{
+    int *p;
+
+    p = bsearch(&j, A->ja + A->ia[i], A->ia[i + 1] - A->ia[i],
+                sizeof A->ja[A->ia[i]], cmp_row_elems);
+
+    assert (p != NULL);
+
+    return p - A->ja;
+}
+
+
+/* ---------------------------------------------------------------------- */
+void
+bcsrmatrix_sortrows(struct BlockCSRMatrix *A)
+/* ---------------------------------------------------------------------- */
+{
+    size_t i;
+
+    for (i = 0; i < A->m; i++) {
+        qsort(A->ja        + A->ia[i] ,
+              A->ia[i + 1] - A->ia[i] ,
+              sizeof A->ja  [A->ia[i]],
+              cmp_row_elems);
+    }
+}
+
+
+/* ---------------------------------------------------------------------- */
+void
+bcsrmatrix_add_block(int i, int j, const double *b, struct BlockCSRMatrix *A)
+/* ---------------------------------------------------------------------- */
+{
+    size_t  k, n;
+    double *a;
+
+    n = A->bs * A->bs;
+    a = A->sa + bcsrmatrix_elm_index(i, j, A) * n;
+
+    for (k = 0; k < n; k++) { a[k] += b[k]; }
+}
+
+
+/* ---------------------------------------------------------------------- */
+void
+bcsrmatrix_delete(struct BlockCSRMatrix *A)
+/* ---------------------------------------------------------------------- */
+{
+    if (A != NULL) {
+        free(A->sa);
+        free(A->ja);
+        free(A->ia);
+    }
+
+    free(A);
+}
+
+
+/* ---------------------------------------------------------------------- */
+void
+bcsrmatrix_zero(struct BlockCSRMatrix *A)
+/* ---------------------------------------------------------------------- */
+{
+    vector_zero(A->nnz * (A->bs * A->bs), A->sa);
+}
@@ -148,6 +148,23 @@ void
 csrmatrix_sortrows(struct CSRMatrix *A);
 
 
+/**
+ * Check the sorted row invariant that csrmatrix_elm_index() relies on.
+ *
+ * Repeated column indices within a row are accepted.  They arise from
+ * csrmatrix_sortrows() when two cells share several faces, and
+ * csrmatrix_elm_index() consistently resolves such an element to one
+ * of its copies.
+ *
+ * \param[in] A Matrix.
+ * \return One if the column indices of each row are non-decreasing
+ * and in the range <CODE>[0, A->m)</CODE>, and if the row pointers are
+ * consistent with <CODE>A->nnz</CODE>, zero otherwise.
+ */
+int
+csrmatrix_rows_sorted(const struct CSRMatrix *A);
+
+
 /**
  * Dispose of memory resources obtained through prior calls to
  * allocation routines.
@@ -245,6 +262,130 @@ vector_write(size_t n, const double *v, const char *fn);
 void
 vector_write_stream(size_t n, const double *v, FILE *fp);
 
+
+/**
+ * Block compressed-sparse row (BCSR) matrix data structure.
+ *
+ * The matrix consists of @c m by @c m dense blocks of size @c bs by
+ * @c bs, of which @c nnz are structurally non-zero.  The sparsity
+ * pattern is stored once per block, as in struct CSRMatrix, and the
+ * elements of block @c k are stored in row major order in
+ * <CODE>sa[bs*bs*k], ..., sa[bs*bs*(k+1) - 1]</CODE>.
+ */
+struct BlockCSRMatrix
+{
+    size_t      m;    /**< Number of block rows */
+    size_t      nnz;  /**< Number of structurally non-zero blocks */
+    int         bs;   /**< Block size, 1 to 4 */
+
+    int        *ia;   /**< Block row pointers */
+    int        *ja;   /**< Block column indices */
+
+    double     *sa;   /**< Block elements, bs*bs per block */
+};
+
+
+/**
+ * Allocate a block matrix structure and corresponding row pointers,
+ * @c ia, for "count and push-back" construction as for
+ * csrmatrix_new_count_nnz().
+ *
+ * \param[in] m  Number of block rows.
+ * \param[in] bs Block size, 1 to 4.
+ * \return Allocated matrix structure, or @c NULL in case of allocation
+ * failure.
+ */
+struct BlockCSRMatrix *
+bcsrmatrix_new_count_nnz(size_t m, int bs);
+
+
+/**
+ * Allocate a block matrix structure and all constituent fields to hold
+ * a specified number of (structural) non-zero blocks.  The sparsity
+ * pattern must be constructed by the caller, as for
+ * csrmatrix_new_known_nnz().
+ *
+ * \param[in] m   Number of block rows.
+ * \param[in] nnz Number of structurally non-zero blocks.
+ * \param[in] bs  Block size, 1 to 4.
+ * \return Allocated matrix structure and constituent element arrays.
+ * @c NULL in case of allocation failure.
+ */
+struct BlockCSRMatrix *
+bcsrmatrix_new_known_nnz(size_t m, size_t nnz, int bs);
+
+
+/**
+ * Set row pointers and allocate column index and block element arrays
+ * of a matrix previously obtained from bcsrmatrix_new_count_nnz().
+ * The conventions are those of csrmatrix_new_elms_pushback(), with
+ * counts and indices referring to blocks.
+ *
+ * \param[in,out] A Block matrix.
+ * \return Total number of allocated non-zero blocks, zero in case of
+ * allocation failure.
+ */
+size_t
+bcsrmatrix_new_elms_pushback(struct BlockCSRMatrix *A);
+
+
+/**
+ * Compute non-zero block index of specified matrix block.  The
+ * elements of the block start at <CODE>A->sa + A->bs*A->bs*k</CODE>,
+ * in which @c k is the returned index.
+ *
+ * \param[in] i Block row index.
+ * \param[in] j Block column index.  Must be in the structural non-zero
+ *              block set of row @c i, and rows must be sorted.
+ * \param[in] A Block matrix.
+ * \return Non-zero block index, into @c A->ja, of block <CODE>(i,j)</CODE>.
+ */
+size_t
+bcsrmatrix_elm_index(int i, int j, const struct BlockCSRMatrix *A);
+
+
+/**
+ * Sort block column indices within each block row in ascending order.
+ * As for csrmatrix_sortrows(), the block elements are not referenced.
+ *
+ * \param[in,out] A Block matrix.
+ */
+void
+bcsrmatrix_sortrows(struct BlockCSRMatrix *A);
+
+
+/**
+ * Add a dense block to the non-zero block <CODE>(i,j)</CODE>.
+ *
+ * \param[in]     i Block row index.
+ * \param[in]     j Block column index, in the sparsity pattern of row @c i.
+ * \param[in]     b Block elements, <CODE>A->bs*A->bs</CODE> values in row
+ *                  major order.
+ * \param[in,out] A Block matrix.
+ */
+void
+bcsrmatrix_add_block(int i, int j, const double *b, struct BlockCSRMatrix *A);
+
+
+/**
+ * Dispose of memory resources obtained through prior calls to block
+ * matrix allocation routines.
+ *
+ * \param[in,out] A Block matrix.
+ */
+void
+bcsrmatrix_delete(struct BlockCSRMatrix *A);
+
+
+/**
+ * Zero all block elements, typically in preparation of elemental
+ * assembly.
+ *
+ * \param[in,out] A Block matrix for which to zero the elements.
+ */
+void
+bcsrmatrix_zero(struct BlockCSRMatrix *A);
+
 #ifdef __cplusplus
 }
 #endif
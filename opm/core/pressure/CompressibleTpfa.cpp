@@ -27,6 +27,8 @@
 #include <opm/core/linalg/LinearSolverInterface.hpp>
 #include <opm/core/linalg/sparse_sys.h>
 #include <opm/common/ErrorMacros.hpp>
+#include <opm/core/utility/BufferedLog.hpp>
+#include <opm/core/utility/Instrumentation.hpp>
 #include <opm/core/utility/miscUtilities.hpp>
 #include <opm/core/wells.h>
 #include <opm/core/simulator/BlackoilState.hpp>
@@ -123,6 +125,7 @@ namespace Opm
                                  BlackoilState& state,
                                  WellState& well_state)
     {
+        OPM_TIMER_SCOPE("pressure");
         const int nc = grid_.number_of_cells;
         const int nw = (wells_ != 0) ? wells_->number_of_wells : 0;
 
@@ -136,10 +139,11 @@ namespace Opm
         double inc_norm = 0.0;
         int iter = 0;
         double res_norm = residualNorm();
-        std::cout << "\nIteration         Residual        Change in p\n"
-                  << std::setw(9) << iter
-                  << std::setw(18) << res_norm
-                  << std::setw(18) << '*' << std::endl;
+        OPM_BUFFERED_LOG(BufferedLog::Iterations,
+                         "\nIteration         Residual        Change in p\n"
+                         << std::setw(9) << iter
+                         << std::setw(18) << res_norm
+                         << std::setw(18) << '*');
         while ((iter < maxiter_) && (res_norm > residual_tol_)) {
             // Solve for increment in Newton method:
             //   incr = x_{n+1} - x_{n} = -J^{-1}F
@@ -158,9 +162,10 @@ namespace Opm
             // Stop iterating if increment is small.
             inc_norm = incrementNorm();
             if (inc_norm <= change_tol_) {
-                std::cout << std::setw(9) << iter
-                          << std::setw(18) << '*'
-                          << std::setw(18) << inc_norm << std::endl;
+                OPM_BUFFERED_LOG(BufferedLog::Iterations,
+                                 std::setw(9) << iter
+                                 << std::setw(18) << '*'
+                                 << std::setw(18) << inc_norm);
                 break;
             }
 
@@ -173,16 +178,20 @@ namespace Opm
             // Update residual norm.
             res_norm = residualNorm();
 
-            std::cout << std::setw(9) << iter
-                      << std::setw(18) << res_norm
-                      << std::setw(18) << inc_norm << std::endl;
+            OPM_BUFFERED_LOG(BufferedLog::Iterations,
+                             std::setw(9) << iter
+                             << std::setw(18) << res_norm
+                             << std::setw(18) << inc_norm);
         }
 
         if ((iter == maxiter_) && (res_norm > residual_tol_) && (inc_norm > change_tol_)) {
+            BufferedLog::flush();
             OPM_THROW(std::runtime_error, "CompressibleTpfa::solve() failed to converge in " << maxiter_ << " iterations.");
         }
 
-        std::cout << "Solved pressure in " << iter << " iterations." << std::endl;
+        OPM_COUNTER_ADD("newton iterations", iter);
+        OPM_BUFFERED_LOG(BufferedLog::Summary, "Solved pressure in " << iter << " iterations.");
+        BufferedLog::flush();
 
         // Compute fluxes and face pressures.
         computeResults(state, well_state);
@@ -334,9 +343,7 @@ namespace Opm
         if (rock_comp_props_ && rock_comp_props_->isActive()) {
             computePorevolume(grid_, props_.porosity(), *rock_comp_props_, state.pressure(), porevol_);
             rock_comp_.resize(nc);
-            for (int cell = 0; cell < nc; ++cell) {
-                rock_comp_[cell] = rock_comp_props_->rockComp(state.pressure()[cell]);
-            }
+            rock_comp_props_->rockComp(nc, state.pressure().data(), rock_comp_.data());
         }
     }
 
@@ -508,6 +515,7 @@ namespace Opm
                                     const BlackoilState& state,
                                     const WellState& well_state)
     {
+        OPM_TIMER_SCOPE("assemble");
         const double* cell_press = &state.pressure()[0];
         const double* well_bhp = well_state.bhp().empty() ? NULL : &well_state.bhp()[0];
         const double* z = &state.surfacevol()[0];
@@ -32,6 +32,8 @@
 #include <opm/core/linalg/sparse_sys.h>
 #include <opm/core/simulator/WellState.hpp>
 #include <opm/common/ErrorMacros.hpp>
+#include <opm/core/utility/BufferedLog.hpp>
+#include <opm/core/utility/Instrumentation.hpp>
 #include <opm/core/utility/miscUtilities.hpp>
 #include <opm/core/wells.h>
 #include <iostream>
@@ -159,6 +161,7 @@ namespace Opm
                            SimulationDataContainer& state,
                            WellState& well_state)
     {
+        OPM_TIMER_SCOPE("pressure");
         if (rock_comp_props_ != 0 && rock_comp_props_->isActive()) {
             solveRockComp(dt, state, well_state);
         } else {
@@ -178,9 +181,12 @@ namespace Opm
 
         // Assemble.
         UnstructuredGrid* gg = const_cast<UnstructuredGrid*>(&grid_);
-        int ok = ifs_tpfa_assemble(gg, &forces_, &trans_[0], &gpress_omegaweighted_[0], h_);
-        if (!ok) {
-            OPM_THROW(std::runtime_error, "Failed assembling pressure system.");
+        {
+            OPM_TIMER_SCOPE("assemble");
+            int ok = ifs_tpfa_assemble(gg, &forces_, &trans_[0], &gpress_omegaweighted_[0], h_);
+            if (!ok) {
+                OPM_THROW(std::runtime_error, "Failed assembling pressure system.");
+            }
         }
 
         // Solve.
@@ -227,10 +233,11 @@ namespace Opm
         double inc_norm = 0.0;
         int iter = 0;
         double res_norm = residualNorm();
-        std::cout << "\nIteration         Residual        Change in p\n"
-                  << std::setw(9) << iter
-                  << std::setw(18) << res_norm
-                  << std::setw(18) << '*' << std::endl;
+        OPM_BUFFERED_LOG(BufferedLog::Iterations,
+                         "\nIteration         Residual        Change in p\n"
+                         << std::setw(9) << iter
+                         << std::setw(18) << res_norm
+                         << std::setw(18) << '*');
         while ((iter < maxiter_) && (res_norm > residual_tol_)) {
             // Solve for increment in Newton method:
             //   incr = x_{n+1} - x_{n} = -J^{-1}F
@@ -249,9 +256,10 @@ namespace Opm
             // Stop iterating if increment is small.
             inc_norm = incrementNorm();
             if (inc_norm <= change_tol_) {
-                std::cout << std::setw(9) << iter
-                          << std::setw(18) << '*'
-                          << std::setw(18) << inc_norm << std::endl;
+                OPM_BUFFERED_LOG(BufferedLog::Iterations,
+                                 std::setw(9) << iter
+                                 << std::setw(18) << '*'
+                                 << std::setw(18) << inc_norm);
                 break;
             }
 
@@ -264,16 +272,20 @@ namespace Opm
             // Update residual norm.
             res_norm = residualNorm();
 
-            std::cout << std::setw(9) << iter
-                      << std::setw(18) << res_norm
-                      << std::setw(18) << inc_norm << std::endl;
+            OPM_BUFFERED_LOG(BufferedLog::Iterations,
+                             std::setw(9) << iter
+                             << std::setw(18) << res_norm
+                             << std::setw(18) << inc_norm);
         }
 
         if ((iter == maxiter_) && (res_norm > residual_tol_) && (inc_norm > change_tol_)) {
+            BufferedLog::flush();
             OPM_THROW(std::runtime_error, "IncompTpfa::solve() failed to converge in " << maxiter_ << " iterations.");
         }
 
-        std::cout << "Solved pressure in " << iter << " iterations." << std::endl;
+        OPM_COUNTER_ADD("newton iterations", iter);
+        OPM_BUFFERED_LOG(BufferedLog::Summary, "Solved pressure in " << iter << " iterations.");
+        BufferedLog::flush();
 
         // Compute fluxes and face pressures.
         computeResults(state, well_state);
@@ -340,14 +352,14 @@ namespace Opm
             Opm::computeWDP(*wells_, grid_, state.saturation(), props_.density(),
                             gravity_ ? gravity_[2] : 0.0, true, wdp_);
         }
-        // totmob_, omega_, gpress_omegaweighted_
+        // phasemob_, totmob_, omega_, gpress_omegaweighted_
         if (gravity_) {
-            computeTotalMobilityOmega(props_, allcells_, state.saturation(), totmob_, omega_);
+            computeTotalMobilityOmega(props_, allcells_, state.saturation(), phasemob_, totmob_, omega_);
             mim_ip_density_update(grid_.number_of_cells, grid_.cell_facepos,
                                   &omega_[0],
                                   &gpress_[0], &gpress_omegaweighted_[0]);
         } else {
-            computeTotalMobility(props_, allcells_, state.saturation(), totmob_);
+            computeTotalMobility(props_, allcells_, state.saturation(), phasemob_, totmob_);
         }
         // trans_
         tpfa_eff_trans_compute(const_cast<UnstructuredGrid*>(&grid_), &totmob_[0], &htrans_[0], &trans_[0]);
@@ -381,9 +393,7 @@ namespace Opm
 
         computePorevolume(grid_, props_.porosity(), *rock_comp_props_, state.pressure(), porevol_);
         if (rock_comp_props_ && rock_comp_props_->isActive()) {
-            for (int cell = 0; cell < grid_.number_of_cells; ++cell) {
-                rock_comp_[cell] = rock_comp_props_->rockComp(state.pressure()[cell]);
-            }
+            rock_comp_props_->rockComp(grid_.number_of_cells, state.pressure().data(), rock_comp_.data());
         }
         if (wells_) {
             std::copy(state.pressure().begin(), state.pressure().end(), pressures_.begin());
@@ -400,6 +410,7 @@ namespace Opm
                               const SimulationDataContainer& state,
                               const WellState& /*well_state*/)
     {
+        OPM_TIMER_SCOPE("assemble");
         const double* pressures = wells_ ? &pressures_[0] : &state.pressure()[0];
 
         bool ok = ifs_tpfa_assemble_comprock_increment(const_cast<UnstructuredGrid*>(&grid_),
@@ -166,6 +166,7 @@ namespace Opm
         // ------ Data that will be modified for every solve. ------
 	std::vector<double> trans_ ;
         std::vector<double> wdp_;
+        std::vector<double> phasemob_;
         std::vector<double> totmob_;
         std::vector<double> omega_;
 	std::vector<double> gpress_omegaweighted_;
@@ -1,7 +1,7 @@
-#include <opm/core/linalg/blas_lapack.h>
 #include <opm/core/pressure/tpfa/trans_tpfa.h>
 #include <opm/core/grid/GridHelpers.hpp>
 
+#include <cassert>
 #include <cmath>
 
 namespace Dune
@@ -22,30 +22,34 @@ double faceArea(const Dune::CpGrid&, int);
 namespace
 {
 #ifdef HAVE_OPM_GRID
-inline const double* multiplyFaceNormalWithArea(const Dune::CpGrid& grid, int face_index, const double* in)
+inline const double* multiplyFaceNormalWithArea(const Dune::CpGrid& grid, int face_index, const double* in, double* out)
 {
     int d=Opm::UgGridHelpers::dimensions(grid);
-    double* out=new double[d];
     double area=Opm::UgGridHelpers::faceArea(grid, face_index);
     
     for(int i=0;i<d;++i)
         out[i]=in[i]*area;
     return out;
 }
-
-inline void maybeFreeFaceNormal(const Dune::CpGrid&, const double* array)
-{
-    delete[] array;
-}
 #endif  // HAVE_OPM_GRID
 
-inline const double* multiplyFaceNormalWithArea(const UnstructuredGrid&, int, const double* in)
+inline const double* multiplyFaceNormalWithArea(const UnstructuredGrid&, int, const double* in, double*)
 {
     return in;
 }
 
-inline void maybeFreeFaceNormal(const UnstructuredGrid&, const double*)
-{}
+// Whether all off-diagonal entries of the d-by-d tensor K are zero.
+inline bool isDiagonal(int d, const double* K)
+{
+    for (int i = 0; i < d; ++i) {
+        for (int j = 0; j < d; ++j) {
+            if (i != j && K[i + j*d] != 0.0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
 }
 
 /* ---------------------------------------------------------------------- */
@@ -58,9 +62,10 @@ tpfa_htrans_compute(const Grid* G, const double *perm, double *htrans)
 {
     using namespace Opm::UgGridHelpers;
     int    d, j;
-    double s, dist, denom;
+    double s, dist, num, denom;
 
     double Kn[3];
+    double nbuf[3];
     typename CellCentroidTraits<Grid>::IteratorType cc = beginCellCentroids(*G);
     typename Cell2FacesTraits<Grid>::Type c2f = cell2Faces(*G);
     typename FaceCellTraits<Grid>::Type face_cells = faceCells(*G);
@@ -68,17 +73,11 @@ tpfa_htrans_compute(const Grid* G, const double *perm, double *htrans)
     const double *n;
     const double *K;
 
-    MAT_SIZE_T nrows, ncols, ldA, incx, incy;
-    double a1, a2;
-
     d = dimensions(*G);
 
-    nrows = ncols    = ldA = d;
-    incx  = incy     = 1      ;
-    a1    = 1.0;  a2 = 0.0    ;
-
     for (int c =0, i = 0; c < numCells(*G); c++) {
         K  = perm + (c * d * d);
+        const bool diag = isDiagonal(d, K);
         
         typedef typename Cell2FacesTraits<Grid>::Type::row_type FaceRow;
         FaceRow faces = c2f[c];
@@ -88,23 +87,33 @@ tpfa_htrans_compute(const Grid* G, const double *perm, double *htrans)
         {
             s = 2.0*(face_cells(*f, 0) == c) - 1.0;
             n = faceNormal(*G, *f);
-            const double* nn=multiplyFaceNormalWithArea(*G, *f, n);
+            const double* nn=multiplyFaceNormalWithArea(*G, *f, n, nbuf);
             const double* fc = &(faceCentroid(*G, *f)[0]);
-            dgemv_("No Transpose", &nrows, &ncols,
-                   &a1, K, &ldA, nn, &incx, &a2, &Kn[0], &incy);
-            maybeFreeFaceNormal(*G, nn);
+
+            // Kn <- K*nn, K in column major order.
+            if (diag) {
+                for (j = 0; j < d; j++) {
+                    Kn[j] = K[j*(d + 1)] * nn[j];
+                }
+            } else {
+                for (j = 0; j < d; j++) {
+                    Kn[j] = 0.0;
+                    for (int k = 0; k < d; k++) {
+                        Kn[j] += K[j + k*d] * nn[k];
+                    }
+                }
+            }
             
-            htrans[i] = denom = 0.0;
+            num = denom = 0.0;
             for (j = 0; j < d; j++) {
                 dist = fc[j] - getCoordinate(cc, j);
 
-                htrans[i] += s * dist * Kn[j];
-                denom     +=     dist * dist;
+                num   += s * dist * Kn[j];
+                denom +=     dist * dist;
             }
 
             assert (denom > 0);
-            htrans[i] /= denom;
-            htrans[i]  = std::abs(htrans[i]);
+            htrans[i] = std::abs(num / denom);
         }
         // Move to next cell centroid.
         cc = increment(cc, 1, d);
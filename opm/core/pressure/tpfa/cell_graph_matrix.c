@@ -0,0 +1,217 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "config.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <opm/core/grid.h>
+#include <opm/core/wells.h>
+#include <opm/core/linalg/sparse_sys.h>
+#include <opm/core/pressure/tpfa/cell_graph_matrix.h>
+
+
+/* Sort column indices ja[0 .. n-1] and remove duplicates.  Rows are
+ * short, so insertion sort is the method of choice.
+ *
+ * Returns the number of distinct column indices. */
+/* ---------------------------------------------------------------------- */
+static int
+sort_unique_row(int n, int *ja)
+/* ---------------------------------------------------------------------- */
+{
+    int i, j, k, v;
+
+    for (i = 1; i < n; i++) {
+        v = ja[i];
+
+        for (j = i; (j > 0) && (ja[j - 1] > v); j--) {
+            ja[j] = ja[j - 1];
+        }
+
+        ja[j] = v;
+    }
+
+    for (i = k = (n > 0); i < n; i++) {
+        if (ja[i] != ja[k - 1]) {
+            ja[k++] = ja[i];
+        }
+    }
+
+    return k;
+}
+
+
+/* Group well perforations by cell: the wells perforating cell 'c' are
+ * cperf[cperfpos[c] ... cperfpos[c+1]-1], in increasing order. */
+/* ---------------------------------------------------------------------- */
+static void
+perforations_by_cell(int nc, const struct Wells *W,
+                     int *cperfpos, int *cperf)
+/* ---------------------------------------------------------------------- */
+{
+    int c, i, w;
+
+    for (c = 0; c <= nc; c++) { cperfpos[c] = 0; }
+
+    for (i = 0; i < W->well_connpos[ W->number_of_wells ]; i++) {
+        cperfpos[ W->well_cells[i] + 1 ] += 1;
+    }
+
+    for (c = 0; c < nc; c++) { cperfpos[c + 1] += cperfpos[c]; }
+
+    for (w = i = 0; w < W->number_of_wells; w++) {
+        for (; i < W->well_connpos[w + 1]; i++) {
+            cperf[ cperfpos[ W->well_cells[i] ] ++ ] = w;
+        }
+    }
+
+    for (c = nc; c > 0; c--) { cperfpos[c] = cperfpos[c - 1]; }
+    cperfpos[0] = 0;
+}
+
+
+/* ---------------------------------------------------------------------- */
+struct CSRMatrix *
+cell_graph_matrix_construct(const struct UnstructuredGrid *G,
+                            const struct Wells            *W)
+/* ---------------------------------------------------------------------- */
+{
+    int    i, nc, nw, nnu, nperf, p;
+    int   *work, *len, *cperfpos, *cperf;
+    size_t nnz;
+
+    struct CSRMatrix *A;
+
+    nc    = G->number_of_cells;
+    nw    = (W != NULL) ? W->number_of_wells : 0;
+    nnu   = nc + nw;
+    nperf = (W != NULL) ? W->well_connpos[ nw ] : 0;
+
+    A    = csrmatrix_new_count_nnz(nnu);
+    work = malloc((nnu + (nc + 1) + nperf) * sizeof *work);
+
+    if ((A == NULL) || (work == NULL)) {
+        if (A != NULL) { csrmatrix_delete(A); }
+        free(work);
+
+        return NULL;
+    }
+
+    len      = work;
+    cperfpos = len      + nnu;
+    cperf    = cperfpos + (nc + 1);
+
+    if (W != NULL) {
+        perforations_by_cell(nc, W, cperfpos, cperf);
+    } else {
+        memset(cperfpos, 0, (nc + 1) * sizeof *cperfpos);
+    }
+
+    /* Pass 1: Upper bound on the number of non-zeros in each row. */
+#pragma omp parallel for schedule(static)
+    for (i = 0; i < nnu; i++) {
+        int n = 1;              /* Diagonal */
+
+        if (i < nc) {
+            int j;
+
+            for (j = G->cell_facepos[i]; j < G->cell_facepos[i + 1]; j++) {
+                const int f = G->cell_faces[j];
+
+                n += (G->face_cells[2*f + 0] >= 0) &&
+                     (G->face_cells[2*f + 1] >= 0);
+            }
+
+            n += cperfpos[i + 1] - cperfpos[i];
+        } else {
+            n += W->well_connpos[i - nc + 1] - W->well_connpos[i - nc];
+        }
+
+        A->ia[ i + 1 ] = n;
+    }
+
+    /* Row start pointers, A->ia[i+1], and element arrays. */
+    nnz = csrmatrix_new_elms_pushback(A);
+
+    if (nnz == 0) {
+        csrmatrix_delete(A);
+        free(work);
+
+        return NULL;
+    }
+
+    /* Pass 2: Fill, sort and deduplicate each row in its own slot. */
+#pragma omp parallel for schedule(static)
+    for (i = 0; i < nnu; i++) {
+        int  j;
+        int *row = A->ja + A->ia[ i + 1 ];
+        int  n   = 0;
+
+        row[ n++ ] = i;
+
+        if (i < nc) {
+            for (j = G->cell_facepos[i]; j < G->cell_facepos[i + 1]; j++) {
+                const int f  = G->cell_faces[j];
+                const int c1 = G->face_cells[2*f + 0];
+                const int c2 = G->face_cells[2*f + 1];
+
+                if ((c1 >= 0) && (c2 >= 0)) {
+                    row[ n++ ] = (c1 == i) ? c2 : c1;
+                }
+            }
+
+            for (j = cperfpos[i]; j < cperfpos[i + 1]; j++) {
+                row[ n++ ] = nc + cperf[j];
+            }
+        } else {
+            for (j  = W->well_connpos[i - nc];
+                 j  < W->well_connpos[i - nc + 1]; j++) {
+                row[ n++ ] = W->well_cells[j];
+            }
+        }
+
+        len[i] = sort_unique_row(n, row);
+    }
+
+    /* Close gaps left by duplicate entries and set final row pointers.
+     * Rows only ever move towards the front, so this is a single
+     * in-place sweep which does nothing but pointer updates in the
+     * common case of no duplicates. */
+    for (i = 0, p = 0; i < nnu; i++) {
+        const int start = A->ia[ i + 1 ];
+
+        if (start != p) {
+            memmove(A->ja + p, A->ja + start, len[i] * sizeof *A->ja);
+        }
+
+        p += len[i];
+        A->ia[ i + 1 ] = p;
+    }
+
+    A->nnz = p;
+
+    assert (csrmatrix_rows_sorted(A));
+
+    free(work);
+
+    return A;
+}
@@ -0,0 +1,70 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OPM_CELL_GRAPH_MATRIX_HEADER_INCLUDED
+#define OPM_CELL_GRAPH_MATRIX_HEADER_INCLUDED
+
+/**
+ * \file
+ * Construction of the sparsity pattern of cell-centred discretisations
+ * whose couplings follow the grid's cell neighbourship, optionally
+ * extended by one unknown per well.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct CSRMatrix;
+struct UnstructuredGrid;
+struct Wells;
+
+/**
+ * Construct the sparsity pattern of a cell-graph matrix.
+ *
+ * The matrix has one row per grid cell, followed by one row per well
+ * if @c W is non-NULL.  Row @c c holds the diagonal and one column
+ * for each distinct cell sharing a face with cell @c c.  Each well
+ * perforation @c i of well @c w couples row <CODE>W->well_cells[i]</CODE>
+ * to column <CODE>nc + w</CODE> and vice versa, in which @c nc is the
+ * number of grid cells.
+ *
+ * Rows are sorted and free of duplicate column indices, even when two
+ * cells share several faces or a well perforates a cell more than
+ * once.  Non-zero counting and row
+ * filling are independent per row and run in parallel when OpenMP is
+ * available.  The matrix elements, @c sa, are allocated but not
+ * initialised.
+ *
+ * \param[in] G Grid.
+ * \param[in] W Well topology.  @c NULL if there are no well unknowns.
+ *
+ * \return Matrix, to be released with csrmatrix_delete().  @c NULL in
+ * case of allocation failure.
+ */
+struct CSRMatrix *
+cell_graph_matrix_construct(const struct UnstructuredGrid *G,
+                            const struct Wells            *W);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* OPM_CELL_GRAPH_MATRIX_HEADER_INCLUDED */
@@ -0,0 +1,236 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/pressure/tpfa/cfs_tpfa_kernels.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+    // Explicit inverse of a small column-major matrix.
+    template <int NP>
+    struct Inverse;
+
+    template <>
+    struct Inverse<1>
+    {
+        static void compute(const double* A, double* inv)
+        {
+            assert(A[0] != 0.0);
+            inv[0] = 1.0 / A[0];
+        }
+    };
+
+    template <>
+    struct Inverse<2>
+    {
+        static void compute(const double* A, double* inv)
+        {
+            const double det = A[0]*A[3] - A[2]*A[1];
+            assert(det != 0.0);
+            const double r = 1.0 / det;
+            inv[0] =  A[3] * r;
+            inv[1] = -A[1] * r;
+            inv[2] = -A[2] * r;
+            inv[3] =  A[0] * r;
+        }
+    };
+
+    template <>
+    struct Inverse<3>
+    {
+        static void compute(const double* A, double* inv)
+        {
+            // A(i,j) == A[i + 3*j]
+            const double c00 = A[4]*A[8] - A[7]*A[5];
+            const double c01 = A[7]*A[2] - A[1]*A[8];
+            const double c02 = A[1]*A[5] - A[4]*A[2];
+            const double det = A[0]*c00 + A[3]*c01 + A[6]*c02;
+            assert(det != 0.0);
+            const double r = 1.0 / det;
+            inv[0] = c00 * r;
+            inv[1] = c01 * r;
+            inv[2] = c02 * r;
+            inv[3] = (A[6]*A[5] - A[3]*A[8]) * r;
+            inv[4] = (A[0]*A[8] - A[6]*A[2]) * r;
+            inv[5] = (A[3]*A[2] - A[0]*A[5]) * r;
+            inv[6] = (A[3]*A[7] - A[6]*A[4]) * r;
+            inv[7] = (A[6]*A[1] - A[0]*A[7]) * r;
+            inv[8] = (A[0]*A[4] - A[3]*A[1]) * r;
+        }
+    };
+
+
+    // y <- A x for an NP-by-ncol matrix A.
+    template <int NP>
+    inline void matvecFixed(const int ncol, const double* A, const double* x, double* y)
+    {
+        double acc[NP] = { 0.0 };
+        for (int j = 0; j < ncol; ++j, A += NP) {
+            for (int i = 0; i < NP; ++i) {
+                acc[i] += A[i] * x[j];
+            }
+        }
+        for (int i = 0; i < NP; ++i) {
+            y[i] = acc[i];
+        }
+    }
+
+
+    template <int NP>
+    void factoriseFixed(int /* np */, const double* A, double* lu, MAT_SIZE_T* /* ipiv */)
+    {
+        Inverse<NP>::compute(A, lu);
+    }
+
+
+    template <int NP>
+    void solveFixed(int /* np */, int nrhs, const double* lu, const MAT_SIZE_T* /* ipiv */,
+                    double* b)
+    {
+        // 'lu' holds the explicit inverse.
+        for (int k = 0; k < nrhs; ++k, b += NP) {
+            double x[NP];
+            for (int i = 0; i < NP; ++i) {
+                x[i] = b[i];
+            }
+            matvecFixed<NP>(NP, lu, x, b);
+        }
+    }
+
+
+    template <int NP>
+    void matvecFixedKernel(int /* np */, int ncol, const double* A, const double* x, double* y)
+    {
+        matvecFixed<NP>(ncol, A, x, y);
+    }
+
+
+    template <int NP>
+    void matmatFixed(int /* np */, int ncol, const double* A, const double* B, double* C)
+    {
+        for (int k = 0; k < ncol; ++k, B += NP, C += NP) {
+            matvecFixed<NP>(NP, A, B, C);
+        }
+    }
+
+
+    // Generic kernels for any number of phases, using BLAS/LAPACK.
+
+    void factoriseGeneric(int np, const double* A, double* lu, MAT_SIZE_T* ipiv)
+    {
+        MAT_SIZE_T m, n, ld, info;
+
+        m = n = ld = np;
+
+        std::memcpy(lu, A, np * np * sizeof *lu);
+        dgetrf_(&m, &n, lu, &ld, ipiv, &info);
+
+        assert (info == 0);
+        static_cast<void>(info);
+    }
+
+
+    void solveGeneric(int np, int nrhs, const double* lu, const MAT_SIZE_T* ipiv, double* b)
+    {
+        MAT_SIZE_T n, ldA, ldB, nb, info;
+
+        n = ldA = ldB = np;
+        nb = nrhs;
+
+        dgetrs_("No Transpose", &n,
+                &nb, lu, &ldA, ipiv,
+                b  , &ldB, &info);
+
+        assert (info == 0);
+        static_cast<void>(info);
+    }
+
+
+    void matvecGeneric(int np, int ncol, const double* A, const double* x, double* y)
+    {
+        MAT_SIZE_T m, n, ld, incx, incy;
+        double     a1, a2;
+
+        m    = ld = np;
+        n    = ncol;
+        incx = incy = 1;
+        a1   = 1.0;
+        a2   = 0.0;
+
+        dgemv_("No Transpose", &m, &n,
+               &a1, A, &ld, x, &incx,
+               &a2,         y, &incy);
+    }
+
+
+    void matmatGeneric(int np, int ncol, const double* A, const double* B, double* C)
+    {
+        MAT_SIZE_T m, n, k, ldA, ldB, ldC;
+        double     a1, a2;
+
+        m  = k = ldA = ldB = ldC = np;
+        n  = ncol;
+        a1 = 1.0;
+        a2 = 0.0;
+
+        dgemm_("No Transpose", "No Transpose", &m, &n, &k,
+               &a1, A, &ldA, B, &ldB, &a2, C, &ldC);
+    }
+
+
+    template <int NP>
+    void selectFixed(cfs_tpfa_kernels* kernels)
+    {
+        kernels->factorise = &factoriseFixed<NP>;
+        kernels->solve     = &solveFixed<NP>;
+        kernels->matvec    = &matvecFixedKernel<NP>;
+        kernels->matmat    = &matmatFixed<NP>;
+    }
+
+} // anonymous namespace
+
+
+void
+cfs_tpfa_kernels_select(int np, struct cfs_tpfa_kernels *kernels)
+{
+    kernels->np = np;
+
+    switch (np) {
+    case 1:
+        selectFixed<1>(kernels);
+        break;
+    case 2:
+        selectFixed<2>(kernels);
+        break;
+    case 3:
+        selectFixed<3>(kernels);
+        break;
+    default:
+        kernels->factorise = &factoriseGeneric;
+        kernels->solve     = &solveGeneric;
+        kernels->matvec    = &matvecGeneric;
+        kernels->matmat    = &matmatGeneric;
+        break;
+    }
+}
@@ -0,0 +1,90 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CFS_TPFA_KERNELS_H_HEADER
+#define OPM_CFS_TPFA_KERNELS_H_HEADER
+
+#include <opm/core/linalg/blas_lapack.h>
+
+/**
+ * \file
+ * Small dense matrix operations on the np-by-np fluid matrices used by the
+ * compressible pressure assembler (cfs_tpfa_residual).  All matrices are
+ * stored in column-major order.
+ *
+ * Fixed-size implementations, fully unrolled and using closed-form inverses,
+ * are provided for one, two and three phases.  Other phase counts use
+ * BLAS/LAPACK.  The implementation is selected once, at assembler
+ * construction, through cfs_tpfa_kernels_select().
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Table of dense kernels for a fixed number of phases.
+ */
+struct cfs_tpfa_kernels {
+    /**
+     * Number of phases the kernels were selected for.
+     */
+    int np;
+
+    /**
+     * Factorise the np-by-np matrix @c A into @c lu (np*np values).  The
+     * pivot array @c ipiv (np values) is only used by the generic kernel.
+     */
+    void (*factorise)(int np, const double *A, double *lu, MAT_SIZE_T *ipiv);
+
+    /**
+     * Solve the @c nrhs systems A x = b, using the factorisation computed
+     * by @c factorise.  Overwrites @c b (np-by-nrhs) with the solutions.
+     */
+    void (*solve)(int np, int nrhs, const double *lu, const MAT_SIZE_T *ipiv,
+                  double *b);
+
+    /**
+     * y <- A x, where @c A is np-by-ncol.
+     */
+    void (*matvec)(int np, int ncol, const double *A, const double *x,
+                   double *y);
+
+    /**
+     * C <- A B, where @c A is np-by-np and @c B is np-by-ncol.
+     */
+    void (*matmat)(int np, int ncol, const double *A, const double *B,
+                   double *C);
+};
+
+
+/**
+ * Fill in kernel table for @c np phases.
+ *
+ * @param[in]  np      Number of phases.
+ * @param[out] kernels Kernel table.
+ */
+void
+cfs_tpfa_kernels_select(int np, struct cfs_tpfa_kernels *kernels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* OPM_CFS_TPFA_KERNELS_H_HEADER */
@@ -11,6 +11,8 @@
 #include <opm/core/linalg/blas_lapack.h>
 #include <opm/core/linalg/sparse_sys.h>
 
+#include <opm/core/pressure/tpfa/cell_graph_matrix.h>
+#include <opm/core/pressure/tpfa/cfs_tpfa_kernels.h>
 #include <opm/core/pressure/tpfa/compr_quant_general.h>
 #include <opm/core/pressure/tpfa/compr_source.h>
 #include <opm/core/pressure/tpfa/trans_tpfa.h>
@@ -26,6 +28,8 @@
 
 
 struct densrat_util {
+    struct cfs_tpfa_kernels kernels;
+
     MAT_SIZE_T *ipiv;
 
     double      residual;
@@ -56,8 +60,15 @@ struct cfs_tpfa_res_impl {
 
     struct densrat_util *ratio;
 
+    /* Non-zero indices into J->sa, computed once at construction */
+    int                 *diag_ix;          /* (i,i) for all unknowns */
+    int                 *hf_ix;            /* (c,c2) per half-face, -1 if no c2 */
+    int                 *cw_ix;            /* (c,w) per perforation */
+    int                 *wc_ix;            /* (w,c) per perforation */
+
     /* Linear storage */
     double *ddata;
+    int    *idata;
 };
 
 
@@ -108,6 +119,8 @@ allocate_densrat(size_t max_conn, int np)
             ratio->mat_row         = ratio->t2      + (1              * np);
             ratio->coeff           = ratio->mat_row + ((max_conn + 1) * 1 );
             ratio->linsolve_buffer = ratio->coeff   + ((max_conn + 1) * 1 );
+
+            cfs_tpfa_kernels_select(np, &ratio->kernels);
         }
     }
 
@@ -121,6 +134,7 @@ impl_deallocate(struct cfs_tpfa_res_impl *pimpl)
 /* ---------------------------------------------------------------------- */
 {
     if (pimpl != NULL) {
+        free              (pimpl->idata);
         free              (pimpl->ddata);
         deallocate_densrat(pimpl->ratio);
     }
@@ -137,12 +151,13 @@ impl_allocate(struct UnstructuredGrid   *G       ,
               int                        np      )
 /* ---------------------------------------------------------------------- */
 {
-    size_t                nnu, nwperf;
+    size_t                nnu, nwperf, nhf;
     struct cfs_tpfa_res_impl *new;
 
-    size_t ddata_sz;
+    size_t ddata_sz, idata_sz;
 
     nnu    = G->number_of_cells;
+    nhf    = G->cell_facepos[ G->number_of_cells ];
     nwperf = 0;
 
     if ((wells != NULL) && (wells->W != NULL)) {
@@ -165,15 +180,25 @@ impl_allocate(struct UnstructuredGrid   *G       ,
 
     ddata_sz += 1  *      G->number_of_faces ; /* scratch_f */
 
+    idata_sz  = 1 * nnu;                       /* diag_ix */
+    idata_sz += 1 * nhf;                       /* hf_ix */
+    idata_sz += 2 * nwperf;                    /* cw_ix, wc_ix */
+
     new = malloc(1 * sizeof *new);
 
     if (new != NULL) {
         new->ddata = malloc(ddata_sz * sizeof *new->ddata);
+        new->idata = malloc(idata_sz * sizeof *new->idata);
         new->ratio = allocate_densrat(max_conn, np);
 
-        if (new->ddata == NULL || new->ratio == NULL) {
+        if (new->ddata == NULL || new->idata == NULL || new->ratio == NULL) {
             impl_deallocate(new);
             new = NULL;
+        } else {
+            new->diag_ix = new->idata;
+            new->hf_ix   = new->diag_ix + nnu;
+            new->cw_ix   = new->hf_ix   + nhf;
+            new->wc_ix   = new->cw_ix   + nwperf;
         }
     }
 
@@ -181,119 +206,58 @@ impl_allocate(struct UnstructuredGrid   *G       ,
 }
 
 
+/* Look up the non-zero index of every Jacobian element touched by
+ * assembly once, so that assembly itself is a direct scatter. */
 /* ---------------------------------------------------------------------- */
-static struct CSRMatrix *
-construct_matrix(struct UnstructuredGrid   *G    ,
-                 struct cfs_tpfa_res_wells *wells)
+static void
+impl_set_indices(struct UnstructuredGrid   *G    ,
+                 struct cfs_tpfa_res_wells *wells,
+                 const struct CSRMatrix    *J    ,
+                 struct cfs_tpfa_res_impl  *pimpl)
 /* ---------------------------------------------------------------------- */
 {
-    int    f, c1, c2, w, i, nc, nnu;
-    int    wells_present;
-    size_t nnz;
-
-    struct CSRMatrix *A;
-
-    nc = nnu = G->number_of_cells;
-
-    wells_present = (wells != NULL) && (wells->W != NULL);
-    if (wells_present) {
-        nnu += wells->W->number_of_wells;
-    }
-
-    A = csrmatrix_new_count_nnz(nnu);
-
-    if (A != NULL) {
-        /* Self connections */
-        for (i = 0; i < nnu; i++) {
-            A->ia[ i + 1 ] = 1;
-        }
-
-        /* Other connections */
-        for (f = 0; f < G->number_of_faces; f++) {
-            c1 = G->face_cells[2*f + 0];
-            c2 = G->face_cells[2*f + 1];
-
-            if ((c1 >= 0) && (c2 >= 0)) {
-                A->ia[ c1 + 1 ] += 1;
-                A->ia[ c2 + 1 ] += 1;
-            }
-        }
+    int c, c1, c2, f, i, w, nc;
 
-        if (wells_present) {
-            /* Well <-> cell connections */
-            struct Wells *W = wells->W;
+    struct Wells *W;
 
-            for (w = i = 0; w < W->number_of_wells; w++) {
-                for (; i < W->well_connpos[w + 1]; i++) {
-                    c1 = W->well_cells[i];
+    assert (csrmatrix_rows_sorted(J));
 
-                    A->ia[ 0  + c1 + 1 ] += 1; /* c -> w */
-                    A->ia[ nc + w  + 1 ] += 1; /* w -> c */
-                }
-            }
-        }
+    nc = G->number_of_cells;
 
-        nnz = csrmatrix_new_elms_pushback(A);
-        if (nnz == 0) {
-            csrmatrix_delete(A);
-            A = NULL;
-        }
+    for (i = 0; i < (int) J->m; i++) {
+        pimpl->diag_ix[ i ] = (int) csrmatrix_elm_index(i, i, J);
     }
 
-    if (A != NULL) {
-        /* Fill self connections */
-        for (i = 0; i < nnu; i++) {
-            A->ja[ A->ia[ i + 1 ] ++ ] = i;
-        }
-
-        /* Fill other connections */
-        for (f = 0; f < G->number_of_faces; f++) {
+    for (c = i = 0; c < nc; c++) {
+        for (; i < G->cell_facepos[c + 1]; i++) {
+            f  = G->cell_faces[i];
             c1 = G->face_cells[2*f + 0];
             c2 = G->face_cells[2*f + 1];
+            c2 = (c1 == c) ? c2 : c1;
 
-            if ((c1 >= 0) && (c2 >= 0)) {
-                A->ja[ A->ia[ c1 + 1 ] ++ ] = c2;
-                A->ja[ A->ia[ c2 + 1 ] ++ ] = c1;
-            }
+            pimpl->hf_ix[ i ] = (c2 >= 0) ? (int) csrmatrix_elm_index(c, c2, J) : -1;
         }
+    }
 
-        if (wells_present) {
-            /* Fill well <-> cell connections */
-            struct Wells *W = wells->W;
+    if ((wells != NULL) && (wells->W != NULL)) {
+        W = wells->W;
 
-            for (w = i = 0; w < W->number_of_wells; w++) {
-                for (; i < W->well_connpos[w + 1]; i++) {
-                    c1 = W->well_cells[i];
+        for (w = i = 0; w < W->number_of_wells; w++) {
+            for (; i < W->well_connpos[w + 1]; i++) {
+                c = W->well_cells[i];
 
-                    A->ja[ A->ia[ 0  + c1 + 1 ] ++ ] = nc + w;
-                    A->ja[ A->ia[ nc + w  + 1 ] ++ ] = c1    ;
-                }
+                pimpl->cw_ix[ i ] = (int) csrmatrix_elm_index(c     , nc + w, J);
+                pimpl->wc_ix[ i ] = (int) csrmatrix_elm_index(nc + w, c     , J);
             }
         }
-
-        assert ((size_t) A->ia[ nnu ] == nnz);
-
-        /* Enforce sorted connection structure per row */
-        csrmatrix_sortrows(A);
     }
-
-    return A;
 }
 
 
 static void
 factorise_fluid_matrix(int np, const double *A, struct densrat_util *ratio)
 {
-    int        np2;
-    MAT_SIZE_T m, n, ld, info;
-
-    m = n = ld = np;
-    np2 = np * np;
-
-    memcpy (ratio->lu, A, np2 * sizeof *ratio->lu);
-    dgetrf_(&m, &n, ratio->lu, &ld, ratio->ipiv, &info);
-
-    assert (info == 0);
+    ratio->kernels.factorise(np, A, ratio->lu, ratio->ipiv);
 }
 
 
@@ -303,49 +267,23 @@ solve_linear_systems(int                  np   ,
                      struct densrat_util *ratio,
                      double              *b    )
 {
-    MAT_SIZE_T n, ldA, ldB, info;
-
-    n = ldA = ldB = np;
-
-    dgetrs_("No Transpose", &n,
-            &nrhs, ratio->lu, &ldA, ratio->ipiv,
-            b               , &ldB, &info);
-
-    assert (info == 0);
+    ratio->kernels.solve(np, nrhs, ratio->lu, ratio->ipiv, b);
 }
 
 
 static void
-matvec(int nrow, int ncol, const double *A, const double *x, double *y)
+matvec(int nrow, int ncol, const double *A, const double *x, double *y,
+       const struct densrat_util *ratio)
 {
-    MAT_SIZE_T m, n, ld, incx, incy;
-    double     a1, a2;
-
-    m    = ld = nrow;
-    n    = ncol;
-    incx = incy = 1;
-    a1   = 1.0;
-    a2   = 0.0;
-
-    dgemv_("No Transpose", &m, &n,
-           &a1, A, &ld, x, &incx,
-           &a2,         y, &incy);
+    ratio->kernels.matvec(nrow, ncol, A, x, y);
 }
 
 
 static void
-matmat(int np, int ncol, const double *A, const double *B, double *C)
+matmat(int np, int ncol, const double *A, const double *B, double *C,
+       const struct densrat_util *ratio)
 {
-    MAT_SIZE_T m, n, k, ldA, ldB, ldC;
-    double     a1, a2;
-
-    m  = k = ldA = ldB = ldC = np;
-    n  = ncol;
-    a1 = 1.0;
-    a2 = 0.0;
-
-    dgemm_("No Transpose", "No Transpose", &m, &n, &k,
-           &a1, A, &ldA, B, &ldB, &a2, C, &ldC);
+    ratio->kernels.matmat(np, ncol, A, B, C);
 }
 
 
@@ -405,10 +343,10 @@ compute_compflux_and_deriv(struct UnstructuredGrid  *G     ,
                                         pimpl->flux_work + np);
 
             /* Component flux = Af * v*/
-            matvec(np, np, Af, pimpl->flux_work     , cflux );
+            matvec(np, np, Af, pimpl->flux_work     , cflux , pimpl->ratio);
 
             /* Derivative = Af * (dv/dp) */
-            matmat(np, 2 , Af, pimpl->flux_work + np, dcflux);
+            matmat(np, 2 , Af, pimpl->flux_work + np, dcflux, pimpl->ratio);
         }
 
         /* Boundary connections excluded */
@@ -463,10 +401,10 @@ compute_well_compflux_and_deriv(struct cfs_tpfa_res_wells *wells ,
                                         pimpl->flux_work + np);
 
             /* Component flux = Ap * q*/
-            matvec(np, np, Ap, pimpl->flux_work     , pflux );
+            matvec(np, np, Ap, pimpl->flux_work     , pflux , pimpl->ratio);
 
             /* Derivative = Ap * (dq/dp) */
-            matmat(np, 2 , Ap, pimpl->flux_work + np, dpflux);
+            matmat(np, 2 , Ap, pimpl->flux_work + np, dpflux, pimpl->ratio);
         }
     }
 }
@@ -565,7 +503,7 @@ compute_cell_contrib(struct UnstructuredGrid  *G    ,
     /* Sum residual contributions over the connections (+ accumulation):
      *   t1 <- (Ac \ [z, Af*v]) * [-pvol; repmat(dt, [nconn, 1])] */
     matvec(np, nconn + 1, pimpl->ratio->linsolve_buffer,
-           pimpl->ratio->coeff, pimpl->ratio->t1);
+           pimpl->ratio->coeff, pimpl->ratio->t1, pimpl->ratio);
 
     /* Compute residual in cell 'c' */
     pimpl->ratio->residual = pvol;
@@ -579,7 +517,7 @@ compute_cell_contrib(struct UnstructuredGrid  *G    ,
                 pimpl->ratio->mat_row);
 
     /* t2 <- A \ ((dA/dp) * t1) */
-    matvec(np, np, dAc, pimpl->ratio->t1, pimpl->ratio->t2);
+    matvec(np, np, dAc, pimpl->ratio->t1, pimpl->ratio->t2, pimpl->ratio);
     solve_linear_systems(np, 1, pimpl->ratio, pimpl->ratio->t2);
 
     dF2 = 0.0;
@@ -643,7 +581,7 @@ assemble_cell_contrib(struct UnstructuredGrid  *G,
 {
     int c1, c2, i, f, j1, j2, off;
 
-    j1 = csrmatrix_elm_index(c, c, h->J);
+    j1 = h->pimpl->diag_ix[ c ];
 
     h->J->sa[j1] += h->pimpl->ratio->mat_row[ 0 ];
 
@@ -657,7 +595,7 @@ assemble_cell_contrib(struct UnstructuredGrid  *G,
         c2 = (c1 == c) ? c2 : c1;
 
         if (c2 >= 0) {
-            j2 = csrmatrix_elm_index(c, c2, h->J);
+            j2 = h->pimpl->hf_ix[ i ];
 
             h->J->sa[j2] += h->pimpl->ratio->mat_row[ off ];
         }
@@ -695,13 +633,13 @@ init_completion_contrib(int                       i    ,
            np * sizeof *pimpl->ratio->t1);
 
     /* t2 <- Ac \ ((dA/dp) * t1) (== -d(Ac^{-1})/dp (A_{wi} q_{wi})) */
-    matvec(np, np, dAc, pimpl->ratio->t1, pimpl->ratio->t2);
+    matvec(np, np, dAc, pimpl->ratio->t1, pimpl->ratio->t2, pimpl->ratio);
     solve_linear_systems(np, 1, pimpl->ratio, pimpl->ratio->t2);
 }
 
 
 static void
-assemble_completion_to_cell(int c, int wdof, int np, double dt,
+assemble_completion_to_cell(int i, int c, int wdof, int np, double dt,
                             struct cfs_tpfa_res_data *h)
 {
     int    p;
@@ -723,8 +661,8 @@ assemble_completion_to_cell(int c, int wdof, int np, double dt,
 
     /* Assemble Jacobian contributions from well completion. */
     assert (wdof > c);
-    jc = csrmatrix_elm_index(c, c   , h->J);
-    jw = csrmatrix_elm_index(c, wdof, h->J);
+    jc = h->pimpl->diag_ix[ c ];
+    jw = h->pimpl->cw_ix  [ i ];
 
     /* Compressibility-like (diagonal) Jacobian term.  Positive sign
      * since the negative derivative in ->ratio->t2 (see
@@ -850,7 +788,7 @@ welleq_coeff_surfrate(int i, int np, struct cfs_tpfa_res_data *h,
 
 /* ---------------------------------------------------------------------- */
 static void
-assemble_completion_to_well(int i, int w, int c, int nc, int np,
+assemble_completion_to_well(int i, int w, int nc, int np,
                             double pw, double dt,
                             struct cfs_tpfa_res_wells *wells,
                             struct cfs_tpfa_res_data  *h    )
@@ -894,8 +832,8 @@ assemble_completion_to_well(int i, int w, int c, int nc, int np,
 
     /* Assemble completion contributions */
     wdof = nc + w;
-    jc   = csrmatrix_elm_index(wdof, c   , h->J);
-    jw   = csrmatrix_elm_index(wdof, wdof, h->J);
+    jc   = h->pimpl->wc_ix  [ i    ];
+    jw   = h->pimpl->diag_ix[ wdof ];
 
     h->F    [ wdof ] += dt * res;
     h->J->sa[ jc   ] += dt * w2c;
@@ -947,7 +885,7 @@ assemble_well_contrib(struct cfs_tpfa_res_wells   *wells ,
             init_completion_contrib(i, np, Ac, dAc, h->pimpl);
 
             if (is_open) {
-                assemble_completion_to_cell(c, nc + w, np, dt, h);
+                assemble_completion_to_cell(i, c, nc + w, np, dt, h);
             }
 
             /* Prepare for RESV controls */
@@ -955,7 +893,7 @@ assemble_well_contrib(struct cfs_tpfa_res_wells   *wells ,
                                         h->pimpl->flux_work,
                                         h->pimpl->flux_work + np);
 
-            assemble_completion_to_well(i, w, c, nc, np, pw, dt, wells, h);
+            assemble_completion_to_well(i, w, nc, np, pw, dt, wells, h);
         }
 
         ctrl = W->ctrls[ w ];
@@ -1170,13 +1108,15 @@ cfs_tpfa_res_construct(struct UnstructuredGrid   *G      ,
 /* ---------------------------------------------------------------------- */
 {
     size_t                    nf, nwperf;
+    struct Wells             *W;
     struct cfs_tpfa_res_data *h;
 
+    W = (wells != NULL) ? wells->W : NULL;
     h = malloc(1 * sizeof *h);
 
     if (h != NULL) {
         h->pimpl = impl_allocate(G, wells, maxconn(G), nphases);
-        h->J     = construct_matrix(G, wells);
+        h->J     = cell_graph_matrix_construct(G, W);
 
         if ((h->pimpl == NULL) || (h->J == NULL)) {
             cfs_tpfa_res_destroy(h);
@@ -1209,6 +1149,8 @@ cfs_tpfa_res_construct(struct UnstructuredGrid   *G      ,
 
         h->pimpl->scratch_f        =
             h->pimpl->flux_work                      + (nphases * (1 + 2));
+
+        impl_set_indices(G, wells, h->J, h->pimpl);
     }
 
     return h;
@@ -1322,7 +1264,7 @@ cfs_tpfa_res_comprock_assemble(
     /* Add new terms to residual and Jacobian. */
     rock_is_incomp = 1;
     for (c = 0; c < G->number_of_cells; c++) {
-        j = csrmatrix_elm_index(c, c, h->J);
+        j = h->pimpl->diag_ix[ c ];
 
         dpv = (porevol[c] - porevol0[c]);
         if (dpv != 0.0 || rock_comp[c] != 0.0) {
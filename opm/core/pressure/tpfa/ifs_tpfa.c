@@ -10,6 +10,7 @@
 #include <opm/core/wells.h>
 #include <opm/core/well_controls.h>
 #include <opm/core/pressure/flow_bc.h>
+#include <opm/core/pressure/tpfa/cell_graph_matrix.h>
 #include <opm/core/pressure/tpfa/ifs_tpfa.h>
 
 
@@ -37,8 +38,15 @@ struct ifs_tpfa_impl {
     double *fgrav;              /* Accumulated grav contrib/face */
     double *work;
 
+    /* Non-zero indices into A->sa, computed once at construction */
+    int    *diag_ix;            /* (i,i) for all unknowns */
+    int    *hf_ix;              /* (c,c2) per half-face, -1 if no c2 */
+    int    *cw_ix;              /* (c,w) per perforation */
+    int    *wc_ix;              /* (w,c) per perforation */
+
     /* Linear storage */
     double *ddata;
+    int    *idata;
 };
 
 
@@ -48,6 +56,7 @@ impl_deallocate(struct ifs_tpfa_impl *pimpl)
 /* ---------------------------------------------------------------------- */
 {
     if (pimpl != NULL) {
+        free(pimpl->idata);
         free(pimpl->ddata);
     }
 
@@ -63,26 +72,39 @@ impl_allocate(struct UnstructuredGrid *G,
 {
     struct ifs_tpfa_impl *new;
 
-    size_t nnu;
-    size_t ddata_sz;
+    size_t nnu, nhf, nperf;
+    size_t ddata_sz, idata_sz;
 
-    nnu = G->number_of_cells;
+    nnu   = G->number_of_cells;
+    nhf   = G->cell_facepos[ G->number_of_cells ];
+    nperf = 0;
     if (W != NULL) {
-        nnu += W->number_of_wells;
+        nnu   += W->number_of_wells;
+        nperf  = W->well_connpos[ W->number_of_wells ];
     }
 
     ddata_sz  = 2 * nnu;                 /* b, x */
     ddata_sz += 1 * G->number_of_faces;  /* fgrav */
     ddata_sz += 1 * nnu;                 /* work */
 
+    idata_sz  = 1 * nnu;                 /* diag_ix */
+    idata_sz += 1 * nhf;                 /* hf_ix */
+    idata_sz += 2 * nperf;               /* cw_ix, wc_ix */
+
     new = malloc(1 * sizeof *new);
 
     if (new != NULL) {
         new->ddata = malloc(ddata_sz * sizeof *new->ddata);
+        new->idata = malloc(idata_sz * sizeof *new->idata);
 
-        if (new->ddata == NULL) {
+        if ((new->ddata == NULL) || (new->idata == NULL)) {
             impl_deallocate(new);
             new = NULL;
+        } else {
+            new->diag_ix = new->idata;
+            new->hf_ix   = new->diag_ix + nnu;
+            new->cw_ix   = new->hf_ix   + nhf;
+            new->wc_ix   = new->cw_ix   + nperf;
         }
     }
 
@@ -90,96 +112,47 @@ impl_allocate(struct UnstructuredGrid *G,
 }
 
 
+/* Look up the non-zero index of every matrix element touched by
+ * assembly once, so that assembly itself is a direct scatter. */
 /* ---------------------------------------------------------------------- */
-static struct CSRMatrix *
-ifs_tpfa_construct_matrix(struct UnstructuredGrid *G,
-                          struct Wells            *W)
+static void
+impl_set_indices(struct UnstructuredGrid *G    ,
+                 struct Wells            *W    ,
+                 const struct CSRMatrix  *A    ,
+                 struct ifs_tpfa_impl    *pimpl)
 /* ---------------------------------------------------------------------- */
 {
-    int    f, c1, c2, w, i, nc, nnu;
-    size_t nnz;
-
-    struct CSRMatrix *A;
-
-    nc = nnu = G->number_of_cells;
-    if (W != NULL) {
-        nnu += W->number_of_wells;
-    }
-
-    A = csrmatrix_new_count_nnz(nnu);
-
-    if (A != NULL) {
-        /* Self connections */
-        for (c1 = 0; c1 < nnu; c1++) {
-            A->ia[ c1 + 1 ] = 1;
-        }
-
-        /* Other connections */
-        for (f = 0; f < G->number_of_faces; f++) {
-            c1 = G->face_cells[2*f + 0];
-            c2 = G->face_cells[2*f + 1];
-
-            if ((c1 >= 0) && (c2 >= 0)) {
-                A->ia[ c1 + 1 ] += 1;
-                A->ia[ c2 + 1 ] += 1;
-            }
-        }
+    int c, c1, c2, f, i, w, nc;
 
-        if (W != NULL) {
-            /* Well <-> cell connections */
-            for (w = i = 0; w < W->number_of_wells; w++) {
-                for (; i < W->well_connpos[w + 1]; i++) {
-                    c1 = W->well_cells[i];
+    assert (csrmatrix_rows_sorted(A));
 
-                    A->ia[ 0  + c1 + 1 ] += 1; /* c -> w */
-                    A->ia[ nc + w  + 1 ] += 1; /* w -> c */
-                }
-            }
-        }
+    nc = G->number_of_cells;
 
-        nnz = csrmatrix_new_elms_pushback(A);
-        if (nnz == 0) {
-            csrmatrix_delete(A);
-            A = NULL;
-        }
+    for (i = 0; i < (int) A->m; i++) {
+        pimpl->diag_ix[ i ] = (int) csrmatrix_elm_index(i, i, A);
     }
 
-    if (A != NULL) {
-        /* Fill self connections */
-        for (i = 0; i < nnu; i++) {
-            A->ja[ A->ia[ i + 1 ] ++ ] = i;
-        }
-
-        /* Fill other connections */
-        for (f = 0; f < G->number_of_faces; f++) {
+    for (c = i = 0; c < nc; c++) {
+        for (; i < G->cell_facepos[c + 1]; i++) {
+            f  = G->cell_faces[i];
             c1 = G->face_cells[2*f + 0];
             c2 = G->face_cells[2*f + 1];
+            c2 = (c1 == c) ? c2 : c1;
 
-            if ((c1 >= 0) && (c2 >= 0)) {
-                A->ja[ A->ia[ c1 + 1 ] ++ ] = c2;
-                A->ja[ A->ia[ c2 + 1 ] ++ ] = c1;
-            }
+            pimpl->hf_ix[ i ] = (c2 >= 0) ? (int) csrmatrix_elm_index(c, c2, A) : -1;
         }
+    }
 
-        if (W != NULL) {
-            /* Fill well <-> cell connections */
-            for (w = i = 0; w < W->number_of_wells; w++) {
-                for (; i < W->well_connpos[w + 1]; i++) {
-                    c1 = W->well_cells[i];
+    if (W != NULL) {
+        for (w = i = 0; w < W->number_of_wells; w++) {
+            for (; i < W->well_connpos[w + 1]; i++) {
+                c = W->well_cells[i];
 
-                    A->ja[ A->ia[ 0  + c1 + 1 ] ++ ] = nc + w;
-                    A->ja[ A->ia[ nc + w  + 1 ] ++ ] = c1    ;
-                }
+                pimpl->cw_ix[ i ] = (int) csrmatrix_elm_index(c     , nc + w, A);
+                pimpl->wc_ix[ i ] = (int) csrmatrix_elm_index(nc + w, c     , A);
             }
         }
-
-        assert ((size_t) A->ia[ nnu ] == nnz);
-
-        /* Guarantee sorted rows */
-        csrmatrix_sortrows(A);
     }
-
-    return A;
 }
 
 
@@ -232,14 +205,14 @@ assemble_bhp_well(int nc, int w,
     wdof  = nc + w;
     bhp   = well_controls_get_current_target(ctrls);
 
-    jw    = csrmatrix_elm_index(wdof, wdof, h->A);
+    jw    = h->pimpl->diag_ix[ wdof ];
 
     for (i = W->well_connpos[w]; i < W->well_connpos[w + 1]; i++) {
 
         c     = W->well_cells  [ i ];
         trans = mt[ c ] * W->WI[ i ];
 
-        jc = csrmatrix_elm_index(c, c, h->A);
+        jc = h->pimpl->diag_ix[ c ];
 
         /* c<->c diagonal contribution from well */
         h->A->sa[ jc   ] += trans;
@@ -271,15 +244,15 @@ assemble_rate_well(int nc, int w,
     wdof  = nc + w;
     resv  = well_controls_get_current_target(ctrls);
 
-    jww   = csrmatrix_elm_index(wdof, wdof, h->A);
+    jww   = h->pimpl->diag_ix[ wdof ];
 
     for (i = W->well_connpos[w]; i < W->well_connpos[w + 1]; i++) {
 
         c   = W->well_cells[ i ];
 
-        jcc = csrmatrix_elm_index(c   , c   , h->A);
-        jcw = csrmatrix_elm_index(c   , wdof, h->A);
-        jwc = csrmatrix_elm_index(wdof, c   , h->A);
+        jcc = h->pimpl->diag_ix[ c ];
+        jcw = h->pimpl->cw_ix  [ i ];
+        jwc = h->pimpl->wc_ix  [ i ];
 
         /* Connection transmissibility */
         trans = mt[ c ] * W->WI[ i ];
@@ -326,7 +299,7 @@ assemble_shut_well(int nc, int w,
 
     wdof  = nc + w;
 
-    jw    = csrmatrix_elm_index(wdof, wdof, h->A);
+    jw    = h->pimpl->diag_ix[ wdof ];
 
     for (i = W->well_connpos[w]; i < W->well_connpos[w + 1]; i++) {
 
@@ -448,7 +421,7 @@ assemble_bc_contrib(struct UnstructuredGrid             *G    ,
                 t  = trans[ f ];
                 s  = 2.0*is_outflow - 1.0;
                 c1 = is_outflow ? c1 : c2;
-                ix = csrmatrix_elm_index(c1, c1, h->A);
+                ix = h->pimpl->diag_ix[ c1 ];
 
                 h->A->sa[ ix ] += t;
                 h->b    [ c1 ] += t * bc->value[ i ];
@@ -605,7 +578,7 @@ assemble_incompressible(struct UnstructuredGrid      *G     ,
     compute_grav_term(G, gpress, h->pimpl->fgrav);
 
     for (c = i = 0; c < G->number_of_cells; c++) {
-        j1 = csrmatrix_elm_index(c, c, h->A);
+        j1 = h->pimpl->diag_ix[ c ];
 
         for (; i < G->cell_facepos[c + 1]; i++) {
             f = G->cell_faces[i];
@@ -619,7 +592,7 @@ assemble_incompressible(struct UnstructuredGrid      *G     ,
             h->b[c] -= trans[f] * (s * h->pimpl->fgrav[f]);
 
             if (c2 >= 0) {
-                j2 = csrmatrix_elm_index(c, c2, h->A);
+                j2 = h->pimpl->hf_ix[ i ];
 
                 h->A->sa[j1] += trans[f];
                 h->A->sa[j2] -= trans[f];
@@ -677,7 +650,7 @@ ifs_tpfa_construct(struct UnstructuredGrid *G,
 
     if (new != NULL) {
         new->pimpl = impl_allocate(G, W);
-        new->A     = ifs_tpfa_construct_matrix(G, W);
+        new->A     = cell_graph_matrix_construct(G, W);
 
         if ((new->pimpl == NULL) || (new->A == NULL)) {
             ifs_tpfa_destroy(new);
@@ -691,6 +664,8 @@ ifs_tpfa_construct(struct UnstructuredGrid *G,
 
         new->pimpl->fgrav = new->x            + new->A->m;
         new->pimpl->work  = new->pimpl->fgrav + G->number_of_faces;
+
+        impl_set_indices(G, W, new->A, new->pimpl);
     }
 
     return new;
@@ -748,7 +723,7 @@ ifs_tpfa_assemble_comprock(struct UnstructuredGrid      *G        ,
      */
     if (ok) {
         for (c = 0; c < G->number_of_cells; c++) {
-            j = csrmatrix_elm_index(c, c, h->A);
+            j = h->pimpl->diag_ix[ c ];
 
             d = porevol[c] * rock_comp[c] / dt;
 
@@ -792,7 +767,7 @@ ifs_tpfa_assemble_comprock_increment(struct UnstructuredGrid      *G        ,
         mult_csr_matrix(h->A, prev_pressure, v);
 
         for (c = 0; c < G->number_of_cells; c++) {
-            j = csrmatrix_elm_index(c, c, h->A);
+            j = h->pimpl->diag_ix[ c ];
 
             dpvdt = (porevol[c] - initial_porevolume[c]) / dt;
 
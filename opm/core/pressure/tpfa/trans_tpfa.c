@@ -4,7 +4,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include <opm/core/linalg/blas_lapack.h>
 #include <opm/core/pressure/tpfa/trans_tpfa.h>
 
 
@@ -12,6 +11,27 @@
 #include "TransTpfa.hpp"
 #endif
 
+/* ---------------------------------------------------------------------- */
+/* Whether all off-diagonal entries of d-by-d tensor K are zero. */
+/* ---------------------------------------------------------------------- */
+static int
+is_diagonal(int d, const double *K)
+/* ---------------------------------------------------------------------- */
+{
+    int i, j;
+
+    for (i = 0; i < d; i++) {
+        for (j = 0; j < d; j++) {
+            if ((i != j) && (K[i + j*d] != 0.0)) {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+
 /* ---------------------------------------------------------------------- */
 /* htrans <- sum(C(:,i) .* K(cellNo,:) .* N(:,j), 2) ./ sum(C.*C, 2) */
 /* ---------------------------------------------------------------------- */
@@ -22,82 +42,117 @@ tpfa_htrans_compute(struct UnstructuredGrid *G, const double *perm, double *htra
     #ifdef __cplusplus
     return tpfa_htrans_compute<UnstructuredGrid>(G, totmob, htrans, trans);
     #endif
-    
-    int    c, d, f, i, j;
-    double s, dist, denom;
 
-    double Kn[3];
-    double *cc, *fc, *n;
-    const double *K;
-
-    MAT_SIZE_T nrows, ncols, ldA, incx, incy;
-    double a1, a2;
+    int c, d;
 
     d = G->dimensions;
 
-    nrows = ncols    = ldA = d;
-    incx  = incy     = 1      ;
-    a1    = 1.0;  a2 = 0.0    ;
+    /* Each cell writes its own half-faces only. */
+#pragma omp parallel for schedule(static)
+    for (c = 0; c < G->number_of_cells; c++) {
+        int    i, j, k, f, diag;
+        double s, dist, num, denom;
+
+        double Kn[3];
+        const double *cc, *fc, *n, *K;
 
-    for (c = i = 0; c < G->number_of_cells; c++) {
-        K  = perm + (c * d * d);
-        cc = G->cell_centroids + (c * d);
+        K    = perm + (c * d * d);
+        cc   = G->cell_centroids + (c * d);
+        diag = is_diagonal(d, K);
 
-        for (; i < G->cell_facepos[c + 1]; i++) {
+        for (i = G->cell_facepos[c]; i < G->cell_facepos[c + 1]; i++) {
             f = G->cell_faces[i];
             s = 2.0*(G->face_cells[2*f + 0] == c) - 1.0;
 
             n  = G->face_normals   + (f * d);
             fc = G->face_centroids + (f * d);
 
-            dgemv_("No Transpose", &nrows, &ncols,
-                   &a1, K, &ldA, n, &incx, &a2, &Kn[0], &incy);
+            /* Kn <- K*n, K in column major order. */
+            if (diag) {
+                for (j = 0; j < d; j++) {
+                    Kn[j] = K[j*(d + 1)] * n[j];
+                }
+            } else {
+                for (j = 0; j < d; j++) {
+                    Kn[j] = 0.0;
+                    for (k = 0; k < d; k++) {
+                        Kn[j] += K[j + k*d] * n[k];
+                    }
+                }
+            }
 
-            htrans[i] = denom = 0.0;
+            num = denom = 0.0;
             for (j = 0; j < d; j++) {
                 dist = fc[j] - cc[j];
 
-                htrans[i] += s * dist * Kn[j];
-                denom     +=     dist * dist;
+                num   += s * dist * Kn[j];
+                denom +=     dist * dist;
             }
 
             assert (denom > 0);
-            htrans[i] /= denom;
-            htrans[i]  = fabs(htrans[i]);
+            htrans[i] = fabs(num / denom);
         }
     }
 }
 
 
 /* ---------------------------------------------------------------------- */
-void
-tpfa_trans_compute(struct UnstructuredGrid *G, const double *htrans, double *trans)
+/* trans <- 1 ./ accumarray(cellFaces, 1 ./ (totmob(cellNo) .* htrans)),
+ * with totmob = 1 if NULL.  A face has at most two half-faces, and a
+ * sum of two terms does not depend on their order, so the concurrent
+ * accumulation gives the same result as a serial one. */
+/* ---------------------------------------------------------------------- */
+static void
+accumulate_trans(struct UnstructuredGrid *G,
+                 const double            *totmob,
+                 const double            *htrans,
+                 double                  *trans)
 /* ---------------------------------------------------------------------- */
 {
-    #ifdef __cplusplus
-    return tpfa_trans_compute<UnstructuredGrid>(G, totmob, htrans, trans);
-    #endif
-    
-    int c, i, f;
+    int c, f;
 
-    for (f = 0; f < G->number_of_faces; f++) {
-        trans[f] = 0.0;
-    }
+#pragma omp parallel
+    {
+#pragma omp for schedule(static)
+        for (f = 0; f < G->number_of_faces; f++) {
+            trans[f] = 0.0;
+        }
 
-    for (c = i = 0; c < G->number_of_cells; c++) {
-        for (; i < G->cell_facepos[c + 1]; i++) {
-            f = G->cell_faces[i];
+#pragma omp for schedule(static)
+        for (c = 0; c < G->number_of_cells; c++) {
+            int    i;
+            double t;
 
-            trans[f] += 1.0 / htrans[i];
+            for (i = G->cell_facepos[c]; i < G->cell_facepos[c + 1]; i++) {
+                t = (totmob != NULL) ? 1.0 / (totmob[c] * htrans[i])
+                    :                  1.0 / htrans[i];
+
+#pragma omp atomic
+                trans[G->cell_faces[i]] += t;
+            }
         }
-    }
 
-    for (f = 0; f < G->number_of_faces; f++) {
-        trans[f] = 1.0 / trans[f];
+#pragma omp for schedule(static)
+        for (f = 0; f < G->number_of_faces; f++) {
+            trans[f] = 1.0 / trans[f];
+        }
     }
 }
 
 
+/* ---------------------------------------------------------------------- */
+void
+tpfa_trans_compute(struct UnstructuredGrid *G, const double *htrans, double *trans)
+/* ---------------------------------------------------------------------- */
+{
+    #ifdef __cplusplus
+    return tpfa_trans_compute<UnstructuredGrid>(G, totmob, htrans, trans);
+    #endif
+
+    accumulate_trans(G, NULL, htrans, trans);
+}
+
+
 /* ---------------------------------------------------------------------- */
 void
 tpfa_eff_trans_compute(struct UnstructuredGrid       *G,
@@ -109,22 +164,6 @@ tpfa_eff_trans_compute(struct UnstructuredGrid       *G,
     #ifdef __cplusplus
     return tpfa_eff_trans_compute<UnstructuredGrid>(G, totmob, htrans, trans);
     #endif
-    
-    int c, i, f;
-
-    for (f = 0; f < G->number_of_faces; f++) {
-        trans[f] = 0.0;
-    }
 
-    for (c = i = 0; c < G->number_of_cells; c++) {
-        for (; i < G->cell_facepos[c + 1]; i++) {
-            f = G->cell_faces[i];
-
-            trans[f] += 1.0 / (totmob[c] * htrans[i]);
-        }
-    }
-
-    for (f = 0; f < G->number_of_faces; f++) {
-        trans[f] = 1.0 / trans[f];
-    }
+    accumulate_trans(G, totmob, htrans, trans);
 }
@@ -29,6 +29,25 @@
 
 namespace Opm
 {
+    namespace
+    {
+        // Work arrays for matrix() and viscosity(). They are kept per
+        // thread, so that properties may be evaluated concurrently.
+        struct PvtScratch
+        {
+            std::vector<double> B;
+            std::vector<double> dB;
+            std::vector<double> R;
+            std::vector<double> dR;
+        };
+
+        PvtScratch& pvtScratch()
+        {
+            thread_local PvtScratch scratch;
+            return scratch;
+        }
+    } // anonymous namespace
+
     BlackoilPropertiesFromDeck::BlackoilPropertiesFromDeck(const Opm::Deck& deck,
                                                            const Opm::EclipseState& eclState,
                                                            const UnstructuredGrid& grid,
@@ -254,8 +273,9 @@ namespace Opm
 
         pEval.setDerivative(0, 1.0);
 
-        R_.resize(n*np);
-        this->compute_R_(n, p, T, z, cells, &R_[0]);
+        PvtScratch& scratch = pvtScratch();
+        scratch.R.resize(n*np);
+        this->compute_R_(n, p, T, z, cells, &scratch.R[0]);
 
         for (int i = 0; i < n; ++ i) {
             int cellIdx = cells[i];
@@ -271,7 +291,7 @@ namespace Opm
             }
 
             if (pu.phase_used[BlackoilPhases::Liquid]) {
-                RsEval.setValue(R_[i*np + pu.phase_pos[BlackoilPhases::Liquid]]);
+                RsEval.setValue(scratch.R[i*np + pu.phase_pos[BlackoilPhases::Liquid]]);
                 muEval = oilPvt_.viscosity(pvtRegionIdx, TEval, pEval, RsEval);
                 int offset = pu.num_phases*cellIdx + pu.phase_pos[BlackoilPhases::Liquid];
                 mu[offset] = muEval.value();
@@ -279,7 +299,7 @@ namespace Opm
             }
 
             if (pu.phase_used[BlackoilPhases::Vapour]) {
-                RvEval.setValue(R_[i*np + pu.phase_pos[BlackoilPhases::Vapour]]);
+                RvEval.setValue(scratch.R[i*np + pu.phase_pos[BlackoilPhases::Vapour]]);
                 muEval = gasPvt_.viscosity(pvtRegionIdx, TEval, pEval, RvEval);
                 int offset = pu.num_phases*cellIdx + pu.phase_pos[BlackoilPhases::Vapour];
                 mu[offset] = muEval.value();
@@ -309,17 +329,18 @@ namespace Opm
     {
         const int np = numPhases();
 
-        B_.resize(n*np);
-        R_.resize(n*np);
+        PvtScratch& scratch = pvtScratch();
+        scratch.B.resize(n*np);
+        scratch.R.resize(n*np);
         if (dAdp) {
-            dB_.resize(n*np);
-            dR_.resize(n*np);
+            scratch.dB.resize(n*np);
+            scratch.dR.resize(n*np);
 
-            this->compute_dBdp_(n, p, T, z, cells, &B_[0], &dB_[0]);
-            this->compute_dRdp_(n, p, T, z, cells, &R_[0], &dR_[0]);
+            this->compute_dBdp_(n, p, T, z, cells, &scratch.B[0], &scratch.dB[0]);
+            this->compute_dRdp_(n, p, T, z, cells, &scratch.R[0], &scratch.dR[0]);
         } else {
-            this->compute_B_(n, p, T, z, cells, &B_[0]);
-            this->compute_R_(n, p, T, z, cells, &R_[0]);
+            this->compute_B_(n, p, T, z, cells, &scratch.B[0]);
+            this->compute_R_(n, p, T, z, cells, &scratch.R[0]);
         }
         const auto& pu = phaseUsage();
         bool oil_and_gas = pu.phase_used[BlackoilPhases::Liquid] &&
@@ -334,12 +355,12 @@ namespace Opm
             std::fill(m, m + np*np, 0.0);
             // Diagonal entries.
             for (int phase = 0; phase < np; ++phase) {
-                m[phase + phase*np] = 1.0/B_[i*np + phase];
+                m[phase + phase*np] = 1.0/scratch.B[i*np + phase];
             }
             // Off-diagonal entries.
             if (oil_and_gas) {
-                m[o + g*np] = R_[i*np + g]/B_[i*np + g];
-                m[g + o*np] = R_[i*np + o]/B_[i*np + o];
+                m[o + g*np] = scratch.R[i*np + g]/scratch.B[i*np + g];
+                m[g + o*np] = scratch.R[i*np + o]/scratch.B[i*np + o];
             }
         }
 
@@ -361,7 +382,7 @@ namespace Opm
                 double*       m  = dAdp + i*np*np;
 
                 // (2): dA/dp <- -dA/dp*(dB/dp) == -A*(dB/dp)
-                const double* dB = & dB_[i * np];
+                const double* dB = & scratch.dB[i * np];
                 for (int col = 0; col < np; ++col) {
                     for (int row = 0; row < np; ++row) {
                         m[col*np + row] *= - dB[ col ]; // Note sign.
@@ -370,14 +391,14 @@ namespace Opm
 
                 if (oil_and_gas) {
                     // (2b): dA/dp += dR/dp (== dR/dp - A*(dB/dp))
-                    const double* dR = & dR_[i * np];
+                    const double* dR = & scratch.dR[i * np];
 
                     m[o*np + g] += dR[ o ];
                     m[g*np + o] += dR[ g ];
                 }
 
                 // (3): dA/dp *= inv(B) (== final result)
-                const double* B = & B_[i * np];
+                const double* B = & scratch.B[i * np];
                 for (int col = 0; col < np; ++col) {
                     for (int row = 0; row < np; ++row) {
                         m[col*np + row] /= B[ col ];
@@ -316,10 +316,6 @@ namespace Opm
         std::shared_ptr<MaterialLawManager> materialLawManager_;
         std::shared_ptr<SaturationPropsInterface> satprops_;
         std::vector<double> surfaceDensities_;
-        mutable std::vector<double> B_;
-        mutable std::vector<double> dB_;
-        mutable std::vector<double> R_;
-        mutable std::vector<double> dR_;
     };
 
 
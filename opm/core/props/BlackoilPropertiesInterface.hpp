@@ -34,6 +34,12 @@ namespace Opm
     /// ordered cellwise:
     ///   [s^1_0 s^2_0 s^3_0 s^1_1 s^2_2 ... ]
     /// in which s^i_j denotes saturation of phase i in cell j.
+    ///
+    /// The const methods may be called concurrently from several
+    /// threads, as is done by the equilibration code in
+    /// initStateEquil(), so implementations must not modify shared
+    /// state in them. swatInitScaling() is only called from one
+    /// thread at a time.
     class BlackoilPropertiesInterface
     {
     public:
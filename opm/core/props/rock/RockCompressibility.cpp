@@ -28,6 +28,7 @@
 #include <opm/parser/eclipse/EclipseState/Tables/RocktabTable.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 namespace Opm
@@ -138,5 +139,48 @@ namespace Opm
         }
     }
 
+    void RockCompressibility::poroMult(const int n, const double* pressure,
+                                       double* mult, double* dmultdp) const
+    {
+        if (p_.empty()) {
+            for (int i = 0; i < n; ++i) {
+                const double cpnorm = rock_comp_*(pressure[i] - pref_);
+                mult[i] = 1.0 + cpnorm + 0.5*cpnorm*cpnorm;
+                if (dmultdp) {
+                    dmultdp[i] = rock_comp_ + cpnorm*rock_comp_;
+                }
+            }
+        } else {
+            Opm::linearInterpolation(p_, poromult_, n, pressure, mult, dmultdp);
+        }
+    }
+
+    void RockCompressibility::transMult(const int n, const double* pressure,
+                                        double* mult, double* dmultdp) const
+    {
+        if (p_.empty()) {
+            std::fill(mult, mult + n, 1.0);
+            if (dmultdp) {
+                std::fill(dmultdp, dmultdp + n, 0.0);
+            }
+        } else {
+            Opm::linearInterpolation(p_, transmult_, n, pressure, mult, dmultdp);
+        }
+    }
+
+    void RockCompressibility::rockComp(const int n, const double* pressure,
+                                       double* rock_comp) const
+    {
+        if (p_.empty()) {
+            std::fill(rock_comp, rock_comp + n, rock_comp_);
+        } else {
+            std::vector<double> poromult(n);
+            Opm::linearInterpolation(p_, poromult_, n, pressure, poromult.data(), rock_comp);
+            for (int i = 0; i < n; ++i) {
+                rock_comp[i] /= poromult[i];
+            }
+        }
+    }
+
 } // namespace Opm
 
@@ -61,6 +61,20 @@ namespace Opm
         /// Rock compressibility = (d poro / d p)*(1 / poro).
         double rockComp(double pressure) const;
 
+        /// Porosity multipliers for n pressures, and their
+        /// derivatives with respect to pressure if dmultdp is not null.
+        void poroMult(const int n, const double* pressure,
+                      double* mult, double* dmultdp) const;
+
+        /// Transmissibility multipliers for n pressures, and their
+        /// derivatives with respect to pressure if dmultdp is not null.
+        void transMult(const int n, const double* pressure,
+                       double* mult, double* dmultdp) const;
+
+        /// Rock compressibilities for n pressures.
+        void rockComp(const int n, const double* pressure,
+                      double* rock_comp) const;
+
     private:
         std::vector<double> p_;
         std::vector<double> poromult_;
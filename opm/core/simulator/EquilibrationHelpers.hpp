@@ -28,7 +28,13 @@
 
 #include <opm/parser/eclipse/EclipseState/InitConfig/Equil.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <exception>
+#include <map>
 #include <memory>
+#include <vector>
 
 
 /*
@@ -62,6 +68,7 @@ namespace Opm
                                 const int cell,
                                 const double target_pc,
                                 const bool increasing = false);
+        class InversePcTables;
         struct PcEqSum
         inline double satFromSumOfPcs(const BlackoilPropertiesInterface& props,
                                       const int phase1,
@@ -77,6 +84,38 @@ namespace Opm
 
 namespace Opm
 {
+    namespace Details {
+        /// Call body(i) for all i in [0, n), in parallel when OpenMP
+        /// is enabled. Exceptions must not escape a parallel region,
+        /// so an exception thrown by body is caught and rethrown after
+        /// the loop. If several iterations throw, the exception of the
+        /// lowest index is rethrown, as in a serial loop.
+        template <class Body>
+        void parallelFor(const int n, const int chunk, const Body& body)
+        {
+            std::exception_ptr error;
+            int error_index = n;
+#pragma omp parallel for schedule(dynamic, chunk) if (n > 1)
+            for (int i = 0; i < n; ++i) {
+                try {
+                    body(i);
+                } catch (...) {
+#pragma omp critical
+                    {
+                        if (i < error_index) {
+                            error_index = i;
+                            error = std::current_exception();
+                        }
+                    }
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    } // namespace Details
+
+
     /**
      * Types and routines that collectively implement a basic
      * ECLIPSE-style equilibration-based initialisation scheme.
@@ -283,18 +322,19 @@ namespace Opm
                 std::vector<double> depth_; /**< Depth nodes */
                 std::vector<double> rs_;    /**< Dissolved gas-oil ratio */
                 double z_[BlackoilPhases::MaxNumPhases];
-                mutable double A_[BlackoilPhases::MaxNumPhases * BlackoilPhases::MaxNumPhases];
 
                 double satRs(const double press, const double temp) const
                 {
-                    props_.matrix(1, &press, &temp, z_, &cell_, A_, 0);
-                    // Rs/Bo is in the gas row and oil column of A_.
+                    // Local matrix, so that the function may be evaluated concurrently.
+                    double A[BlackoilPhases::MaxNumPhases * BlackoilPhases::MaxNumPhases];
+                    props_.matrix(1, &press, &temp, z_, &cell_, A, 0);
+                    // Rs/Bo is in the gas row and oil column of A.
                     // 1/Bo is in the oil row and column.
                     // Recall also that it is stored in column-major order.
                     const int opos = props_.phaseUsage().phase_pos[BlackoilPhases::Liquid];
                     const int gpos = props_.phaseUsage().phase_pos[BlackoilPhases::Vapour];
                     const int np = props_.numPhases();
-                    return A_[np*opos + gpos] / A_[np*opos + opos];
+                    return A[np*opos + gpos] / A[np*opos + opos];
                 }
             };
 
@@ -363,18 +403,18 @@ namespace Opm
                 std::vector<double> depth_; /**< Depth nodes */
                 std::vector<double> rv_;    /**< Vaporized oil-gas ratio */
                 double z_[BlackoilPhases::MaxNumPhases];
-                mutable double A_[BlackoilPhases::MaxNumPhases * BlackoilPhases::MaxNumPhases];
 
                 double satRv(const double press, const double temp) const
                 {
-                    props_.matrix(1, &press, &temp, z_, &cell_, A_, 0);
-                    // Rv/Bg is in the oil row and gas column of A_.
+                    double A[BlackoilPhases::MaxNumPhases * BlackoilPhases::MaxNumPhases];
+                    props_.matrix(1, &press, &temp, z_, &cell_, A, 0);
+                    // Rv/Bg is in the oil row and gas column of A.
                     // 1/Bg is in the gas row and column.
                     // Recall also that it is stored in column-major order.
                     const int opos = props_.phaseUsage().phase_pos[BlackoilPhases::Liquid];
                     const int gpos = props_.phaseUsage().phase_pos[BlackoilPhases::Vapour];
                     const int np = props_.numPhases();
-                    return A_[np*gpos + opos] / A_[np*gpos + gpos];
+                    return A[np*gpos + opos] / A[np*gpos + gpos];
                 }
             };
 
@@ -446,18 +486,18 @@ namespace Opm
                 const int cell_;
                 double z_[BlackoilPhases::MaxNumPhases];
                 double rs_sat_contact_;
-                mutable double A_[BlackoilPhases::MaxNumPhases * BlackoilPhases::MaxNumPhases];
 
                 double satRs(const double press, const double temp) const
                 {
-                    props_.matrix(1, &press, &temp, z_, &cell_, A_, 0);
-                    // Rs/Bo is in the gas row and oil column of A_.
+                    double A[BlackoilPhases::MaxNumPhases * BlackoilPhases::MaxNumPhases];
+                    props_.matrix(1, &press, &temp, z_, &cell_, A, 0);
+                    // Rs/Bo is in the gas row and oil column of A.
                     // 1/Bo is in the oil row and column.
                     // Recall also that it is stored in column-major order.
                     const int opos = props_.phaseUsage().phase_pos[BlackoilPhases::Liquid];
                     const int gpos = props_.phaseUsage().phase_pos[BlackoilPhases::Vapour];
                     const int np = props_.numPhases();
-                    return A_[np*opos + gpos] / A_[np*opos + opos];
+                    return A[np*opos + gpos] / A[np*opos + opos];
                 }
             };
 
@@ -529,18 +569,18 @@ namespace Opm
                 const int cell_;
                 double z_[BlackoilPhases::MaxNumPhases];
                 double rv_sat_contact_;
-                mutable double A_[BlackoilPhases::MaxNumPhases * BlackoilPhases::MaxNumPhases];
 
                 double satRv(const double press, const double temp) const
                 {
-                    props_.matrix(1, &press, &temp, z_, &cell_, A_, 0);
-                    // Rv/Bg is in the oil row and gas column of A_.
+                    double A[BlackoilPhases::MaxNumPhases * BlackoilPhases::MaxNumPhases];
+                    props_.matrix(1, &press, &temp, z_, &cell_, A, 0);
+                    // Rv/Bg is in the oil row and gas column of A.
                     // 1/Bg is in the gas row and column.
                     // Recall also that it is stored in column-major order.
                     const int opos = props_.phaseUsage().phase_pos[BlackoilPhases::Liquid];
                     const int gpos = props_.phaseUsage().phase_pos[BlackoilPhases::Vapour];
                     const int np = props_.numPhases();
-                    return A_[np*gpos + opos] / A_[np*gpos + gpos];
+                    return A[np*gpos + opos] / A[np*gpos + gpos];
                 }
             };
 
@@ -744,6 +784,172 @@ namespace Opm
         }
 
 
+        /// Inverse capillary pressure tables for one phase, shared
+        /// between cells with the same capillary pressure curve.
+        ///
+        /// Cells in the same saturation region and with the same
+        /// end-point scaling have the same curve. The cells of a range
+        /// are grouped by saturation range and end-point capillary
+        /// pressures, and every group large enough to pay for it gets
+        /// a table of its curve at uniformly spaced saturations.
+        /// Inverting the capillary pressure of a cell in such a group
+        /// then costs a table lookup and a single evaluation of the
+        /// cell's own curve to confirm the result, and the root is
+        /// only refined, within one table interval, where the curve is
+        /// not linear between table nodes. Cells in small groups, and
+        /// in groups whose sampled curve is not monotone, use
+        /// satFromPc().
+        ///
+        /// All methods are safe to call concurrently once constructed.
+        class InversePcTables
+        {
+        public:
+            /// Group cells by curve and build the tables.
+            /// \param[in] props       Saturation properties.
+            /// \param[in] phase       Phase position of the saturation to find.
+            /// \param[in] increasing  As for satFromPc().
+            /// \param[in] cells       Range of cell indices.
+            template <class CellRange>
+            InversePcTables(const BlackoilPropertiesInterface& props,
+                            const int phase,
+                            const bool increasing,
+                            const CellRange& cells)
+                : props_(props),
+                  phase_(phase),
+                  increasing_(increasing),
+                  cells_(cells.begin(), cells.end()),
+                  curve_(cells_.size(), -1)
+            {
+                // The key of a curve is its saturation range, from the
+                // saturation of highest to that of lowest capillary
+                // pressure, and its capillary pressures at the ends.
+                const int ncells = cells_.size();
+                std::vector<Key> keys(ncells);
+                Details::parallelFor(ncells, 256, [&](const int i) {
+                    const int cell = cells_[i];
+                    double smin[BlackoilPhases::MaxNumPhases];
+                    double smax[BlackoilPhases::MaxNumPhases];
+                    props_.satRange(1, &cell, smin, smax);
+                    Key& key = keys[i];
+                    key[0] = increasing_ ? smax[phase_] : smin[phase_];
+                    key[1] = increasing_ ? smin[phase_] : smax[phase_];
+                    const PcEq f(props_, phase_, cell, 0.0);
+                    key[2] = f(key[0]);
+                    key[3] = f(key[1]);
+                });
+
+                std::map<Key, std::vector<int> > groups;
+                for (int i = 0; i < ncells; ++i) {
+                    groups[keys[i]].push_back(i);
+                }
+                for (const auto& group : groups) {
+                    if (group.second.size() < MinCellsPerTable) {
+                        continue;
+                    }
+                    Curve curve;
+                    curve.s0 = group.first[0];
+                    curve.s1 = group.first[1];
+                    curve.cell = cells_[group.second.front()];
+                    for (const int i : group.second) {
+                        curve_[i] = curves_.size();
+                    }
+                    curves_.push_back(curve);
+                }
+
+                Details::parallelFor(curves_.size(), 1, [&](const int c) {
+                    Curve& curve = curves_[c];
+                    const PcEq f(props_, phase_, curve.cell, 0.0);
+                    curve.pc.resize(NumNodes);
+                    for (int j = 0; j < NumNodes; ++j) {
+                        curve.pc[j] = f(nodeSat(curve, j));
+                    }
+                    // Lookups need pc non-increasing along the nodes.
+                    if (!std::is_sorted(curve.pc.rbegin(), curve.pc.rend())) {
+                        curve.pc.clear();
+                    }
+                });
+            }
+
+            /// Compute saturation corresponding to a given capillary
+            /// pressure, as satFromPc().
+            /// \param[in] local_index  Position of the cell in the range.
+            /// \param[in] target_pc    Capillary pressure.
+            double satFromPc(const int local_index, const double target_pc) const
+            {
+                const int cell = cells_[local_index];
+                const int c = curve_[local_index];
+                if (c < 0 || curves_[c].pc.empty()) {
+                    return EQUIL::satFromPc(props_, phase_, cell, target_pc, increasing_);
+                }
+                const Curve& curve = curves_[c];
+                const std::vector<double>& pc = curve.pc;
+                if (pc.front() - target_pc <= 0.0) {
+                    return curve.s0;
+                } else if (pc.back() - target_pc > 0.0) {
+                    return curve.s1;
+                }
+
+                // Interpolate in the table interval containing the root.
+                const int k = std::partition_point(pc.begin(), pc.end(),
+                                                   [target_pc](const double p) { return p > target_pc; })
+                    - pc.begin();
+                const double sa = nodeSat(curve, k - 1);
+                const double sb = nodeSat(curve, k);
+                const double fa = pc[k - 1] - target_pc;
+                const double fb = pc[k] - target_pc;
+                const double s = sa + (sb - sa)*fa/(fa - fb);
+
+                const PcEq f(props_, phase_, cell, target_pc);
+                const double tol = 1e-6;
+                const double fs = f(s);
+                if (std::fabs(fs) < tol) {
+                    return s;
+                }
+                // Refine on the cell's own curve. If that does not
+                // bracket the root, the cell's curve differs from the
+                // table between the end points.
+                const double so = fs > 0.0 ? sb : sa;
+                const double fo = f(so);
+                if ((fo > 0.0) == (fs > 0.0)) {
+                    return EQUIL::satFromPc(props_, phase_, cell, target_pc, increasing_);
+                }
+                const int max_iter = 60;
+                int iter_used = -1;
+                typedef RegulaFalsi<ThrowOnError> ScalarSolver;
+                return ScalarSolver::solve(f, std::min(s, so), std::max(s, so), max_iter, tol, iter_used);
+            }
+
+        private:
+            // Table size, and the number of cells needed to make up
+            // for building a table instead of finding their roots.
+            enum { NumNodes = 101, MinCellsPerTable = 16 };
+
+            typedef std::array<double, 4> Key;
+
+            struct Curve
+            {
+                double s0;              // Saturation of the first node.
+                double s1;              // Saturation of the last node.
+                int cell;               // Cell the table is sampled from.
+                std::vector<double> pc; // Capillary pressure at the nodes,
+                                        // empty if not monotone.
+            };
+
+            static double nodeSat(const Curve& curve, const int j)
+            {
+                return (j == NumNodes - 1) ? curve.s1
+                    : curve.s0 + (curve.s1 - curve.s0)*j/(NumNodes - 1);
+            }
+
+            const BlackoilPropertiesInterface& props_;
+            const int phase_;
+            const bool increasing_;
+            std::vector<int> cells_;
+            std::vector<int> curve_;
+            std::vector<Curve> curves_;
+        };
+
+
         /// Functor for inverting a sum of capillary pressure functions.
         /// Function represented is
         ///   f(s) = pc1(s) + pc2(1 - s) - target_pc
@@ -0,0 +1,74 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/simulator/SequentialSplittingStepper.hpp>
+#include <opm/core/pressure/IncompTpfa.hpp>
+#include <opm/core/props/IncompPropertiesInterface.hpp>
+#include <opm/core/simulator/TwophaseState.hpp>
+#include <opm/core/simulator/WellState.hpp>
+#include <opm/core/transport/reorder/TransportSolverTwophaseReorder.hpp>
+#include <opm/core/utility/Instrumentation.hpp>
+#include <opm/core/grid.h>
+
+namespace Opm
+{
+
+    /// Construct stepper.
+    SequentialSplittingStepper::SequentialSplittingStepper(const UnstructuredGrid& grid,
+                                                           const IncompPropertiesInterface& props,
+                                                           IncompTpfa& psolver,
+                                                           TransportSolverTwophaseReorder& tsolver,
+                                                           const Wells* wells,
+                                                           const std::vector<double>& src,
+                                                           const double inflow_frac)
+        : psolver_(psolver),
+          tsolver_(tsolver),
+          wells_(wells),
+          src_(src),
+          inflow_frac_(inflow_frac),
+          source_builder_(grid),
+          transport_src_(grid.number_of_cells, 0.0)
+    {
+        computePorevolume(grid, props.porosity(), porevol_);
+    }
+
+
+
+    /// Take one step of the given length.
+    void SequentialSplittingStepper::step(const double dt,
+                                          TwophaseState& state,
+                                          WellState& well_state)
+    {
+        OPM_TIMER_SCOPE("sequential splitting step");
+        psolver_.solve(dt, state, well_state);
+        source_builder_.compute(src_, state.faceflux(), inflow_frac_,
+                                wells_, well_state.perfRates(), transport_src_);
+        tsolver_.solve(&porevol_[0], &transport_src_[0], dt, state);
+    }
+
+
+
+    /// Transport source terms of the last step.
+    const std::vector<double>& SequentialSplittingStepper::transportSource() const
+    {
+        return transport_src_;
+    }
+
+} // namespace Opm
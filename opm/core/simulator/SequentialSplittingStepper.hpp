@@ -0,0 +1,93 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SEQUENTIALSPLITTINGSTEPPER_HEADER_INCLUDED
+#define OPM_SEQUENTIALSPLITTINGSTEPPER_HEADER_INCLUDED
+
+#include <opm/core/utility/miscUtilities.hpp>
+#include <vector>
+
+struct UnstructuredGrid;
+struct Wells;
+
+namespace Opm
+{
+
+    class IncompPropertiesInterface;
+    class IncompTpfa;
+    class TransportSolverTwophaseReorder;
+    class TwophaseState;
+    class WellState;
+
+    /// Advances an incompressible two-phase state by sequential
+    /// splitting: a pressure solve, followed by a reordering transport
+    /// solve driven by the resulting fluxes.
+    ///
+    /// The stepper owns everything that does not change from step to
+    /// step, namely the pore volumes, the boundary faces used for
+    /// the transport source terms, and the source term array. A step
+    /// therefore makes no allocations of its own, which matters when
+    /// many short runs are made on small models.
+    class SequentialSplittingStepper
+    {
+    public:
+        /// Construct stepper.
+        /// \param[in] grid          A 2d or 3d grid.
+        /// \param[in] props         Rock and fluid properties.
+        /// \param[in] psolver       Pressure solver, set up with the same
+        ///                          grid, wells and source terms.
+        /// \param[in] tsolver       Transport solver, set up with the same grid.
+        /// \param[in] wells         Wells data structure, or null if no wells.
+        /// \param[in] src           Pressure equation source terms, as given
+        ///                          to the pressure solver.
+        /// \param[in] inflow_frac   Fraction of inflow that consists of the first
+        ///                          phase, see computeTransportSource().
+        SequentialSplittingStepper(const UnstructuredGrid& grid,
+                                   const IncompPropertiesInterface& props,
+                                   IncompTpfa& psolver,
+                                   TransportSolverTwophaseReorder& tsolver,
+                                   const Wells* wells,
+                                   const std::vector<double>& src,
+                                   const double inflow_frac = 1.0);
+
+        /// Take one step of the given length.
+        /// \param[in]      dt           Time step.
+        /// \param[in, out] state        Reservoir state.
+        /// \param[in, out] well_state   Well state.
+        void step(const double dt,
+                  TwophaseState& state,
+                  WellState& well_state);
+
+        /// Transport source terms of the last step.
+        const std::vector<double>& transportSource() const;
+
+    private:
+        IncompTpfa& psolver_;
+        TransportSolverTwophaseReorder& tsolver_;
+        const Wells* wells_;
+        const std::vector<double>& src_;
+        double inflow_frac_;
+        std::vector<double> porevol_;
+        TransportSourceBuilder source_builder_;
+        std::vector<double> transport_src_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_SEQUENTIALSPLITTINGSTEPPER_HEADER_INCLUDED
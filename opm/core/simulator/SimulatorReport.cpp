@@ -19,6 +19,7 @@
 
 #include "config.h"
 #include <opm/core/simulator/SimulatorReport.hpp>
+#include <opm/core/utility/Instrumentation.hpp>
 #include <ostream>
 
 namespace Opm
@@ -160,5 +161,23 @@ namespace Opm
         }
     }
 
+    void SimulatorReport::reportInstrumentation(std::ostream& os, const bool chrome_trace)
+    {
+#if OPM_INSTRUMENTATION
+        if ( verbose_ )
+        {
+            const Instrumentation::Registry& registry = Instrumentation::Registry::instance();
+            if (chrome_trace) {
+                registry.writeChromeTrace(os);
+            } else {
+                registry.writeJson(os);
+            }
+        }
+#else
+        static_cast<void>(os);
+        static_cast<void>(chrome_trace);
+#endif
+    }
+
 
 } // namespace Opm
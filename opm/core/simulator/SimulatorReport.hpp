@@ -55,6 +55,11 @@ namespace Opm
         /// Print a report, leaving out the transport time.
         void reportFullyImplicit(std::ostream& os, const SimulatorReport* failedReport = nullptr);
         void reportParam(std::ostream& os);
+        /// Print the timing and counter tree collected by the solvers,
+        /// as JSON or, if chrome_trace is true, in the Chrome trace
+        /// event format. Prints nothing unless built with
+        /// OPM_INSTRUMENTATION.
+        void reportInstrumentation(std::ostream& os, const bool chrome_trace = false);
     private:
         // Whether to print statistics to std::cout
         bool verbose_;
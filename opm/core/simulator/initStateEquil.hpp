@@ -64,6 +64,10 @@ namespace Opm
      *   gasoilratio(),
      *   rv().
      *
+     * When OpenMP is enabled, the const methods of props are called
+     * concurrently from several threads, and must be thread safe.
+     * SWATINIT scaling is applied from one thread only.
+     *
      * \param[in] grid     Grid.
      * \param[in] props    Property object, pvt and capillary properties are used.
      * \param[in] deck     Simulation deck, used to obtain EQUIL and related data.
@@ -115,8 +119,9 @@ namespace Opm
          *                cells pertaining to the current
          *                equilibration region.  Must implement
          *                methods begin() and end() to bound the range
-         *                as well as provide an inner type,
-         *                const_iterator, to traverse the range.
+         *                and size() as well as provide an inner
+         *                random access iterator type, const_iterator,
+         *                to traverse the range.
          *
          * \param[in] G     Grid.
          * \param[in] reg   Current equilibration region.
@@ -148,8 +153,9 @@ namespace Opm
          *                cells pertaining to the current
          *                equilibration region.  Must implement
          *                methods begin() and end() to bound the range
-         *                as well as provide an inner type,
-         *                const_iterator, to traverse the range.
+         *                and size() as well as provide an inner
+         *                random access iterator type, const_iterator,
+         *                to traverse the range.
          *
          * \param[in] reg             Current equilibration region.
          * \param[in] cells           Range that spans the cells of the current
@@ -179,8 +185,9 @@ namespace Opm
          *                cells pertaining to the current
          *                equilibration region.  Must implement
          *                methods begin() and end() to bound the range
-         *                as well as provide an inner type,
-         *                const_iterator, to traverse the range.
+         *                and size() as well as provide an inner
+         *                random access iterator type, const_iterator,
+         *                to traverse the range.
          *
          * \param[in] grid            Grid.
          * \param[in] cells           Range that spans the cells of the current
@@ -383,40 +390,61 @@ namespace Opm
                                  const Grid&                       G    ,
                                  const double grav)
                 {
+                    // Regions are independent. The pressure tables of all
+                    // regions are built concurrently, after which the
+                    // saturations are computed region by region, with the
+                    // cells of each region processed concurrently.
+                    std::vector<int> regions;
                     for (const auto& r : reg.activeRegions()) {
-                        const auto& cells = reg.cells(r);
-                        if (cells.empty())
+                        if (reg.cells(r).empty())
                         {
                             OpmLog::warning("Equilibration region " + std::to_string(r + 1) 
                                             + " has no active cells");
                             continue;
                         }
-                        const int repcell = *cells.begin();
+                        regions.push_back(r);
+                    }
+                    const int nreg = regions.size();
 
+                    std::vector<EqReg> eqregs;
+                    eqregs.reserve(nreg);
+                    for (const int r : regions) {
+                        const int repcell = *reg.cells(r).begin();
                         const RhoCalc calc(props, repcell);
-                        const EqReg eqreg(rec[r], calc,
-                                          rs_func_[r], rv_func_[r],
-                                          props.phaseUsage());
-                   
-                        PVec pressures = phasePressures(G, eqreg, cells, grav);
+                        eqregs.push_back(EqReg(rec[r], calc,
+                                               rs_func_[r], rv_func_[r],
+                                               props.phaseUsage()));
+                    }
+
+                    std::vector<PVec> pressures(nreg);
+                    Details::parallelFor(nreg, 1, [&](const int i) {
+                        pressures[i] = phasePressures(G, eqregs[i], reg.cells(regions[i]), grav);
+                    });
+
+                    for (int i = 0; i < nreg; ++i) {
+                        const int r = regions[i];
+                        const auto& cells = reg.cells(r);
+                        const EqReg& eqreg = eqregs[i];
                         const std::vector<double>& temp = temperature(G, eqreg, cells);
 
-                        const PVec sat = phaseSaturations(G, eqreg, cells, props, swat_init_, pressures);
+                        const PVec sat = phaseSaturations(G, eqreg, cells, props, swat_init_, pressures[i]);
 
                         const int np = props.numPhases();
                         for (int p = 0; p < np; ++p) {
-                            copyFromRegion(pressures[p], cells, pp_[p]);
+                            copyFromRegion(pressures[i][p], cells, pp_[p]);
                             copyFromRegion(sat[p], cells, sat_[p]);
                         }
                         if (props.phaseUsage().phase_used[BlackoilPhases::Liquid]
                             && props.phaseUsage().phase_used[BlackoilPhases::Vapour]) {
                             const int oilpos = props.phaseUsage().phase_pos[BlackoilPhases::Liquid];
                             const int gaspos = props.phaseUsage().phase_pos[BlackoilPhases::Vapour];
-                            const Vec rs_vals = computeRs(G, cells, pressures[oilpos], temp, *(rs_func_[r]), sat[gaspos]);
-                            const Vec rv_vals = computeRs(G, cells, pressures[gaspos], temp, *(rv_func_[r]), sat[oilpos]);
+                            const Vec rs_vals = computeRs(G, cells, pressures[i][oilpos], temp, *(rs_func_[r]), sat[gaspos]);
+                            const Vec rv_vals = computeRs(G, cells, pressures[i][gaspos], temp, *(rv_func_[r]), sat[oilpos]);
                             copyFromRegion(rs_vals, cells, rs_);
                             copyFromRegion(rv_vals, cells, rv_);
                         }
+                        // Release the region's pressures once copied.
+                        PVec().swap(pressures[i]);
                     }
                 }
 
@@ -27,48 +27,99 @@
 #include <opm/core/props/BlackoilPhases.hpp>
 #include <opm/core/simulator/initState.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace Opm
 {
     namespace Details {
+        /// Solution of the initial value problem
+        ///     y' = f(x, y),  y(span[0]) = y0
+        /// on the interval span by the classical Runge-Kutta method,
+        /// with dense output.
+        ///
+        /// With a zero tolerance, N steps of equal size are taken.
+        /// With a positive tolerance, steps are at most 1/N of the
+        /// interval and are otherwise chosen by step doubling, keeping
+        /// the estimated local error of each step below
+        /// tol*max(|y|, 1). Smooth solutions then need far fewer
+        /// steps, while the steps are refined around kinks in f.
         template <class RHS>
         class RK4IVP {
         public:
             RK4IVP(const RHS&                  f   ,
                    const std::array<double,2>& span,
                    const double                y0  ,
-                   const int                   N   )
-                : N_(N)
-                , span_(span)
+                   const int                   N   ,
+                   const double                tol = 0.0)
+                : dir_(span[1] < span[0] ? -1.0 : 1.0)
             {
-                const double h  = stepsize();
-                const double h2 = h / 2;
-                const double h6 = h / 6;
+                const double length = span[1] - span[0];
+                const double hmax   = length / N;
 
-                y_.reserve(N + 1);
-                f_.reserve(N + 1);
+                push(span[0], y0, f(span[0], y0));
 
-                y_.push_back(y0);
-                f_.push_back(f(span_[0], y0));
-
-                for (int i = 0; i < N; ++i) {
-                    const double x  = span_[0] + i*h;
-                    const double y  = y_.back();
+                if (! (tol > 0.0)) {
+                    for (int i = 0; i < N; ++i) {
+                        const double x  = span[0] + i*hmax;
+                        const double y  = step(f, x, y_.back(), f_.back(), hmax);
 
-                    const double k1 = f_[i];
-                    const double k2 = f(x + h2, y + h2*k1);
-                    const double k3 = f(x + h2, y + h2*k2);
-                    const double k4 = f(x + h , y + h*k3);
+                        push(x + hmax, y, f(x + hmax, y));
+                    }
 
-                    y_.push_back(y + h6*(k1 + 2*(k2 + k3) + k4));
-                    f_.push_back(f(x + h, y_.back()));
+                    assert (y_.size() == std::vector<double>::size_type(N + 1));
+                    return;
                 }
 
-                assert (y_.size() == std::vector<double>::size_type(N + 1));
+                // Steps shorter than this are accepted regardless of
+                // the error estimate, to get past discontinuities.
+                const double hmin = 1.0e-10 * std::fabs(length);
+
+                double x = span[0];
+                double h = hmax;
+                while (dir_*(span[1] - x) > hmin) {
+                    if (dir_*(x + h - span[1]) > 0.0) {
+                        h = span[1] - x;
+                    }
+
+                    const double y  = y_.back();
+                    const double fy = f_.back();
+
+                    // One full step against two half steps.
+                    const double xn = (h == span[1] - x) ? span[1] : x + h;
+                    const double y1 = step(f, x, y, fy, h);
+                    const double ym = step(f, x, y, fy, h/2);
+                    const double fm = f(x + h/2, ym);
+                    const double y2 = step(f, x + h/2, ym, fm, h/2);
+                    const double f2 = f(xn, y2);
+
+                    // The dense output must be as accurate as the
+                    // steps, so also compare the Hermite interpolant
+                    // over the full step to the midpoint value.
+                    const double ymh = (y + y2)/2 + h*(fy - f2)/8;
+
+                    const double err   = std::max(std::fabs(y2 - y1) / 15,
+                                                  std::fabs(ymh - ym) / 4);
+                    const double bound = tol * std::max(std::fabs(y2), 1.0);
+
+                    if (err <= bound || std::fabs(h) <= hmin) {
+                        push(x + h/2, ym, fm);
+                        push(xn, y2, f2);
+                        x = xn;
+                    }
+
+                    // Usual safety factor and limits on the change.
+                    const double ratio = (err > 0.0)
+                        ? 0.9 * std::pow(bound / err, 0.2) : 2.0;
+                    h *= std::min(2.0, std::max(0.1, ratio));
+                    if (std::fabs(h) > std::fabs(hmax)) {
+                        h = hmax;
+                    }
+                }
             }
 
             double
@@ -76,13 +127,25 @@ namespace Opm
             {
                 // Dense output (O(h**3)) according to Shampine
                 // (Hermite interpolation)
-                const double h = stepsize();
-                int          i = (x - span_[0]) / h;
-                const double t = (x - (span_[0] + i*h)) / h;
+                const int n = x_.size();
+                if (n < 2) {
+                    return y_[0];
+                }
 
-                // Crude handling of evaluation point outside "span_";
-                if (i  <  0) { i = 0;      }
-                if (N_ <= i) { i = N_ - 1; }
+                // Crude handling of evaluation point outside the span;
+                // extrapolate from the first or last step.
+                int i = std::upper_bound(x_.begin(), x_.end(), x,
+                                         [this](const double a, const double b)
+                                         { return dir_*a < dir_*b; })
+                    - x_.begin() - 1;
+                if (i < 0)     { i = 0;     }
+                if (n - 1 <= i) { i = n - 2; }
+
+                const double h = x_[i + 1] - x_[i];
+                if (h == 0.0) {
+                    return y_[i];
+                }
+                const double t = (x - x_[i]) / h;
 
                 const double y0 = y_[i], y1 = y_[i + 1];
                 const double f0 = f_[i], f1 = f_[i + 1];
@@ -96,13 +159,32 @@ namespace Opm
             }
 
         private:
-            int                  N_;
-            std::array<double,2> span_;
+            double               dir_;
+            std::vector<double>  x_;
             std::vector<double>  y_;
             std::vector<double>  f_;
 
-            double
-            stepsize() const { return (span_[1] - span_[0]) / N_; }
+            void
+            push(const double x, const double y, const double fy)
+            {
+                x_.push_back(x);
+                y_.push_back(y);
+                f_.push_back(fy);
+            }
+
+            static double
+            step(const RHS& f, const double x, const double y,
+                 const double k1, const double h)
+            {
+                const double h2 = h / 2;
+                const double h6 = h / 6;
+
+                const double k2 = f(x + h2, y + h2*k1);
+                const double k3 = f(x + h2, y + h2*k2);
+                const double k4 = f(x + h , y + h*k3);
+
+                return y + h6*(k1 + 2*(k2 + k3) + k4);
+            }
         };
 
         namespace PhasePressODE {
@@ -303,6 +385,12 @@ namespace Opm
         } // namespace PhaseIndex
 
         namespace PhasePressure {
+            // Pressure tables take steps of at most 1/minSteps of the
+            // depth span, otherwise limited by a local error relative
+            // to the pressure of relTol (0.01 mPa at 100 bar).
+            const int    minSteps = 100;
+            const double relTol   = 1.0e-12;
+
             template <class Grid,
                       class PressFunction,
                       class CellRange>
@@ -316,16 +404,34 @@ namespace Opm
 
                 enum { up = 0, down = 1 };
 
-                std::vector<double>::size_type c = 0;
-                for (typename CellRange::const_iterator
-                         ci = cells.begin(), ce = cells.end();
-                     ci != ce; ++ci, ++c)
-                {
-                    assert (c < p.size());
-
-                    const double z = UgGridHelpers::cellCenterDepth(G, *ci);
+                const auto first = cells.begin();
+                const int ncells = cells.size();
+                assert (std::vector<double>::size_type(ncells) <= p.size());
+                Details::parallelFor(ncells, 1024, [&](const int c) {
+                    const double z = UgGridHelpers::cellCenterDepth(G, *(first + c));
                     p[c] = (z < split) ? f[up](z) : f[down](z);
-                }
+                });
+            }
+
+            // Pressure tables upwards and downwards from depth z0. The
+            // two integrations are independent, so they run concurrently.
+            template <class ODE>
+            std::array<Details::RK4IVP<ODE>, 2>
+            tables(const ODE&                  drho,
+                   const std::array<double,2>& span,
+                   const double                z0  ,
+                   const double                p0  )
+            {
+                typedef Details::RK4IVP<ODE> Press;
+
+                const std::array<std::array<double,2>, 2> dir =
+                    {{ {{ z0, span[0] }}, {{ z0, span[1] }} }};
+                std::array<std::unique_ptr<Press>, 2> t;
+                Details::parallelFor(2, 1, [&](const int i) {
+                    t[i].reset(new Press(drho, dir[i], p0, minSteps, relTol));
+                });
+
+                return {{ std::move(*t[0]), std::move(*t[1]) }};
             }
 
             template <class Grid,
@@ -359,17 +465,7 @@ namespace Opm
                     p0 = po_woc - reg.pcow_woc(); // Water pressure at contact
                 }
 
-                std::array<double,2> up   = {{ z0, span[0] }};
-                std::array<double,2> down = {{ z0, span[1] }};
-
-                typedef Details::RK4IVP<ODE> WPress;
-                std::array<WPress,2> wpress = {
-                    {
-                        WPress(drho, up  , p0, 2000)
-                        ,
-                        WPress(drho, down, p0, 2000)
-                    }
-                };
+                const auto wpress = tables(drho, span, z0, p0);
 
                 assign(G, wpress, z0, cells, press);
 
@@ -419,17 +515,7 @@ namespace Opm
                     p0 = reg.pressure();
                 }
 
-                std::array<double,2> up   = {{ z0, span[0] }};
-                std::array<double,2> down = {{ z0, span[1] }};
-
-                typedef Details::RK4IVP<ODE> OPress;
-                std::array<OPress,2> opress = {
-                    {
-                        OPress(drho, up  , p0, 2000)
-                        ,
-                        OPress(drho, down, p0, 2000)
-                    }
-                };
+                const auto opress = tables(drho, span, z0, p0);
 
                 assign(G, opress, z0, cells, press);
 
@@ -481,17 +567,7 @@ namespace Opm
                     p0 = po_goc + reg.pcgo_goc(); // Gas pressure at contact
                 }
 
-                std::array<double,2> up   = {{ z0, span[0] }};
-                std::array<double,2> down = {{ z0, span[1] }};
-
-                typedef Details::RK4IVP<ODE> GPress;
-                std::array<GPress,2> gpress = {
-                    {
-                        GPress(drho, up  , p0, 2000)
-                        ,
-                        GPress(drho, down, p0, 2000)
-                    }
-                };
+                const auto gpress = tables(drho, span, z0, p0);
 
                 assign(G, gpress, z0, cells, press);
 
@@ -567,17 +643,21 @@ namespace Opm
                                        press[ oix ], po_woc, po_goc);
                 }
 
-                if (PhaseUsed::water(pu)) {
-                    const int wix = PhaseIndex::water(pu);
-                    PhasePressure::water(G, reg, span, grav, po_woc,
-                                         cells, press[ wix ]);
-                }
+                // Water and gas start from the oil pressure at their own
+                // contact, so they are independent once oil is done.
+                Details::parallelFor(2, 1, [&](const int i) {
+                    if (i == 0 && PhaseUsed::water(pu)) {
+                        const int wix = PhaseIndex::water(pu);
+                        PhasePressure::water(G, reg, span, grav, po_woc,
+                                             cells, press[ wix ]);
+                    }
 
-                if (PhaseUsed::gas(pu)) {
-                    const int gix = PhaseIndex::gas(pu);
-                    PhasePressure::gas(G, reg, span, grav, po_goc,
-                                       cells, press[ gix ]);
-                }
+                    if (i == 1 && PhaseUsed::gas(pu)) {
+                        const int gix = PhaseIndex::gas(pu);
+                        PhasePressure::gas(G, reg, span, grav, po_goc,
+                                           cells, press[ gix ]);
+                    }
+                });
             }
         }
     } // namespace Details
@@ -685,17 +765,29 @@ namespace Opm
             }
 
             std::vector< std::vector<double> > phase_saturations = phase_pressures; // Just to get the right size.
-            double smin[BlackoilPhases::MaxNumPhases] = { 0.0 };
-            double smax[BlackoilPhases::MaxNumPhases] = { 0.0 };
 
             const bool water = reg.phaseUsage().phase_used[BlackoilPhases::Aqua];
             const bool gas = reg.phaseUsage().phase_used[BlackoilPhases::Vapour];
             const int oilpos = reg.phaseUsage().phase_pos[BlackoilPhases::Liquid];
             const int waterpos = reg.phaseUsage().phase_pos[BlackoilPhases::Aqua];
             const int gaspos = reg.phaseUsage().phase_pos[BlackoilPhases::Vapour];
-            std::vector<double>::size_type local_index = 0;
-            for (typename CellRange::const_iterator ci = cells.begin(); ci != cells.end(); ++ci, ++local_index) {
-                const int cell = *ci;
+            // Capillary pressure inverses, tabulated once per curve.
+            std::unique_ptr<InversePcTables> water_pc_inverse;
+            if (water && swat_init.empty()) {
+                water_pc_inverse.reset(new InversePcTables(props, waterpos, false, cells));
+            }
+            std::unique_ptr<InversePcTables> gas_pc_inverse;
+            if (gas) {
+                gas_pc_inverse.reset(new InversePcTables(props, gaspos, true, cells));
+            }
+            // Cells are independent: each iteration only reads and
+            // writes the entries of its own cell.
+            const auto first = cells.begin();
+            const int ncells = cells.size();
+            auto cellSaturations = [&](const int local_index) {
+                const int cell = *(first + local_index);
+                double smin[BlackoilPhases::MaxNumPhases] = { 0.0 };
+                double smax[BlackoilPhases::MaxNumPhases] = { 0.0 };
                 props.satRange(1, &cell, smin, smax);
                 // Find saturations from pressure differences by
                 // inverting capillary pressure functions.
@@ -710,7 +802,7 @@ namespace Opm
                     else{
                         const double pcov = phase_pressures[oilpos][local_index] - phase_pressures[waterpos][local_index];
                         if (swat_init.empty()) { // Invert Pc to find sw
-                            sw = satFromPc(props, waterpos, cell, pcov);
+                            sw = water_pc_inverse->satFromPc(local_index, pcov);
                             phase_saturations[waterpos][local_index] = sw;
                         } else { // Scale Pc to reflect imposed sw
                             sw = swat_init[cell];
@@ -730,8 +822,8 @@ namespace Opm
                     else{
                         // Note that pcog is defined to be (pg - po), not (po - pg).
                         const double pcog = phase_pressures[gaspos][local_index] - phase_pressures[oilpos][local_index];
-                        const double increasing = true; // pcog(sg) expected to be increasing function
-                        sg = satFromPc(props, gaspos, cell, pcog, increasing);
+                        // pcog(sg) expected to be increasing function
+                        sg = gas_pc_inverse->satFromPc(local_index, pcog);
                         phase_saturations[gaspos][local_index] = sg;
                     }
                 }
@@ -795,6 +887,15 @@ namespace Opm
                       props.capPress(1, sat, &cell, pc, 0);
                       phase_pressures[waterpos][local_index] = phase_pressures[oilpos][local_index] - pc[waterpos];
                   }
+            };
+            if (swat_init.empty()) {
+                Details::parallelFor(ncells, 256, cellSaturations);
+            } else {
+                // swatInitScaling() updates the scaling stored in props,
+                // which is not safe to do from several threads.
+                for (int local_index = 0; local_index < ncells; ++local_index) {
+                    cellSaturations(local_index);
+                }
             }
             return phase_saturations;
         }
@@ -807,8 +908,9 @@ namespace Opm
          *                cells pertaining to the current
          *                equilibration region.  Must implement
          *                methods begin() and end() to bound the range
-         *                as well as provide an inner type,
-         *                const_iterator, to traverse the range.
+         *                and size() as well as provide an inner
+         *                random access iterator type, const_iterator,
+         *                to traverse the range.
          *
          * \param[in] grid            Grid.
          * \param[in] cells           Range that spans the cells of the current
@@ -828,11 +930,11 @@ namespace Opm
         {
             assert(UgGridHelpers::dimensions(grid) == 3);
             std::vector<double> rs(cells.size());
-            int count = 0;
-            for (auto it = cells.begin(); it != cells.end(); ++it, ++count) {
-                const double depth = UgGridHelpers::cellCenterDepth(grid, *it);
+            const auto first = cells.begin();
+            Details::parallelFor(rs.size(), 1024, [&](const int count) {
+                const double depth = UgGridHelpers::cellCenterDepth(grid, *(first + count));
                 rs[count] = rs_func(depth, oil_pressure[count], temperature[count], gas_saturation[count]);
-            }
+            });
             return rs;
         }
 
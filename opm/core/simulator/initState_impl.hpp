@@ -350,13 +350,14 @@ namespace Opm
             MonotCubicInterpolator press(zv, pv);
 
             // Evaluate pressure at each cell centroid.
-            std::vector<double>& p = state.pressure();
+            std::vector<double> z(number_of_cells);
             for (int c = 0; c < number_of_cells; ++c) {
-                const double z = UgGridHelpers::
+                z[c] = UgGridHelpers::
                     getCoordinate(UgGridHelpers::increment(begin_cell_centroids, c, dimensions),
                                   dimensions-1);
-                p[c] = press(z);
             }
+            std::vector<double>& p = state.pressure();
+            press.evaluate(number_of_cells, z.data(), p.data());
         }
 
         // Initialize face pressures to distance-weighted average of adjacent cell pressures.
@@ -133,8 +133,8 @@ namespace Opm {
             void
             allocate(::std::size_t ndof, ::std::size_t m, ::std::size_t nnz) {
                 ia_.reserve(1 + ( m  * ndof));
-                ja_.reserve(0 + (nnz * ndof));
-                sa_.reserve(0 + (nnz * ndof));
+                ja_.reserve(0 + (nnz * ndof * ndof));
+                sa_.reserve(0 + (nnz * ndof * ndof));
             }
 
             void
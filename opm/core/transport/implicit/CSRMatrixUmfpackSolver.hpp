@@ -44,10 +44,32 @@ namespace Opm
     namespace ImplicitTransportLinAlgSupport
     {
 
+        /// Direct solver for the implicit transport Jacobian.  The
+        /// symbolic factorisation is kept between calls to solve()
+        /// and reused as long as the sparsity pattern is unchanged,
+        /// which is the case for all Newton iterations and time steps
+        /// on a single grid.
         class CSRMatrixUmfpackSolver
         {
         public:
+            CSRMatrixUmfpackSolver()
+#if HAVE_SUITESPARSE_UMFPACK_H
+                : solver_(umfpack_solver_new())
+#endif
+            {
+#if HAVE_SUITESPARSE_UMFPACK_H
+                if (solver_ == 0) {
+                    OPM_THROW(std::runtime_error, "Failed to allocate UMFPACK solver.");
+                }
+#endif
+            }
 
+            ~CSRMatrixUmfpackSolver()
+            {
+#if HAVE_SUITESPARSE_UMFPACK_H
+                umfpack_solver_delete(solver_);
+#endif
+            }
 
             template <class Vector>
             void
@@ -56,7 +78,9 @@ namespace Opm
                   Vector                  x)
             {
 #if HAVE_SUITESPARSE_UMFPACK_H
-                call_UMFPACK(const_cast<CSRMatrix*>(A), b, x);
+                if (! umfpack_solver_solve(solver_, A, b, x)) {
+                    OPM_THROW(std::runtime_error, "UMFPACK failed to factorise the transport system.");
+                }
 #else
     OPM_THROW(std::runtime_error, "Cannot use implicit transport solver without UMFPACK. "
           "Reconfigure opm-core with SuiteSparse/UMFPACK support and recompile.");
@@ -71,13 +95,22 @@ namespace Opm
                   Vector&                 x)
             {
 #if HAVE_SUITESPARSE_UMFPACK_H
-                call_UMFPACK(const_cast<CSRMatrix*>(&A), &b[0], &x[0]);
+                if (! umfpack_solver_solve(solver_, &A, &b[0], &x[0])) {
+                    OPM_THROW(std::runtime_error, "UMFPACK failed to factorise the transport system.");
+                }
 #else
     OPM_THROW(std::runtime_error, "Cannot use implicit transport solver without UMFPACK. "
           "Reconfigure opm-core with SuiteSparse/UMFPACK support and recompile.");
 #endif
             }
 
+        private:
+            CSRMatrixUmfpackSolver           (const CSRMatrixUmfpackSolver&);
+            CSRMatrixUmfpackSolver& operator=(const CSRMatrixUmfpackSolver&);
+
+#if HAVE_SUITESPARSE_UMFPACK_H
+            struct UMFPACKSolver* solver_;
+#endif
 
         }; // class CSRMatrixUmfpackSolver
 
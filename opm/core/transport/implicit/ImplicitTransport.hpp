@@ -38,6 +38,7 @@
 
 #include <opm/core/transport/implicit/ImplicitAssembly.hpp>
 
+#include <cstdint>
 #include <iostream>
 
 namespace Opm {
@@ -106,9 +107,18 @@ namespace Opm {
     public:
         ImplicitTransport(Model& model)
             : model_(model),
-              asm_  (model)
+              asm_  (model),
+              sys_ncells_(-1),
+              sys_nfaces_(-1),
+              sys_topology_(0)
         {}
 
+        /// Force the Jacobian structure to be rebuilt by the next
+        /// solve(), e.g. after modifying the grid in place.
+        void invalidate() {
+            sys_ncells_ = -1;
+        }
+
         template <class Grid          ,
                   class SourceTerms   ,
                   class ReservoirState,
@@ -124,7 +134,19 @@ namespace Opm {
             typedef typename JacobianSystem::vector_type vector_type;
             typedef typename JacobianSystem::matrix_type matrix_type;
 
-            asm_.createSystem(g, sys_);
+            // The Jacobian structure depends on the grid topology
+            // only.  Build it on first use and whenever the topology
+            // changes; otherwise only values are reassembled.
+            const ::std::uint64_t topology = topologyChecksum(g);
+            if ((sys_ncells_   != g.number_of_cells) ||
+                (sys_nfaces_   != g.number_of_faces) ||
+                (sys_topology_ != topology)) {
+                asm_.createSystem(g, sys_);
+                sys_ncells_   = g.number_of_cells;
+                sys_nfaces_   = g.number_of_faces;
+                sys_topology_ = topology;
+            }
+
             model_.initStep(state, g, sys_);
             init = model_.initIteration(state, g, sys_);
 
@@ -162,13 +184,13 @@ namespace Opm {
                 bool finished=rpt.norm_res<ctrl.atol;
                 double alpha=2.0;
                 // store old solution and increment before line search
-                vector_type dx_old(sys_.vector().increment());
-                vector_type x_old(sys_.vector().solution());
+                dx_old_ = sys_.vector().increment();
+                x_old_  = sys_.vector().solution();
                 while(! finished){
                     alpha/=2.0;
-                    VAsgn<vector_type>::assign(alpha, dx_old,
+                    VAsgn<vector_type>::assign(alpha, dx_old_,
                                                sys_.vector().writableIncrement());
-                    VAsgn<vector_type>::assign(x_old,
+                    VAsgn<vector_type>::assign(x_old_,
                                                sys_.vector().writableSolution());
 
                     sys_.vector().addIncrement();
@@ -219,6 +241,30 @@ namespace Opm {
         ImplicitTransport           (const ImplicitTransport&);
         ImplicitTransport& operator=(const ImplicitTransport&);
 
+        // Hash of the cell-face and face-cell connectivity that
+        // determines the Jacobian structure.
+        template <class Grid>
+        static ::std::uint64_t
+        topologyChecksum(const Grid& g) {
+            ::std::uint64_t h = 14695981039346656037ull;
+            const auto mix = [&h](const int v) {
+                h = (h ^ static_cast<unsigned int>(v)) * 1099511628211ull;
+            };
+
+            const int nc = g.number_of_cells;
+            for (int c = 0; c <= nc; ++c) {
+                mix(g.cell_facepos[c]);
+            }
+            for (int i = 0; i < g.cell_facepos[nc]; ++i) {
+                mix(g.cell_faces[i]);
+            }
+            for (int f = 0; f < 2*g.number_of_faces; ++f) {
+                mix(g.face_cells[f]);
+            }
+
+            return h;
+        }
+
 #if 0
         using Model::initStep;
         using Model::initIteration;
@@ -229,6 +275,13 @@ namespace Opm {
         Model&                  model_;
         ImplicitAssembly<Model> asm_;
         JacobianSystem          sys_;
+        int                     sys_ncells_;
+        int                     sys_nfaces_;
+        ::std::uint64_t         sys_topology_;
+
+        // Line search work vectors, kept to retain their storage.
+        typename JacobianSystem::vector_type dx_old_;
+        typename JacobianSystem::vector_type x_old_;
     };
 }
 #endif  /* OPM_IMPLICITTRANSPORT_HPP_HEADER */
@@ -22,23 +22,29 @@
 #include <opm/core/transport/reorder/reordersequence.h>
 #include <opm/core/grid.h>
 #include <opm/core/utility/StopWatch.hpp>
+#include <opm/core/utility/Instrumentation.hpp>
+#include <opm/core/utility/BufferedLog.hpp>
 
 #include <vector>
 #include <cassert>
-#include <iostream>
 
 
 void Opm::ReorderSolverInterface::reorderAndTransport(const UnstructuredGrid& grid, const double* darcyflux)
 {
+    OPM_TIMER_SCOPE("reorder transport");
     // Compute reordered sequence of single-cell problems
     sequence_.resize(grid.number_of_cells);
     components_.resize(grid.number_of_cells + 1);
     int ncomponents;
     time::StopWatch clock;
     clock.start();
-    compute_sequence(&grid, darcyflux, &sequence_[0], &components_[0], &ncomponents);
+    {
+        OPM_TIMER_SCOPE("topological sort");
+        compute_sequence(&grid, darcyflux, &sequence_[0], &components_[0], &ncomponents);
+    }
     clock.stop();
-    std::cout << "Topological sort took: " << clock.secsSinceStart() << " seconds." << std::endl;
+    OPM_BUFFERED_LOG(BufferedLog::Detailed,
+                     "Topological sort took: " << clock.secsSinceStart() << " seconds.");
 
     // Make vector's size match actual used data.
     components_.resize(ncomponents + 1);
@@ -59,9 +65,11 @@ void Opm::ReorderSolverInterface::reorderAndTransport(const UnstructuredGrid& gr
 	if (comp_size == 1) {
 	    solveSingleCell(sequence_[components_[comp]]);
 	} else {
+	    OPM_COUNTER_ADD("multicell component size", comp_size);
 	    solveMultiCell(comp_size, &sequence_[components_[comp]]);
 	}
     }
+    BufferedLog::flush();
 }
 
 
@@ -27,6 +27,17 @@ struct UnstructuredGrid;
 namespace Opm
 {
 
+    /// Root finders available for the single-cell problems of the
+    /// reordering transport solvers.
+    enum ReorderSingleCellMethod {
+        /// Pegasus-type regula falsi, using residual values only.
+        ReorderRegulaFalsi,
+        /// Safeguarded Newton (Newton-bisection), using analytic
+        /// derivatives of the residual. Starts from a predictor
+        /// computed from the upwind saturations.
+        ReorderNewton
+    };
+
     /// Interface for implementing reordering solvers.
     /// A subclass must provide the solveSingleCell() and
     /// solveMultiCell methods, and is expected to implement a solve()
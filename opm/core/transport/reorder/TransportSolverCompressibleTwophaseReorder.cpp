@@ -24,10 +24,13 @@
 #include <opm/core/grid.h>
 #include <opm/core/transport/reorder/reordersequence.h>
 #include <opm/core/utility/RootFinders.hpp>
+#include <opm/core/utility/BufferedLog.hpp>
+#include <opm/core/utility/Instrumentation.hpp>
 #include <opm/core/utility/miscUtilities.hpp>
 #include <opm/core/utility/miscUtilitiesBlackoil.hpp>
 #include <opm/core/pressure/tpfa/trans_tpfa.h>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <iterator>
@@ -39,17 +42,20 @@ namespace Opm
 
     // Choose error policy for scalar solves here.
     typedef RegulaFalsi<WarnAndContinueOnError> RootFinder;
+    typedef NewtonBisection<WarnAndContinueOnError> NewtonRootFinder;
 
 
     TransportSolverCompressibleTwophaseReorder::TransportSolverCompressibleTwophaseReorder(
                                                    const UnstructuredGrid& grid,
                                                    const Opm::BlackoilPropertiesInterface& props,
                                                    const double tol,
-                                                   const int maxit)
+                                                   const int maxit,
+                                                   const ReorderSingleCellMethod method)
         : grid_(grid),
           props_(props),
           tol_(tol),
           maxit_(maxit),
+          method_(method),
           darcyflux_(0),
           source_(0),
           dt_(0.0),
@@ -88,6 +94,7 @@ namespace Opm
                                                    std::vector<double>& saturation,
                                                    std::vector<double>& surfacevol)
     {
+        OPM_TIMER_SCOPE("transport");
         darcyflux_ = darcyflux;
         surfacevol0_ = &surfacevol[0];
         porevolume0_ = porevolume0;
@@ -145,6 +152,8 @@ namespace Opm
         // @@@ TODO: figure out change to rock-comp. terms with fluid compr.
         double comp_term; // Now: used to be: q - sum_j v_ij
         double dtpv;    // dt/pv(i)
+        double upw_flux;  // B_i sum_j b_j |min(v_ij, 0)| + B_i max(q, 0)
+        double upw_sat;   // B_i sum_j b_j |min(v_ij, 0)|*s_j + B_i max(q, 0)
         const TransportSolverCompressibleTwophaseReorder& tm;
         explicit Residual(const TransportSolverCompressibleTwophaseReorder& tmodel, int cell_index)
             : tm(tmodel)
@@ -159,6 +168,9 @@ namespace Opm
             outflux = !src_is_inflow ? src_flux : 0.0;
             comp_term = (tm.porevolume_[cell] - tm.porevolume0_[cell])/tm.porevolume0_[cell];
             dtpv    = tm.dt_/tm.porevolume0_[cell];
+            // Injected fluid is water.
+            upw_flux = src_is_inflow ? -B_cell*src_flux : 0.0;
+            upw_sat  = upw_flux;
             for (int i = tm.grid_.cell_facepos[cell]; i < tm.grid_.cell_facepos[cell+1]; ++i) {
                 const int f = tm.grid_.cell_faces[i];
                 double flux;
@@ -176,6 +188,8 @@ namespace Opm
                     if (flux < 0.0) {
                         const double b_face = tm.A_[np*np*other + 0];
                         influx  += B_cell*b_face*flux*tm.fractionalflow_[other];
+                        upw_flux -= B_cell*b_face*flux;
+                        upw_sat  -= B_cell*b_face*flux*tm.saturation_[other];
                     } else {
                         outflux += flux; // Because B_cell*b_face = 1 for outflow faces
                     }
@@ -187,6 +201,20 @@ namespace Opm
             // return s - s0 + dtpv*(outflux*tm.fracFlow(s, cell) + influx + s*comp_term);
             return s - B_cell*z0 + dtpv*(outflux*tm.fracFlow(s, cell) + influx) + s*comp_term;
         }
+        double operator()(double s, double& drds) const
+        {
+            double dfds = 0.0;
+            const double f = tm.fracFlow(s, cell, dfds);
+            drds = 1.0 + dtpv*outflux*dfds + comp_term;
+            return s - B_cell*z0 + dtpv*(outflux*f + influx) + s*comp_term;
+        }
+        // Starting point for Newton iterations: the solution obtained
+        // by replacing fractional flows with saturations.
+        double predictor() const
+        {
+            const double s = (B_cell*z0 + dtpv*upw_sat)/(1.0 + dtpv*upw_flux + comp_term);
+            return std::min(std::max(s, 0.0), 1.0);
+        }
     };
 
 
@@ -194,7 +222,11 @@ namespace Opm
     {
         Residual res(*this, cell);
         int iters_used;
-        saturation_[cell] = RootFinder::solve(res, saturation_[cell], 0.0, 1.0, maxit_, tol_, iters_used);
+        if (method_ == ReorderNewton) {
+            saturation_[cell] = NewtonRootFinder::solve(res, res.predictor(), 0.0, 1.0, maxit_, tol_, iters_used);
+        } else {
+            saturation_[cell] = RootFinder::solve(res, saturation_[cell], 0.0, 1.0, maxit_, tol_, iters_used);
+        }
         fractionalflow_[cell] = fracFlow(saturation_[cell], cell);
     }
 
@@ -300,8 +332,9 @@ namespace Opm
             OPM_THROW(std::runtime_error, "In solveMultiCell(), we did not converge after "
                   << num_iters << " iterations. Remaining update count = " << update_count);
         }
-        std::cout << "Solved " << num_cells << " cell multicell problem in "
-                  << num_iters << " iterations." << std::endl;
+        OPM_COUNTER_ADD("multicell iterations", num_iters);
+        OPM_BUFFERED_LOG(BufferedLog::Detailed, "Solved " << num_cells << " cell multicell problem in "
+                         << num_iters << " iterations.");
 
     }
 
@@ -316,6 +349,24 @@ namespace Opm
     }
 
 
+    double TransportSolverCompressibleTwophaseReorder::fracFlow(double s, int cell, double& dfds) const
+    {
+        double sat[2] = { s, 1.0 - s };
+        double mob[2];
+        double dmob[4];
+        props_.relperm(1, sat, &cell, mob, dmob);
+        // dmob is column-major, dmob[i + 2*j] = d(kr_i)/d(s_j), and
+        // d(s_1)/d(s) = -1.
+        const double dmob0 = (dmob[0] - dmob[2])/visc_[2*cell + 0];
+        const double dmob1 = (dmob[1] - dmob[3])/visc_[2*cell + 1];
+        mob[0] /= visc_[2*cell + 0];
+        mob[1] /= visc_[2*cell + 1];
+        const double tmob = mob[0] + mob[1];
+        dfds = (dmob0*mob[1] - mob[0]*dmob1)/(tmob*tmob);
+        return mob[0]/tmob;
+    }
+
+
 
 
 
@@ -512,6 +563,7 @@ namespace Opm
                                                           std::vector<double>& saturation,
                                                           std::vector<double>& surfacevol)
     {
+        OPM_TIMER_SCOPE("gravity segregation");
         // Assume that solve() has already been called, so that A_ is current.
         initGravityDynamic();
 
@@ -547,8 +599,9 @@ namespace Opm
             // std::cout << "==== new column" << std::endl;
             num_iters += solveGravityColumn(columns[i]);
         }
-        std::cout << "Gauss-Seidel column solver average iterations: "
-                  << double(num_iters)/double(columns.size()) << std::endl;
+        OPM_BUFFERED_LOG(BufferedLog::Summary, "Gauss-Seidel column solver average iterations: "
+                         << double(num_iters)/double(columns.size()));
+        BufferedLog::flush();
         toBothSat(saturation_, saturation);
 
         // Compute surface volume as a postprocessing step from saturation and A_
@@ -40,10 +40,12 @@ namespace Opm
         /// \param[in] props     Rock and fluid properties.
         /// \param[in] tol       Tolerance used in the solver.
         /// \param[in] maxit     Maximum number of non-linear iterations used.
+        /// \param[in] method    Root finder used for single-cell problems.
         TransportSolverCompressibleTwophaseReorder(const UnstructuredGrid& grid,
                                            const Opm::BlackoilPropertiesInterface& props,
                                            const double tol,
-                                           const int maxit);
+                                           const int maxit,
+                                           const ReorderSingleCellMethod method = ReorderRegulaFalsi);
 
         /// Solve for saturation at next timestep.
         /// \param[in] darcyflux         Array of signed face fluxes.
@@ -103,6 +105,7 @@ namespace Opm
         std::vector<double> smax_;
         double tol_;
         int maxit_;
+        ReorderSingleCellMethod method_;
 
         const double* darcyflux_;   // one flux per grid face
         const double* surfacevol0_; // one per phase per cell
@@ -128,6 +131,7 @@ namespace Opm
 
         struct Residual;
         double fracFlow(double s, int cell) const;
+        double fracFlow(double s, int cell, double& dfds) const;
 
         struct GravityResidual;
         void mobility(double s, int cell, double* mob) const;
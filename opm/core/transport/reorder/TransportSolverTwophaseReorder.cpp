@@ -24,13 +24,17 @@
 #include <opm/core/transport/reorder/reordersequence.h>
 #include <opm/core/grid/ColumnExtract.hpp>
 #include <opm/core/utility/RootFinders.hpp>
+#include <opm/core/utility/BufferedLog.hpp>
+#include <opm/core/utility/Instrumentation.hpp>
 #include <opm/core/utility/miscUtilities.hpp>
 #include <opm/core/pressure/tpfa/trans_tpfa.h>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <iterator>
 #include <numeric>
+#include <utility>
 
 
 #define EXPERIMENT_GAUSS_SEIDEL
@@ -41,24 +45,183 @@ namespace Opm
 
     // Choose error policy for scalar solves here.
     typedef RegulaFalsi<WarnAndContinueOnError> RootFinder;
+    typedef NewtonBisection<WarnAndContinueOnError> NewtonRootFinder;
+
+
+    namespace
+    {
+        // Multicell components with at least this many cells are
+        // solved by local Newton directly, smaller ones start with
+        // nonlinear Gauss-Seidel.
+        const int multicell_newton_min_cells = 50;
+        // Gauss-Seidel sweeps allowed before a component that has not
+        // converged is handed over to local Newton.
+        const int multicell_gs_max_sweeps = 30;
+        const int multicell_newton_max_iters = 50;
+        // Largest saturation change allowed in one Newton iteration.
+        const double multicell_newton_max_ds = 0.2;
+
+        // Sparse LU factorization without pivoting.
+        //
+        // Scaled by pore volume over time step, the multicell Jacobian
+        // is column diagonally dominant with positive diagonal and
+        // nonpositive off-diagonal entries, so no pivoting is needed.
+        // Rows are eliminated in order using a dense work row.
+        class SparseLU
+        {
+        public:
+            typedef std::vector<std::pair<int, double> > Row;
+
+            // Factor the matrix given by its rows. Returns false if a
+            // (near) zero pivot is found.
+            bool factor(const std::vector<Row>& rows)
+            {
+                const int n = rows.size();
+                // Resize and clear, keeping row storage from earlier
+                // factorizations of the same component.
+                lower_.resize(n);
+                upper_.resize(n);
+                diag_.assign(n, 0.0);
+                w_.assign(n, 0.0);
+                used_.assign(n, 0);
+                for (int i = 0; i < n; ++i) {
+                    lower_[i].clear();
+                    upper_[i].clear();
+                }
+                for (int i = 0; i < n; ++i) {
+                    pattern_.clear();
+                    pending_.clear();
+                    for (Row::const_iterator it = rows[i].begin(); it != rows[i].end(); ++it) {
+                        addToPattern(it->first, i);
+                        w_[it->first] += it->second;
+                    }
+                    std::sort(pending_.begin(), pending_.end());
+                    // Eliminate columns left of the diagonal in
+                    // increasing order. Fill-in columns are larger than
+                    // the one being eliminated, so they are inserted
+                    // into the sorted tail of pending_.
+                    for (std::size_t p = 0; p < pending_.size(); ++p) {
+                        const int k = pending_[p];
+                        const double l = w_[k]/diag_[k];
+                        w_[k] = l;
+                        for (Row::const_iterator it = upper_[k].begin(); it != upper_[k].end(); ++it) {
+                            const int j = it->first;
+                            if (!used_[j] && j < i) {
+                                pending_.insert(std::lower_bound(pending_.begin() + p + 1,
+                                                                 pending_.end(), j), j);
+                            }
+                            addToPattern(j, -1);
+                            w_[j] -= l*it->second;
+                        }
+                    }
+                    for (std::vector<int>::const_iterator it = pattern_.begin(); it != pattern_.end(); ++it) {
+                        const int j = *it;
+                        if (j < i) {
+                            lower_[i].push_back(std::make_pair(j, w_[j]));
+                        } else if (j > i) {
+                            upper_[i].push_back(std::make_pair(j, w_[j]));
+                        } else {
+                            diag_[i] = w_[j];
+                        }
+                        w_[j] = 0.0;
+                        used_[j] = 0;
+                    }
+                    if (std::fabs(diag_[i]) < 1e-14) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            // Overwrite x with the solution of LUy = x.
+            void solve(std::vector<double>& x) const
+            {
+                const int n = diag_.size();
+                for (int i = 0; i < n; ++i) {
+                    for (Row::const_iterator it = lower_[i].begin(); it != lower_[i].end(); ++it) {
+                        x[i] -= it->second*x[it->first];
+                    }
+                }
+                for (int i = n - 1; i >= 0; --i) {
+                    for (Row::const_iterator it = upper_[i].begin(); it != upper_[i].end(); ++it) {
+                        x[i] -= it->second*x[it->first];
+                    }
+                    x[i] /= diag_[i];
+                }
+            }
+
+        private:
+            // Add column j to the pattern of the current row. Columns
+            // left of the diagonal row are also queued for elimination.
+            void addToPattern(const int j, const int row)
+            {
+                if (!used_[j]) {
+                    used_[j] = 1;
+                    pattern_.push_back(j);
+                    if (j < row) {
+                        pending_.push_back(j);
+                    }
+                }
+            }
+
+            std::vector<Row> lower_;
+            std::vector<Row> upper_;
+            std::vector<double> diag_;
+            // Work arrays for the row being factored.
+            std::vector<double> w_;
+            std::vector<char> used_;
+            std::vector<int> pattern_;
+            std::vector<int> pending_;   // Sorted columns left to eliminate.
+        };
+
+        // Sets pos[cells[i]] = i for a multicell component and resets
+        // those entries to -1 on scope exit, so that the map costs
+        // O(num_cells) per component rather than O(number of cells).
+        class ComponentPositions
+        {
+        public:
+            ComponentPositions(std::vector<int>& pos, const int num_cells, const int* cells)
+                : pos_(pos), num_cells_(num_cells), cells_(cells)
+            {
+                for (int i = 0; i < num_cells_; ++i) {
+                    pos_[cells_[i]] = i;
+                }
+            }
+            ~ComponentPositions()
+            {
+                for (int i = 0; i < num_cells_; ++i) {
+                    pos_[cells_[i]] = -1;
+                }
+            }
+        private:
+            std::vector<int>& pos_;
+            const int num_cells_;
+            const int* cells_;
+        };
+    } // anonymous namespace
 
 
     TransportSolverTwophaseReorder::TransportSolverTwophaseReorder(const UnstructuredGrid& grid,
                                                                    const Opm::IncompPropertiesInterface& props,
                                                                    const double* gravity,
                                                                    const double tol,
-                                                                   const int maxit)
+                                                                   const int maxit,
+                                                                   const ReorderSingleCellMethod method,
+                                                                   const bool multicell_newton)
         : grid_(grid),
           props_(props),
           tol_(tol),
           maxit_(maxit),
+          method_(method),
+          multicell_newton_(multicell_newton),
           darcyflux_(0),
           source_(0),
           dt_(0.0),
           saturation_(grid.number_of_cells, -1.0),
           fractionalflow_(grid.number_of_cells, -1.0),
           reorder_iterations_(grid.number_of_cells, 0),
-          mob_(2*grid.number_of_cells, -1.0)
+          mob_(2*grid.number_of_cells, -1.0),
+          multicell_pos_(grid.number_of_cells, -1)
 #ifdef EXPERIMENT_GAUSS_SEIDEL
         , ia_upw_(grid.number_of_cells + 1, -1),
           ja_upw_(grid.number_of_faces, -1),
@@ -95,6 +258,7 @@ namespace Opm
                                                const double dt,
                                                TwophaseState& state)
     {
+        OPM_TIMER_SCOPE("transport");
         darcyflux_ = &state.faceflux()[0];
         porevolume_ = porevolume;
         source_ = source;
@@ -117,6 +281,8 @@ namespace Opm
 #endif
         std::fill(reorder_iterations_.begin(),reorder_iterations_.end(),0);
         reorderAndTransport(grid_, darcyflux_);
+        OPM_COUNTER_ADD("root finder iterations",
+                        std::accumulate(reorder_iterations_.begin(), reorder_iterations_.end(), 0));
         toBothSat(saturation_, state.saturation());
     }
 
@@ -141,6 +307,8 @@ namespace Opm
         double outflux;   // sum_j max(v_ij, 0) - q
         double comp_term; // q - sum_j v_ij
         double dtpv;    // dt/pv(i)
+        double upw_flux;  // sum_j |min(v_ij, 0)| + max(q, 0)
+        double upw_sat;   // sum_j |min(v_ij, 0)|*s_j + max(q, 0)
         const TransportSolverTwophaseReorder& tm;
         explicit Residual(const TransportSolverTwophaseReorder& tmodel, int cell_index)
             : tm(tmodel)
@@ -153,6 +321,9 @@ namespace Opm
             influx  =  src_is_inflow ? src_flux : 0.0;
             outflux = !src_is_inflow ? src_flux : 0.0;
             dtpv    = tm.dt_/tm.porevolume_[cell];
+            // Injected fluid is water.
+            upw_flux = src_is_inflow ? -src_flux : 0.0;
+            upw_sat  = upw_flux;
 
             // Compute fluxes over interior edges. Boundary flow is supposed to be
             // included in the transport source term, along with well sources.
@@ -172,6 +343,8 @@ namespace Opm
                 if (other != -1) {
                     if (flux < 0.0) {
                         influx  += flux*tm.fractionalflow_[other];
+                        upw_flux -= flux;
+                        upw_sat  -= flux*tm.saturation_[other];
                     } else {
                         outflux += flux;
                     }
@@ -183,6 +356,21 @@ namespace Opm
         {
             return s - s0 + dtpv*(outflux*tm.fracFlow(s, cell) + influx);
         }
+        double operator()(double s, double& drds) const
+        {
+            double dfds = 0.0;
+            const double f = tm.fracFlow(s, cell, dfds);
+            drds = 1.0 + dtpv*outflux*dfds;
+            return s - s0 + dtpv*(outflux*f + influx);
+        }
+        // Starting point for Newton iterations: the implicit Euler
+        // solution obtained by replacing fractional flows with
+        // saturations, i.e. s0 mixed with the upwind saturations.
+        double predictor() const
+        {
+            const double s = (s0 + dtpv*upw_sat)/(1.0 + dtpv*upw_flux);
+            return std::min(std::max(s, 0.0), 1.0);
+        }
     };
 
 
@@ -195,7 +383,11 @@ namespace Opm
         // }
         int iters_used = 0;
         // saturation_[cell] = modifiedRegulaFalsi(res, smin_[2*cell], smax_[2*cell], maxit_, tol_, iters_used);
-        saturation_[cell] = RootFinder::solve(res, saturation_[cell], 0.0, 1.0, maxit_, tol_, iters_used);
+        if (method_ == ReorderNewton) {
+            saturation_[cell] = NewtonRootFinder::solve(res, res.predictor(), 0.0, 1.0, maxit_, tol_, iters_used);
+        } else {
+            saturation_[cell] = RootFinder::solve(res, saturation_[cell], 0.0, 1.0, maxit_, tol_, iters_used);
+        }
         // add if it is iteration on an out loop
         reorder_iterations_[cell] = reorder_iterations_[cell] + iters_used;
         fractionalflow_[cell] = fracFlow(saturation_[cell], cell);
@@ -326,11 +518,8 @@ namespace Opm
         std::vector<int> needs_update(num_cells, 1);
         // This one also needs the mapping from all cells to
         // the strongly connected subset to filter out connections
-        std::vector<int> pos(grid_.number_of_cells, -1);
-        for (int i = 0; i < num_cells; ++i) {
-            const int cell = cells[i];
-            pos[cell] = i;
-        }
+        const ComponentPositions component_pos(multicell_pos_, num_cells, cells);
+        const std::vector<int>& pos = multicell_pos_;
 
         // Note: partially copied from below.
         const double tol = 1e-9;
@@ -346,6 +535,15 @@ namespace Opm
             s0[i] = saturation_[cell];
             // num_upstream[i] = ia_upw_[cell + 1] - ia_upw_[cell];
         }
+        // Large components go straight to local Newton, with
+        // Gauss-Seidel as the fallback if that fails.
+        bool newton_tried = !multicell_newton_;
+        if (!newton_tried && num_cells >= multicell_newton_min_cells) {
+            newton_tried = true;
+            if (solveMultiCellNewton(num_cells, cells, s0)) {
+                return;
+            }
+        }
         // Solve once in each cell.
         // std::vector<int> fully_marked_stack;
         // fully_marked_stack.reserve(num_cells);
@@ -407,6 +605,15 @@ namespace Opm
             // std::cout << "Iter = " << num_iters << "    update_count = " << update_count
             //        << "    # marked cells = "
             //        << std::accumulate(needs_update.begin(), needs_update.end(), 0) << std::endl;
+            // Hand a stagnating iteration over to local Newton,
+            // starting from the current iterate.
+            if (update_count > 0 && !newton_tried && num_iters + 1 >= multicell_gs_max_sweeps) {
+                newton_tried = true;
+                if (solveMultiCellNewton(num_cells, cells, s0)) {
+                    OPM_COUNTER_ADD("multicell iterations", num_iters + 1);
+                    return;
+                }
+            }
         } while (update_count > 0 && ++num_iters < max_iters);
 
         // Done with iterations, check if we succeeded.
@@ -414,8 +621,9 @@ namespace Opm
             OPM_THROW(std::runtime_error, "In solveMultiCell(), we did not converge after "
                   << num_iters << " iterations. Remaining update count = " << update_count);
         }
-        std::cout << "Solved " << num_cells << " cell multicell problem in "
-                  << num_iters << " iterations." << std::endl;
+        OPM_COUNTER_ADD("multicell iterations", num_iters);
+        OPM_BUFFERED_LOG(BufferedLog::Detailed, "Solved " << num_cells << " cell multicell problem in "
+                         << num_iters << " iterations.");
 
 #else
         double max_s_change = 0.0;
@@ -450,11 +658,124 @@ namespace Opm
             OPM_THROW(std::runtime_error, "In solveMultiCell(), we did not converge after "
                   << num_iters << " iterations. Delta s = " << max_s_change);
         }
-        std::cout << "Solved " << num_cells << " cell multicell problem in "
-                  << num_iters << " iterations." << std::endl;
+        OPM_COUNTER_ADD("multicell iterations", num_iters);
+        OPM_BUFFERED_LOG(BufferedLog::Detailed, "Solved " << num_cells << " cell multicell problem in "
+                         << num_iters << " iterations.");
 #endif // EXPERIMENT_GAUSS_SEIDEL
     }
 
+
+
+    // Solve a multicell component with Newton's method, using the
+    // current saturations as initial guess. The residual is the
+    // single-cell residual of every cell in the component,
+    //
+    //     r_i(s) = s_i - s0_i + dt/pv_i*( influx_i(s) + outflux_i*f(s_i) ),
+    //
+    // where the influx from upwind cells in the component depends on
+    // their saturations. Returns false, leaving the saturations as
+    // they were, if Newton does not converge. Must be called from
+    // solveMultiCell(), which maintains multicell_pos_.
+    bool TransportSolverTwophaseReorder::solveMultiCellNewton(const int num_cells,
+                                                              const int* cells,
+                                                              const std::vector<double>& s0)
+    {
+        OPM_TIMER_SCOPE("multicell newton");
+        // Positions within the component, set up by solveMultiCell().
+        const std::vector<int>& pos = multicell_pos_;
+        std::vector<double> s_start(num_cells);
+        for (int i = 0; i < num_cells; ++i) {
+            s_start[i] = saturation_[cells[i]];
+        }
+        std::vector<double> dfds(num_cells);
+        std::vector<double> res(num_cells);
+        std::vector<SparseLU::Row> jac(num_cells);
+        SparseLU lu;
+        bool converged = false;
+        int iter = 0;
+        for (; iter < multicell_newton_max_iters; ++iter) {
+            for (int i = 0; i < num_cells; ++i) {
+                const int cell = cells[i];
+                fractionalflow_[cell] = fracFlow(saturation_[cell], cell, dfds[i]);
+            }
+            // Assemble residual and Jacobian.
+            double max_res = 0.0;
+            for (int i = 0; i < num_cells; ++i) {
+                const int cell = cells[i];
+                const double dtpv = dt_/porevolume_[cell];
+                const double src_flux = -source_[cell];
+                const bool src_is_inflow = src_flux < 0.0;
+                double influx  =  src_is_inflow ? src_flux : 0.0;
+                double outflux = !src_is_inflow ? src_flux : 0.0;
+                SparseLU::Row& row = jac[i];
+                row.clear();
+                for (int hf = grid_.cell_facepos[cell]; hf < grid_.cell_facepos[cell+1]; ++hf) {
+                    const int f = grid_.cell_faces[hf];
+                    double flux;
+                    int other;
+                    if (cell == grid_.face_cells[2*f]) {
+                        flux  = darcyflux_[f];
+                        other = grid_.face_cells[2*f+1];
+                    } else {
+                        flux  =-darcyflux_[f];
+                        other = grid_.face_cells[2*f];
+                    }
+                    if (other != -1) {
+                        if (flux < 0.0) {
+                            influx += flux*fractionalflow_[other];
+                            const int j = pos[other];
+                            if (j != -1) {
+                                row.push_back(std::make_pair(j, dtpv*flux*dfds[j]));
+                            }
+                        } else {
+                            outflux += flux;
+                        }
+                    }
+                }
+                const double s = saturation_[cell];
+                res[i] = s - s0[i] + dtpv*(outflux*fractionalflow_[cell] + influx);
+                row.push_back(std::make_pair(i, 1.0 + dtpv*outflux*dfds[i]));
+                max_res = std::max(max_res, std::fabs(res[i]));
+            }
+            if (max_res < tol_) {
+                converged = true;
+                break;
+            }
+            if (!lu.factor(jac)) {
+                break;
+            }
+            lu.solve(res);
+            // Chop the update if it changes any saturation too much.
+            double max_ds = 0.0;
+            for (int i = 0; i < num_cells; ++i) {
+                max_ds = std::max(max_ds, std::fabs(res[i]));
+            }
+            const double scale = max_ds > multicell_newton_max_ds ? multicell_newton_max_ds/max_ds : 1.0;
+            for (int i = 0; i < num_cells; ++i) {
+                double& s = saturation_[cells[i]];
+                s = std::min(std::max(s - scale*res[i], 0.0), 1.0);
+            }
+        }
+
+        if (!converged) {
+            for (int i = 0; i < num_cells; ++i) {
+                const int cell = cells[i];
+                saturation_[cell] = s_start[i];
+                fractionalflow_[cell] = fracFlow(saturation_[cell], cell);
+            }
+            OPM_BUFFERED_LOG(BufferedLog::Detailed, "Local Newton failed for " << num_cells
+                             << " cell multicell problem after " << iter << " iterations.");
+            return false;
+        }
+        for (int i = 0; i < num_cells; ++i) {
+            reorder_iterations_[cells[i]] += iter;
+        }
+        OPM_COUNTER_ADD("multicell newton iterations", iter);
+        OPM_BUFFERED_LOG(BufferedLog::Detailed, "Solved " << num_cells << " cell multicell problem by local Newton in "
+                         << iter << " iterations.");
+        return true;
+    }
+
     double TransportSolverTwophaseReorder::fracFlow(double s, int cell) const
     {
         double sat[2] = { s, 1.0 - s };
@@ -466,6 +787,24 @@ namespace Opm
     }
 
 
+    double TransportSolverTwophaseReorder::fracFlow(double s, int cell, double& dfds) const
+    {
+        double sat[2] = { s, 1.0 - s };
+        double mob[2];
+        double dmob[4];
+        props_.relperm(1, sat, &cell, mob, dmob);
+        // dmob is column-major, dmob[i + 2*j] = d(kr_i)/d(s_j), and
+        // d(s_1)/d(s) = -1.
+        const double dmob0 = (dmob[0] - dmob[2])/visc_[0];
+        const double dmob1 = (dmob[1] - dmob[3])/visc_[1];
+        mob[0] /= visc_[0];
+        mob[1] /= visc_[1];
+        const double tmob = mob[0] + mob[1];
+        dfds = (dmob0*mob[1] - mob[0]*dmob1)/(tmob*tmob);
+        return mob[0]/tmob;
+    }
+
+
 
 
 
@@ -643,6 +982,7 @@ namespace Opm
                                                       const double dt,
                                                       TwophaseState& state)
     {
+        OPM_TIMER_SCOPE("gravity segregation");
         // Initialize mobilities.
         const int nc = grid_.number_of_cells;
         std::vector<int> cells(nc);
@@ -668,8 +1008,9 @@ namespace Opm
             // std::cout << "==== new column" << std::endl;
             num_iters += solveGravityColumn(columns_[i]);
         }
-        std::cout << "Gauss-Seidel column solver average iterations: "
-                  << double(num_iters)/double(columns_.size()) << std::endl;
+        OPM_BUFFERED_LOG(BufferedLog::Summary, "Gauss-Seidel column solver average iterations: "
+                         << double(num_iters)/double(columns_.size()));
+        BufferedLog::flush();
 
         toBothSat(saturation_, state.saturation());
     }
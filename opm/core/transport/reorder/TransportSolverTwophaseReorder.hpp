@@ -42,11 +42,17 @@ namespace Opm
         /// \param[in] gravity   Gravity vector (null for no gravity).
         /// \param[in] tol       Tolerance used in the solver.
         /// \param[in] maxit     Maximum number of non-linear iterations used.
+        /// \param[in] method    Root finder used for single-cell problems.
+        /// \param[in] multicell_newton  If false, strongly connected components
+        ///                              are solved by Gauss-Seidel only, never
+        ///                              by local Newton.
         TransportSolverTwophaseReorder(const UnstructuredGrid& grid,
                                        const Opm::IncompPropertiesInterface& props,
                                        const double* gravity,
                                        const double tol,
-                                       const int maxit);
+                                       const int maxit,
+                                       const ReorderSingleCellMethod method = ReorderRegulaFalsi,
+                                       const bool multicell_newton = true);
 
         // Virtual destructor.
         virtual ~TransportSolverTwophaseReorder();
@@ -85,6 +91,9 @@ namespace Opm
         void initColumns();
         virtual void solveSingleCell(const int cell);
         virtual void solveMultiCell(const int num_cells, const int* cells);
+        bool solveMultiCellNewton(const int num_cells,
+                                  const int* cells,
+                                  const std::vector<double>& s0);
 
         void solveSingleCellGravity(const std::vector<int>& cells,
                                     const int pos,
@@ -98,6 +107,8 @@ namespace Opm
         std::vector<double> smax_;
         double tol_;
         int maxit_;
+        ReorderSingleCellMethod method_;
+        bool multicell_newton_;
 
         const double* darcyflux_;   // one flux per grid face
         const double* porevolume_;  // one volume per cell
@@ -112,6 +123,9 @@ namespace Opm
         std::vector<double> mob_;
         std::vector<double> s0_;
         std::vector<std::vector<int> > columns_;
+        // Position of each cell within the multicell component being
+        // solved, -1 for cells outside it.
+        std::vector<int> multicell_pos_;
 
         // Storing the upwind and downwind graphs for experiments.
         std::vector<int> ia_upw_;
@@ -121,6 +135,7 @@ namespace Opm
 
         struct Residual;
         double fracFlow(double s, int cell) const;
+        double fracFlow(double s, int cell, double& dfds) const;
 
         struct GravityResidual;
         void mobility(double s, int cell, double* mob) const;
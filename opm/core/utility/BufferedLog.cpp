@@ -0,0 +1,115 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/utility/BufferedLog.hpp>
+
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+namespace Opm
+{
+
+    namespace
+    {
+        // Buffers beyond this size are written by flushIfFull().
+        const std::streamoff max_buffer_size = 1 << 16;
+
+        std::mutex& sinkMutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        std::ostream*& sink()
+        {
+            static std::ostream* os = &std::cout;
+            return os;
+        }
+
+        void writeToSink(const std::string& text)
+        {
+            std::lock_guard<std::mutex> lock(sinkMutex());
+            sink()->write(text.data(), text.size());
+            sink()->flush();
+        }
+
+        // Writes any remaining output when the owning thread exits.
+        struct ThreadBuffer
+        {
+            std::ostringstream os;
+            ~ThreadBuffer()
+            {
+                const std::string text = os.str();
+                if (!text.empty()) {
+                    writeToSink(text);
+                }
+            }
+        };
+
+        ThreadBuffer& threadBuffer()
+        {
+            thread_local ThreadBuffer buffer;
+            return buffer;
+        }
+    } // anonymous namespace
+
+
+    std::atomic<int> BufferedLog::verbosity_(BufferedLog::Summary);
+
+
+    void BufferedLog::setVerbosity(const int verbosity)
+    {
+        verbosity_.store(verbosity, std::memory_order_relaxed);
+    }
+
+
+    void BufferedLog::setSink(std::ostream& os)
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex());
+        sink() = &os;
+    }
+
+
+    std::ostream& BufferedLog::stream()
+    {
+        return threadBuffer().os;
+    }
+
+
+    void BufferedLog::flush()
+    {
+        std::ostringstream& os = threadBuffer().os;
+        const std::string text = os.str();
+        if (!text.empty()) {
+            writeToSink(text);
+            os.str(std::string());
+        }
+    }
+
+
+    void BufferedLog::flushIfFull()
+    {
+        if (threadBuffer().os.tellp() > max_buffer_size) {
+            flush();
+        }
+    }
+
+} // namespace Opm
@@ -0,0 +1,97 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BUFFEREDLOG_HEADER_INCLUDED
+#define OPM_BUFFEREDLOG_HEADER_INCLUDED
+
+#include <atomic>
+#include <ostream>
+
+namespace Opm
+{
+
+    /// Verbosity-filtered, buffered progress output for solvers.
+    ///
+    /// Messages are only formatted if their level is enabled, and are
+    /// then appended to a buffer owned by the calling thread, so that
+    /// logging from inner loops takes no locks and does no I/O. The
+    /// buffer is written to the sink (std::cout unless changed) by
+    /// flush(), which solvers call once at the end of each solve, or
+    /// when it grows large.
+    class BufferedLog
+    {
+    public:
+        /// Message levels. A message is kept if its level is less than
+        /// or equal to the current verbosity.
+        enum Level {
+            Silent = 0,     // Use as verbosity only: suppress everything.
+            Summary = 1,    // One line per solve.
+            Iterations = 2, // One line per nonlinear iteration.
+            Detailed = 3    // Per component or per column details.
+        };
+
+        /// Set the verbosity for all threads. The default is Summary.
+        static void setVerbosity(const int verbosity);
+
+        /// Current verbosity.
+        static int verbosity()
+        {
+            return verbosity_.load(std::memory_order_relaxed);
+        }
+
+        /// True if messages of the given level should be written.
+        static bool enabled(const int level)
+        {
+            return level <= verbosity();
+        }
+
+        /// Set the stream flush() writes to. The stream must outlive
+        /// all later calls to flush().
+        static void setSink(std::ostream& os);
+
+        /// The calling thread's buffer. Terminate messages with '\n'
+        /// rather than std::endl, and call flush() when done.
+        static std::ostream& stream();
+
+        /// Write the calling thread's buffer to the sink, if it is
+        /// not empty, and clear it.
+        static void flush();
+
+        /// Flush the calling thread's buffer if it has grown beyond
+        /// a fixed size.
+        static void flushIfFull();
+
+    private:
+        static std::atomic<int> verbosity_;
+    };
+
+} // namespace Opm
+
+
+/// Write a message to the calling thread's log buffer if the level is
+/// enabled. The message expression is not evaluated otherwise.
+#define OPM_BUFFERED_LOG(level, message)                                \
+    do {                                                                \
+        if (::Opm::BufferedLog::enabled(level)) {                       \
+            ::Opm::BufferedLog::stream() << message << '\n';            \
+            ::Opm::BufferedLog::flushIfFull();                          \
+        }                                                               \
+    } while (false)
+
+#endif // OPM_BUFFEREDLOG_HEADER_INCLUDED
@@ -0,0 +1,426 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "config.h"
+#include <opm/core/utility/GridRenumbering.hpp>
+#include <opm/core/utility/Instrumentation.hpp>
+#include <opm/core/grid.h>
+#include <opm/common/ErrorMacros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace Opm
+{
+
+    namespace
+    {
+
+        // Cell neighbours through faces, without duplicates, in
+        // compressed row form.
+        void cellNeighbours(const UnstructuredGrid& grid,
+                            std::vector<int>& start,
+                            std::vector<int>& nbs)
+        {
+            const int nc = grid.number_of_cells;
+            start.assign(nc + 1, 0);
+            nbs.clear();
+            nbs.reserve(grid.cell_facepos[nc]);
+            for (int cell = 0; cell < nc; ++cell) {
+                for (int hface = grid.cell_facepos[cell]; hface < grid.cell_facepos[cell + 1]; ++hface) {
+                    const int face = grid.cell_faces[hface];
+                    const int c0 = grid.face_cells[2*face];
+                    const int other = (c0 == cell) ? grid.face_cells[2*face + 1] : c0;
+                    if (other >= 0 && other != cell) {
+                        nbs.push_back(other);
+                    }
+                }
+                std::sort(nbs.begin() + start[cell], nbs.end());
+                nbs.erase(std::unique(nbs.begin() + start[cell], nbs.end()), nbs.end());
+                start[cell + 1] = nbs.size();
+            }
+        }
+
+        // Breadth-first search from root, visiting neighbours in
+        // increasing degree. Appends the visited cells to order, marks
+        // them in level, and returns the number of levels.
+        int levelSearch(const std::vector<int>& start,
+                        const std::vector<int>& nbs,
+                        const int root,
+                        std::vector<int>& level,
+                        std::vector<int>& order)
+        {
+            std::size_t head = order.size();
+            order.push_back(root);
+            level[root] = 0;
+            int num_levels = 1;
+            std::vector<int> next;
+            while (head < order.size()) {
+                const int cell = order[head++];
+                next.assign(nbs.begin() + start[cell], nbs.begin() + start[cell + 1]);
+                std::stable_sort(next.begin(), next.end(),
+                                 [&](const int a, const int b)
+                                 { return start[a + 1] - start[a] < start[b + 1] - start[b]; });
+                for (const int nb : next) {
+                    if (level[nb] < 0) {
+                        level[nb] = level[cell] + 1;
+                        num_levels = level[nb] + 1;
+                        order.push_back(nb);
+                    }
+                }
+            }
+            return num_levels;
+        }
+
+        // Hilbert index of a point with integer coordinates of the
+        // given number of bits, after J. Skilling, "Programming the
+        // Hilbert curve", AIP Conf. Proc. 707 (2004). Destroys x.
+        std::uint64_t hilbertIndex(unsigned* x, const int dim, const int bits)
+        {
+            const unsigned m = 1u << (bits - 1);
+            // Inverse undo.
+            for (unsigned q = m; q > 1; q >>= 1) {
+                const unsigned p = q - 1;
+                for (int i = 0; i < dim; ++i) {
+                    if (x[i] & q) {
+                        x[0] ^= p;
+                    } else {
+                        const unsigned t = (x[0] ^ x[i]) & p;
+                        x[0] ^= t;
+                        x[i] ^= t;
+                    }
+                }
+            }
+            // Gray encode.
+            for (int i = 1; i < dim; ++i) {
+                x[i] ^= x[i - 1];
+            }
+            unsigned t = 0;
+            for (unsigned q = m; q > 1; q >>= 1) {
+                if (x[dim - 1] & q) {
+                    t ^= q - 1;
+                }
+            }
+            for (int i = 0; i < dim; ++i) {
+                x[i] ^= t;
+            }
+            // Interleave the bits of the transposed index.
+            std::uint64_t index = 0;
+            for (int b = bits - 1; b >= 0; --b) {
+                for (int i = 0; i < dim; ++i) {
+                    index = (index << 1) | ((x[i] >> b) & 1u);
+                }
+            }
+            return index;
+        }
+
+        template <typename T>
+        T* allocateArray(const std::size_t n)
+        {
+            T* p = static_cast<T*>(std::malloc(n*sizeof(T)));
+            if (p == 0 && n > 0) {
+                OPM_THROW(std::runtime_error, "GridRenumbering: out of memory.");
+            }
+            return p;
+        }
+
+    } // anonymous namespace
+
+
+
+
+    /// Cell ordering by reverse Cuthill-McKee.
+    std::vector<int> reverseCuthillMcKeeOrder(const UnstructuredGrid& grid)
+    {
+        OPM_TIMER_SCOPE("reverse Cuthill-McKee ordering");
+        const int nc = grid.number_of_cells;
+        std::vector<int> start;
+        std::vector<int> nbs;
+        cellNeighbours(grid, start, nbs);
+
+        std::vector<int> order;
+        order.reserve(nc);
+        std::vector<int> level(nc, -1);
+        std::vector<int> trial;
+        std::vector<int> trial_level(nc, -1);
+        for (int seed = 0; seed < nc; ++seed) {
+            if (level[seed] >= 0) {
+                continue;
+            }
+            // Find a pseudo-peripheral cell of the component: repeat
+            // the search from a least connected cell of the last level
+            // as long as the number of levels grows.
+            int root = seed;
+            int num_levels = 0;
+            for (int iter = 0; iter < 10; ++iter) {
+                trial.clear();
+                const int levels = levelSearch(start, nbs, root, trial_level, trial);
+                int candidate = root;
+                for (const int cell : trial) {
+                    if (trial_level[cell] == levels - 1
+                        && (candidate == root
+                            || start[cell + 1] - start[cell] < start[candidate + 1] - start[candidate])) {
+                        candidate = cell;
+                    }
+                }
+                for (const int cell : trial) {
+                    trial_level[cell] = -1;
+                }
+                if (levels <= num_levels) {
+                    break;
+                }
+                num_levels = levels;
+                if (candidate == root) {
+                    break;
+                }
+                root = candidate;
+            }
+            levelSearch(start, nbs, root, level, order);
+        }
+        std::reverse(order.begin(), order.end());
+        return order;
+    }
+
+
+
+
+    /// Cell ordering along a Hilbert curve through the cell centroids.
+    std::vector<int> hilbertOrder(const UnstructuredGrid& grid)
+    {
+        OPM_TIMER_SCOPE("Hilbert curve ordering");
+        const int nc = grid.number_of_cells;
+        const int dim = grid.dimensions;
+        if (dim < 1 || dim > 3) {
+            OPM_THROW(std::runtime_error, "hilbertOrder() requires a grid with at most 3 dimensions.");
+        }
+        // 20 bits per coordinate keeps 3d keys within 64 bits.
+        const int bits = 20;
+
+        std::vector<double> lo(dim, std::numeric_limits<double>::max());
+        std::vector<double> hi(dim, -std::numeric_limits<double>::max());
+        for (int cell = 0; cell < nc; ++cell) {
+            for (int dd = 0; dd < dim; ++dd) {
+                lo[dd] = std::min(lo[dd], grid.cell_centroids[dim*cell + dd]);
+                hi[dd] = std::max(hi[dd], grid.cell_centroids[dim*cell + dd]);
+            }
+        }
+        // Same scale in all directions, to keep the curve from
+        // stretching along thin dimensions.
+        double extent = 0.0;
+        for (int dd = 0; dd < dim; ++dd) {
+            extent = std::max(extent, hi[dd] - lo[dd]);
+        }
+        const double maxcoord = double((1u << bits) - 1);
+        const double scale = extent > 0.0 ? maxcoord / extent : 0.0;
+
+        std::vector<std::uint64_t> key(nc);
+#pragma omp parallel for schedule(static)
+        for (int cell = 0; cell < nc; ++cell) {
+            unsigned x[3] = { 0, 0, 0 };
+            for (int dd = 0; dd < dim; ++dd) {
+                const double s = (grid.cell_centroids[dim*cell + dd] - lo[dd])*scale;
+                x[dd] = unsigned(std::min(std::max(s, 0.0), maxcoord));
+            }
+            key[cell] = hilbertIndex(x, dim, bits);
+        }
+
+        std::vector<int> order(nc);
+        for (int cell = 0; cell < nc; ++cell) {
+            order[cell] = cell;
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](const int a, const int b) { return key[a] < key[b]; });
+        return order;
+    }
+
+
+
+
+    // --------  Methods of class GridRenumbering  --------
+
+
+    /// Renumber grid cells with the given method.
+    GridRenumbering::GridRenumbering(const UnstructuredGrid& grid,
+                                     const Method method)
+        : cell_order_(method == Hilbert ? hilbertOrder(grid) : reverseCuthillMcKeeOrder(grid)),
+          grid_(0)
+    {
+        init(grid);
+    }
+
+
+
+    /// Renumber grid cells in a given order.
+    GridRenumbering::GridRenumbering(const UnstructuredGrid& grid,
+                                     const std::vector<int>& cell_order)
+        : cell_order_(cell_order),
+          grid_(0)
+    {
+        init(grid);
+    }
+
+
+
+    GridRenumbering::~GridRenumbering()
+    {
+        destroy_grid(grid_);
+    }
+
+
+
+    void GridRenumbering::init(const UnstructuredGrid& g)
+    {
+        OPM_TIMER_SCOPE("grid renumbering");
+        const int nc = g.number_of_cells;
+        const int nf = g.number_of_faces;
+        const int dim = g.dimensions;
+
+        // Check and invert the cell permutation.
+        if (int(cell_order_.size()) != nc) {
+            OPM_THROW(std::runtime_error, "GridRenumbering: cell order has size "
+                      << cell_order_.size() << ", expected " << nc << ".");
+        }
+        new_cell_.assign(nc, -1);
+        for (int cell = 0; cell < nc; ++cell) {
+            const int old = cell_order_[cell];
+            if (old < 0 || old >= nc || new_cell_[old] >= 0) {
+                OPM_THROW(std::runtime_error, "GridRenumbering: cell order is not a permutation.");
+            }
+            new_cell_[old] = cell;
+        }
+
+        // Number the faces as they are met through the new cells.
+        std::vector<int> new_face(nf, -1);
+        face_order_.clear();
+        face_order_.reserve(nf);
+        for (const int old : cell_order_) {
+            for (int hface = g.cell_facepos[old]; hface < g.cell_facepos[old + 1]; ++hface) {
+                const int face = g.cell_faces[hface];
+                if (new_face[face] < 0) {
+                    new_face[face] = face_order_.size();
+                    face_order_.push_back(face);
+                }
+            }
+        }
+        for (int face = 0; face < nf; ++face) {
+            if (new_face[face] < 0) {
+                new_face[face] = face_order_.size();
+                face_order_.push_back(face);
+            }
+        }
+
+        // Owned here until complete, so that it is released if an
+        // allocation below throws.
+        std::unique_ptr<UnstructuredGrid, void (*)(UnstructuredGrid*)>
+            grid(allocate_grid(dim, nc, nf, g.face_nodepos[nf], g.cell_facepos[nc], g.number_of_nodes),
+                 destroy_grid);
+        if (!grid) {
+            OPM_THROW(std::runtime_error, "GridRenumbering: could not allocate grid.");
+        }
+        UnstructuredGrid& r = *grid;
+
+        std::copy(g.node_coordinates, g.node_coordinates + dim*g.number_of_nodes, r.node_coordinates);
+
+        // Faces.
+        r.face_nodepos[0] = 0;
+        for (int face = 0; face < nf; ++face) {
+            const int old = face_order_[face];
+            const int* begin = g.face_nodes + g.face_nodepos[old];
+            const int* end = g.face_nodes + g.face_nodepos[old + 1];
+            std::copy(begin, end, r.face_nodes + r.face_nodepos[face]);
+            r.face_nodepos[face + 1] = r.face_nodepos[face] + (end - begin);
+            for (int side = 0; side < 2; ++side) {
+                const int c = g.face_cells[2*old + side];
+                r.face_cells[2*face + side] = c >= 0 ? new_cell_[c] : c;
+            }
+            r.face_areas[face] = g.face_areas[old];
+            for (int dd = 0; dd < dim; ++dd) {
+                r.face_centroids[dim*face + dd] = g.face_centroids[dim*old + dd];
+                r.face_normals[dim*face + dd] = g.face_normals[dim*old + dd];
+            }
+        }
+
+        // Cells.
+        if (g.cell_facetag != 0) {
+            r.cell_facetag = allocateArray<int>(g.cell_facepos[nc]);
+        }
+        r.global_cell = allocateArray<int>(nc);
+        r.cell_facepos[0] = 0;
+        for (int cell = 0; cell < nc; ++cell) {
+            const int old = cell_order_[cell];
+            int hface = r.cell_facepos[cell];
+            for (int ohface = g.cell_facepos[old]; ohface < g.cell_facepos[old + 1]; ++ohface, ++hface) {
+                r.cell_faces[hface] = new_face[g.cell_faces[ohface]];
+                if (r.cell_facetag != 0) {
+                    r.cell_facetag[hface] = g.cell_facetag[ohface];
+                }
+            }
+            r.cell_facepos[cell + 1] = hface;
+            r.cell_volumes[cell] = g.cell_volumes[old];
+            for (int dd = 0; dd < dim; ++dd) {
+                r.cell_centroids[dim*cell + dd] = g.cell_centroids[dim*old + dd];
+            }
+            r.global_cell[cell] = g.global_cell != 0 ? g.global_cell[old] : old;
+        }
+        std::copy(g.cartdims, g.cartdims + 3, r.cartdims);
+
+        grid_ = grid.release();
+    }
+
+
+
+    /// The renumbered grid.
+    const UnstructuredGrid& GridRenumbering::grid() const
+    {
+        return *grid_;
+    }
+
+
+
+    /// Original index of each cell in the new numbering.
+    const std::vector<int>& GridRenumbering::cellOrder() const
+    {
+        return cell_order_;
+    }
+
+
+
+    /// Original index of each face in the new numbering.
+    const std::vector<int>& GridRenumbering::faceOrder() const
+    {
+        return face_order_;
+    }
+
+
+
+    /// Replace original cell indices by new ones, in place.
+    void GridRenumbering::renumberCells(const int num, int* cells) const
+    {
+        for (int i = 0; i < num; ++i) {
+            if (cells[i] >= 0) {
+                cells[i] = new_cell_[cells[i]];
+            }
+        }
+    }
+
+} // namespace Opm
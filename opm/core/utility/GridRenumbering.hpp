@@ -0,0 +1,170 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OPM_GRIDRENUMBERING_HEADER_INCLUDED
+#define OPM_GRIDRENUMBERING_HEADER_INCLUDED
+
+#include <vector>
+
+struct UnstructuredGrid;
+
+namespace Opm
+{
+
+    /// Cell ordering by reverse Cuthill-McKee on the graph of cells
+    /// connected by faces. Each connected component is started from a
+    /// pseudo-peripheral cell. The result maps new to original cell
+    /// indices, so that cell i of the new ordering is result[i].
+    std::vector<int> reverseCuthillMcKeeOrder(const UnstructuredGrid& grid);
+
+    /// Cell ordering along a Hilbert curve through the cell centroids.
+    /// The result maps new to original cell indices.
+    std::vector<int> hilbertOrder(const UnstructuredGrid& grid);
+
+
+
+
+    /// A copy of a grid with cells and faces renumbered for locality,
+    /// along with the mappings between the two numberings.
+    ///
+    /// Faces are numbered in the order they are first met when going
+    /// through the cells in their new order, so that the faces of a
+    /// cell are close to each other and to those of its neighbours.
+    /// Faces keep their orientation, so that face fluxes need no sign
+    /// changes, and nodes are not renumbered. The global_cell array of
+    /// the renumbered grid refers to the same logical cartesian cells
+    /// as the original one.
+    ///
+    /// Solvers set up with the renumbered grid take cell and face
+    /// arrays in the new numbering. Use toRenumberedCells() and
+    /// toRenumberedFaces() to convert inputs such as rock properties,
+    /// toOriginalCells() and toOriginalFaces() to convert results back,
+    /// and renumberCells() for cell indices such as well cells.
+    class GridRenumbering
+    {
+    public:
+        enum Method { ReverseCuthillMcKee, Hilbert };
+
+        /// Renumber grid cells with the given method.
+        /// \param[in] grid         A 2d or 3d grid.
+        /// \param[in] method       Cell ordering method.
+        explicit GridRenumbering(const UnstructuredGrid& grid,
+                                 const Method method = ReverseCuthillMcKee);
+
+        /// Renumber grid cells in a given order.
+        /// \param[in] grid         A 2d or 3d grid.
+        /// \param[in] cell_order   Original index of each cell in the new
+        ///                         numbering, a permutation of the cells.
+        GridRenumbering(const UnstructuredGrid& grid,
+                        const std::vector<int>& cell_order);
+
+        ~GridRenumbering();
+
+        /// The renumbered grid.
+        const UnstructuredGrid& grid() const;
+
+        /// Original index of each cell in the new numbering.
+        const std::vector<int>& cellOrder() const;
+
+        /// Original index of each face in the new numbering.
+        const std::vector<int>& faceOrder() const;
+
+        /// Replace original cell indices by new ones, in place.
+        /// Negative indices (such as for outside cells) are kept.
+        void renumberCells(const int num, int* cells) const;
+
+        /// Convert a cell array in the original numbering, with block
+        /// values per cell, to the new numbering.
+        template <typename T>
+        void toRenumberedCells(const T* original, const int block,
+                               std::vector<T>& renumbered) const
+        {
+            gather(cell_order_, original, block, renumbered);
+        }
+
+        /// Convert a cell array in the new numbering, with block
+        /// values per cell, to the original numbering.
+        template <typename T>
+        void toOriginalCells(const T* renumbered, const int block,
+                             std::vector<T>& original) const
+        {
+            scatter(cell_order_, renumbered, block, original);
+        }
+
+        /// Convert a face array in the original numbering, with block
+        /// values per face, to the new numbering.
+        template <typename T>
+        void toRenumberedFaces(const T* original, const int block,
+                               std::vector<T>& renumbered) const
+        {
+            gather(face_order_, original, block, renumbered);
+        }
+
+        /// Convert a face array in the new numbering, with block
+        /// values per face, to the original numbering.
+        template <typename T>
+        void toOriginalFaces(const T* renumbered, const int block,
+                             std::vector<T>& original) const
+        {
+            scatter(face_order_, renumbered, block, original);
+        }
+
+    private:
+        // No copying, the renumbered grid is owned.
+        GridRenumbering(const GridRenumbering&);
+        GridRenumbering& operator=(const GridRenumbering&);
+
+        void init(const UnstructuredGrid& grid);
+
+        template <typename T>
+        static void gather(const std::vector<int>& order, const T* in,
+                           const int block, std::vector<T>& out)
+        {
+            const int n = order.size();
+            out.resize(n*block);
+            for (int i = 0; i < n; ++i) {
+                for (int b = 0; b < block; ++b) {
+                    out[i*block + b] = in[order[i]*block + b];
+                }
+            }
+        }
+
+        template <typename T>
+        static void scatter(const std::vector<int>& order, const T* in,
+                            const int block, std::vector<T>& out)
+        {
+            const int n = order.size();
+            out.resize(n*block);
+            for (int i = 0; i < n; ++i) {
+                for (int b = 0; b < block; ++b) {
+                    out[order[i]*block + b] = in[i*block + b];
+                }
+            }
+        }
+
+        std::vector<int> cell_order_;
+        std::vector<int> new_cell_;
+        std::vector<int> face_order_;
+        UnstructuredGrid* grid_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_GRIDRENUMBERING_HEADER_INCLUDED
@@ -0,0 +1,295 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/utility/Instrumentation.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+
+namespace Opm
+{
+namespace Instrumentation
+{
+
+    namespace
+    {
+        // Innermost open scope of the calling thread.
+        struct ThreadScope
+        {
+            unsigned long generation;
+            int current;
+        };
+
+        thread_local ThreadScope thread_scope = { 0, 0 };
+
+        std::string quoted(const std::string& s)
+        {
+            std::string q = "\"";
+            for (std::string::size_type i = 0; i < s.size(); ++i) {
+                if (s[i] == '"' || s[i] == '\\') {
+                    q += '\\';
+                }
+                q += s[i];
+            }
+            q += '"';
+            return q;
+        }
+
+        // Root time is not measured, report the sum of its children.
+        double nodeSeconds(const std::vector<Node>& nodes, const int n)
+        {
+            if (nodes[n].parent != -1) {
+                return nodes[n].seconds;
+            }
+            double sum = 0.0;
+            for (std::size_t c = 0; c < nodes[n].children.size(); ++c) {
+                sum += nodes[nodes[n].children[c]].seconds;
+            }
+            return sum;
+        }
+
+        void writeCounters(std::ostream& os, const Node& node)
+        {
+            os << '{';
+            bool first = true;
+            for (auto it = node.counters.begin(); it != node.counters.end(); ++it) {
+                os << (first ? "" : ", ") << quoted(it->first)
+                   << ": {\"samples\": " << it->second.samples
+                   << ", \"sum\": " << it->second.sum
+                   << ", \"min\": " << it->second.min
+                   << ", \"max\": " << it->second.max << '}';
+                first = false;
+            }
+            os << '}';
+        }
+
+        void writeJsonNode(std::ostream& os, const std::vector<Node>& nodes,
+                           const int n, const int indent)
+        {
+            const std::string pad(indent, ' ');
+            const Node& node = nodes[n];
+            os << pad << "{\n"
+               << pad << "  \"name\": " << quoted(node.name) << ",\n"
+               << pad << "  \"calls\": " << node.calls << ",\n"
+               << pad << "  \"seconds\": " << nodeSeconds(nodes, n) << ",\n"
+               << pad << "  \"counters\": ";
+            writeCounters(os, node);
+            os << ",\n" << pad << "  \"children\": [";
+            for (std::size_t c = 0; c < node.children.size(); ++c) {
+                os << (c == 0 ? "\n" : ",\n");
+                writeJsonNode(os, nodes, node.children[c], indent + 4);
+            }
+            os << (node.children.empty() ? "" : "\n" + pad + "  ") << "]\n"
+               << pad << '}';
+        }
+
+        // Timestamps and durations are in microseconds.
+        void writeTraceNode(std::ostream& os, const std::vector<Node>& nodes,
+                            const int n, const double start, bool& first)
+        {
+            const Node& node = nodes[n];
+            os << (first ? "\n" : ",\n")
+               << "  {\"name\": " << quoted(node.name)
+               << ", \"ph\": \"X\", \"pid\": 0, \"tid\": 0"
+               << ", \"ts\": " << start
+               << ", \"dur\": " << 1e6*nodeSeconds(nodes, n)
+               << ", \"args\": {\"calls\": " << node.calls
+               << ", \"counters\": ";
+            writeCounters(os, node);
+            os << "}}";
+            first = false;
+            double child_start = start;
+            for (std::size_t c = 0; c < node.children.size(); ++c) {
+                writeTraceNode(os, nodes, node.children[c], child_start, first);
+                child_start += 1e6*nodes[node.children[c]].seconds;
+            }
+        }
+    } // anonymous namespace
+
+
+
+
+    CounterStats::CounterStats()
+        : samples(0),
+          sum(0.0),
+          min(std::numeric_limits<double>::max()),
+          max(-std::numeric_limits<double>::max())
+    {
+    }
+
+
+
+
+    void CounterStats::add(const double value)
+    {
+        ++samples;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+
+
+
+    Registry& Registry::instance()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+
+
+
+    Registry::Registry()
+        : generation_(1)
+    {
+        clear();
+    }
+
+
+
+
+    int Registry::enter(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (thread_scope.generation != generation_) {
+            thread_scope.generation = generation_;
+            thread_scope.current = 0;
+        }
+        thread_scope.current = findOrAddChild(thread_scope.current, name);
+        return thread_scope.current;
+    }
+
+
+
+
+    void Registry::leave(const int node, const double seconds)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (thread_scope.generation != generation_) {
+            // The registry was cleared while this scope was open.
+            return;
+        }
+        nodes_[node].calls += 1;
+        nodes_[node].seconds += seconds;
+        thread_scope.current = nodes_[node].parent;
+    }
+
+
+
+
+    void Registry::addToCounter(const std::string& name, const double value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (thread_scope.generation != generation_) {
+            thread_scope.generation = generation_;
+            thread_scope.current = 0;
+        }
+        nodes_[thread_scope.current].counters[name].add(value);
+    }
+
+
+
+
+    void Registry::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++generation_;
+        nodes_.assign(1, Node());
+        nodes_[0].name = "root";
+        nodes_[0].parent = -1;
+        nodes_[0].calls = 0;
+        nodes_[0].seconds = 0.0;
+    }
+
+
+
+
+    std::vector<Node> Registry::nodes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return nodes_;
+    }
+
+
+
+
+    void Registry::writeJson(std::ostream& os) const
+    {
+        const std::vector<Node> snapshot = nodes();
+        writeJsonNode(os, snapshot, 0, 0);
+        os << '\n';
+    }
+
+
+
+
+    void Registry::writeChromeTrace(std::ostream& os) const
+    {
+        const std::vector<Node> snapshot = nodes();
+        bool first = true;
+        os << "{\"traceEvents\": [";
+        writeTraceNode(os, snapshot, 0, 0.0, first);
+        os << "\n], \"displayTimeUnit\": \"ms\"}\n";
+    }
+
+
+
+
+    int Registry::findOrAddChild(const int parent, const std::string& name)
+    {
+        const std::vector<int>& children = nodes_[parent].children;
+        for (std::size_t c = 0; c < children.size(); ++c) {
+            if (nodes_[children[c]].name == name) {
+                return children[c];
+            }
+        }
+        Node child;
+        child.name = name;
+        child.parent = parent;
+        child.calls = 0;
+        child.seconds = 0.0;
+        nodes_.push_back(child);
+        const int index = nodes_.size() - 1;
+        nodes_[parent].children.push_back(index);
+        return index;
+    }
+
+
+
+
+    ScopedTimer::ScopedTimer(const char* name)
+        : node_(Registry::instance().enter(name)),
+          start_(std::chrono::steady_clock::now())
+    {
+    }
+
+
+
+
+    ScopedTimer::~ScopedTimer()
+    {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_;
+        Registry::instance().leave(node_, elapsed.count());
+    }
+
+} // namespace Instrumentation
+} // namespace Opm
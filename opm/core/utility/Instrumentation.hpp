@@ -0,0 +1,160 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_INSTRUMENTATION_HEADER_INCLUDED
+#define OPM_INSTRUMENTATION_HEADER_INCLUDED
+
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+namespace Instrumentation
+{
+
+    /// Aggregated samples of a single named counter.
+    struct CounterStats
+    {
+        CounterStats();
+        /// Add a sample to the statistics.
+        void add(const double value);
+
+        long long samples;
+        double sum;
+        double min;
+        double max;
+    };
+
+    /// A node in the timing tree. A node is identified by its name
+    /// and the node of the enclosing scope, so a timer that is entered
+    /// many times from the same place accumulates into a single node.
+    struct Node
+    {
+        std::string name;
+        int parent;                 // -1 for the root node.
+        std::vector<int> children;  // Indices into the node array.
+        long long calls;
+        double seconds;
+        std::map<std::string, CounterStats> counters;
+    };
+
+    /// Process-wide store of timing and counter data.
+    ///
+    /// All public methods are thread safe. Each thread keeps track of
+    /// its own innermost open scope, so timers entered on different
+    /// threads nest under the scope that was current on the thread
+    /// they were entered on (the root for threads that never entered
+    /// a scope). Data is aggregated when a scope is left, so the cost
+    /// is one lock per scope entry and exit and one lock per counter
+    /// sample; neither should be used at cell granularity.
+    class Registry
+    {
+    public:
+        /// The single registry instance.
+        static Registry& instance();
+
+        /// Open a scope with the given name below the calling
+        /// thread's current scope and make it current.
+        /// \return index of the node for the new scope.
+        int enter(const std::string& name);
+
+        /// Close the scope opened by enter(), adding the elapsed time
+        /// to its node, and make its parent current again.
+        void leave(const int node, const double seconds);
+
+        /// Add a sample to a counter of the calling thread's current scope.
+        void addToCounter(const std::string& name, const double value);
+
+        /// Remove all data. Must not be called while any scope is open.
+        void clear();
+
+        /// A consistent copy of the timing tree. Element 0 is the root.
+        std::vector<Node> nodes() const;
+
+        /// Write the timing tree as nested JSON objects.
+        void writeJson(std::ostream& os) const;
+
+        /// Write the timing tree in the Chrome trace event format
+        /// (loadable by chrome://tracing). Since only aggregates are
+        /// stored, each node becomes one complete event whose duration
+        /// is the accumulated time, laid out after its earlier siblings.
+        void writeChromeTrace(std::ostream& os) const;
+
+    private:
+        Registry();
+        Registry(const Registry&);
+        Registry& operator=(const Registry&);
+
+        int findOrAddChild(const int parent, const std::string& name);
+
+        mutable std::mutex mutex_;
+        std::vector<Node> nodes_;
+        // Bumped by clear(), so that per-thread scope state left from
+        // before is discarded.
+        unsigned long generation_;
+    };
+
+    /// Times the enclosing scope. Use through OPM_TIMER_SCOPE.
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(const char* name);
+        ~ScopedTimer();
+    private:
+        ScopedTimer(const ScopedTimer&);
+        ScopedTimer& operator=(const ScopedTimer&);
+
+        int node_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+} // namespace Instrumentation
+} // namespace Opm
+
+
+/// Instrumentation is only compiled in if OPM_INSTRUMENTATION is set
+/// (configure with -DOPM_INSTRUMENTATION=ON). Otherwise the macros
+/// below expand to empty statements and their arguments are not
+/// evaluated.
+#if OPM_INSTRUMENTATION
+
+#define OPM_INSTRUMENTATION_CONCAT_IMPL(a, b) a ## b
+#define OPM_INSTRUMENTATION_CONCAT(a, b) OPM_INSTRUMENTATION_CONCAT_IMPL(a, b)
+
+/// Time the rest of the enclosing block under the given name.
+#define OPM_TIMER_SCOPE(name)                                           \
+    ::Opm::Instrumentation::ScopedTimer                                 \
+    OPM_INSTRUMENTATION_CONCAT(opm_scoped_timer_, __LINE__)(name)
+
+/// Add a sample to the named counter of the current scope.
+#define OPM_COUNTER_ADD(name, value)                                    \
+    ::Opm::Instrumentation::Registry::instance().addToCounter((name), (value))
+
+#else
+
+#define OPM_TIMER_SCOPE(name) do { } while (false)
+#define OPM_COUNTER_ADD(name, value) do { } while (false)
+
+#endif // OPM_INSTRUMENTATION
+
+#endif // OPM_INSTRUMENTATION_HEADER_INCLUDED
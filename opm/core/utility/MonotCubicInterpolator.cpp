@@ -33,6 +33,7 @@
 #include "config.h"
 #include <opm/core/utility/MonotCubicInterpolator.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -50,34 +51,22 @@ using namespace std;
 
   Internal data structure of points and values:
 
-  vector(s):
-   - Easier coding
-   - Faster vector operations when setting up derivatives.
-   - sorting slightly more complex.
-   - insertion of further values bad.
-
-  vector<double,double>
-   - easy sorting
-   - code complexity almost as for map.
-   - insertion of additional values bad
-
-  vector over struct datapoint { x, f, d}
-   - nice code
-   - not as sortable, insertion is cumbersome.
-
-   ** This is used currently: **
   map<double, double> one for (x,f) and one for (x,d)
    - Naturally sorted on x-values (done by the map-construction)
-   - Slower to set up, awkward loop coding (?)
    - easy to add more points.
-   - easier to just add code to linear interpolation code
-   - x-data is duplicated, but that memory waste is
-     unlikely to represent a serious issue.
+   - but every evaluation is a tree search followed by two
+     further lookups for the derivative values.
 
-  map<double, <double, double> >
-   - naturally couples x-value, f-value and d-value
-   - even more unreadable(??) code?
-   - higher skills needed by programmer.
+   ** This is used currently: **
+  sorted vectors for x, f and d, and one vector for each
+  coefficient of the cubic polynomial on each interval
+   - evaluation is a binary search (or none, for sorted batches)
+     and a Horner evaluation on contiguous data.
+   - insertion of additional values is linear in the number of
+     points, which is acceptable as tables are built once and
+     evaluated many times.
+   - maps are still used to sort and remove duplicates when
+     reading input.
 
 
   MONOTONE CUBIC INTERPOLATION:
@@ -103,11 +92,19 @@ MonotCubicInterpolator(const vector<double> & x, const vector<double> & f) {
     throw("Unable to constuct MonotCubicInterpolator from vectors.") ;
   }
 
-  // Add the contents of the input vectors to our map of values.
+  // Sort the contents of the input vectors on x, later values
+  // replacing earlier ones with the same x.
+  map<double,double> data;
   vector<double>::const_iterator posx, posf;
   for (posx = x.begin(), posf = f.begin(); posx != x.end(); ++posx, ++posf) {
     data[*posx] = *posf ;
   }
+  xdata.reserve(data.size());
+  fdata.reserve(data.size());
+  for (map<double,double>::const_iterator it = data.begin(); it != data.end(); ++it) {
+    xdata.push_back(it->first);
+    fdata.push_back(it->second);
+  }
 
   computeInternalFunctionData();
 }
@@ -118,14 +115,17 @@ bool
 MonotCubicInterpolator::
 read(const std::string & datafilename, int xColumn, int fColumn)
 {
-  data.clear() ;
+  xdata.clear() ;
+  fdata.clear() ;
   ddata.clear() ;
+  derivativesValid = false;
 
   ifstream datafile_fs(datafilename.c_str());
   if (!datafile_fs) {
     return false ;
   }
 
+  map<double,double> data;
   string linestring;
   while (!datafile_fs.eof()) {
     getline(datafile_fs, linestring);
@@ -159,18 +159,38 @@ read(const std::string & datafilename, int xColumn, int fColumn)
     return false ;
   }
 
+  for (map<double,double>::const_iterator it = data.begin(); it != data.end(); ++it) {
+    xdata.push_back(it->first);
+    fdata.push_back(it->second);
+  }
+
   computeInternalFunctionData();
   return true ;
 }
 
 
+void
+MonotCubicInterpolator::
+insert(double newx, double newf) {
+  vector<double>::iterator pos = lower_bound(xdata.begin(), xdata.end(), newx);
+  const vector<double>::size_type index = pos - xdata.begin();
+  if (pos != xdata.end() && *pos == newx) {
+    fdata[index] = newf;
+  }
+  else {
+    xdata.insert(pos, newx);
+    fdata.insert(fdata.begin() + index, newf);
+  }
+}
+
+
 void
 MonotCubicInterpolator::
 addPair(double newx, double newf) {
   if (std::isnan(newx) || std::isinf(newx) || std::isnan(newf) || std::isinf(newf)) {
     throw("MonotCubicInterpolator: addPair() received inf/nan input.");
   }
-  data[newx] = newf ;
+  insert(newx, newf);
 
   // In a critical application, we should only update the
   // internal function data for the offended interval,
@@ -179,6 +199,14 @@ addPair(double newx, double newf) {
 }
 
 
+int
+MonotCubicInterpolator::
+findInterval(double x) const {
+  // First x-value greater than x, minus one.
+  return int(upper_bound(xdata.begin(), xdata.end(), x) - xdata.begin()) - 1;
+}
+
+
 double
 MonotCubicInterpolator::
 evaluate(double x) const {
@@ -187,49 +215,53 @@ evaluate(double x) const {
     throw("MonotCubicInterpolator: evaluate() received inf/nan input.");
   }
 
-  // xf becomes the first (xdata,fdata) pair where xdata >= x
-  map<double,double>::const_iterator xf_iterator = data.lower_bound(x);
-
   // First check if we must extrapolate:
-  if (xf_iterator == data.begin()) {
-    if (data.begin()->first == x) { // Just on the interval limit
-      return data.begin()->second;
-    }
-    else {
+  if (x <= xdata.front()) {
       // Constant extrapolation (!!)
-      return data.begin()->second;
-    }
+      return fdata.front();
   }
-  if (xf_iterator == data.end()) {
+  if (x >= xdata.back()) {
       // Constant extrapolation (!!)
-      return data.rbegin()->second;
+      return fdata.back();
   }
 
-
   // Ok, we have x_min < x < x_max
+  return evaluateInterval(findInterval(x), x);
+}
 
-  pair<double,double> xf2 = *xf_iterator;
-  pair<double,double> xf1 = *(--xf_iterator);
-  // we now have: xf2.first > x
 
-  // Linear interpolation if derivative data is not available:
-  if (ddata.size() != data.size()) {
-    double finterp =  xf1.second +
-      (xf2.second - xf1.second) / (xf2.first - xf1.first)
-      * (x - xf1.first);
-    return finterp;
-  }
-  else { // Do Cubic Hermite spline
-    double t = (x - xf1.first)/(xf2.first - xf1.first); // t \in [0,1]
-    double h = xf2.first - xf1.first;
-    double finterp
-      = xf1.second       * H00(t)
-      + ddata[xf1.first] * H10(t) * h
-      + xf2.second       * H01(t)
-      + ddata[xf2.first] * H11(t) * h ;
-    return finterp;
+void
+MonotCubicInterpolator::
+evaluate(int n, const double* x, double* f) const {
+  const double xmin = xdata.front();
+  const double xmax = xdata.back();
+  const int last = int(xdata.size()) - 2;
+  int i = 0;
+  for (int k = 0; k < n; ++k) {
+    const double xk = x[k];
+    if (std::isnan(xk) || std::isinf(xk)) {
+      throw("MonotCubicInterpolator: evaluate() received inf/nan input.");
+    }
+    if (xk <= xmin) {
+      f[k] = fdata.front();
+      continue;
+    }
+    if (xk >= xmax) {
+      f[k] = fdata.back();
+      continue;
+    }
+    // Try the interval of the previous point and the next one
+    // before searching.
+    if (xk < xdata[i] || xk >= xdata[i + 1]) {
+      if (i < last && xk >= xdata[i + 1] && xk < xdata[i + 2]) {
+        ++i;
+      }
+      else {
+        i = findInterval(xk);
+      }
+    }
+    f[k] = evaluateInterval(i, xk);
   }
-
 }
 
 
@@ -245,14 +277,7 @@ vector<double>
 MonotCubicInterpolator::
 get_xVector() const
 {
-  map<double,double>::const_iterator xf_iterator = data.begin();
-
-  vector<double> outputvector;
-  outputvector.reserve(data.size());
-  for (xf_iterator = data.begin(); xf_iterator != data.end(); ++xf_iterator) {
-    outputvector.push_back(xf_iterator->first);
-  }
-  return outputvector;
+  return xdata;
 }
 
 
@@ -260,15 +285,7 @@ vector<double>
 MonotCubicInterpolator::
 get_fVector() const
 {
-
-  map<double,double>::const_iterator xf_iterator = data.begin();
-
-  vector<double> outputvector;
-  outputvector.reserve(data.size());
-  for (xf_iterator = data.begin(); xf_iterator != data.end(); ++xf_iterator) {
-    outputvector.push_back(xf_iterator->second);
-  }
-  return outputvector;
+  return fdata;
 }
 
 
@@ -280,20 +297,20 @@ toString() const
   const int precision = 20;
   std::string dataString;
   std::stringstream dataStringStream;
-  for (map<double,double>::const_iterator it = data.begin();
-       it != data.end(); ++it) {
-      dataStringStream << setprecision(precision) << it->first;
+  for (vector<double>::size_type i = 0; i < xdata.size(); ++i) {
+    dataStringStream << setprecision(precision) << xdata[i];
     dataStringStream << '\t';
-    dataStringStream << setprecision(precision) << it->second;
+    dataStringStream << setprecision(precision) << fdata[i];
     dataStringStream << '\n';
   }
   dataStringStream << "Derivative values:" << endl;
-  for (map<double,double>::const_iterator it = ddata.begin();
-       it != ddata.end(); ++it) {
-    dataStringStream << setprecision(precision) << it->first;
-    dataStringStream << '\t';
-    dataStringStream << setprecision(precision) << it->second;
-    dataStringStream << '\n';
+  if (derivativesValid) {
+    for (vector<double>::size_type i = 0; i < xdata.size(); ++i) {
+      dataStringStream << setprecision(precision) << xdata[i];
+      dataStringStream << '\t';
+      dataStringStream << setprecision(precision) << ddata[i];
+      dataStringStream << '\n';
+    }
   }
 
   return dataStringStream.str();
@@ -305,30 +322,24 @@ pair<double,double>
 MonotCubicInterpolator::
 getMissingX() const
 {
-  if( data.size() < 2) {
+  if( xdata.size() < 2) {
     throw("MonotCubicInterpolator::getMissingX() only one datapoint.");
   }
 
   // Search for biggest difference value in function-datavalues:
 
-  map<double,double>::const_iterator  maxfDiffPair_iterator = data.begin();;
+  vector<double>::size_type maxfDiffIndex = 0;
   double maxfDiffValue = 0;
 
-  map<double,double>::const_iterator xf_iterator;
-  map<double,double>::const_iterator xf_next_iterator;
-
-  for (xf_iterator = data.begin(), xf_next_iterator = ++(data.begin());
-       xf_next_iterator != data.end();
-       ++xf_iterator, ++xf_next_iterator) {
-    double absfDiff = fabs((double)(*xf_next_iterator).second
-                           - (double)(*xf_iterator).second);
+  for (vector<double>::size_type i = 0; i + 1 < xdata.size(); ++i) {
+    double absfDiff = fabs(fdata[i + 1] - fdata[i]);
     if (absfDiff > maxfDiffValue) {
-      maxfDiffPair_iterator = xf_iterator;
+      maxfDiffIndex = i;
       maxfDiffValue = absfDiff;
     }
   }
 
-  double newXvalue = ((*maxfDiffPair_iterator).first + ((*(++maxfDiffPair_iterator)).first))/2;
+  double newXvalue = (xdata[maxfDiffIndex] + xdata[maxfDiffIndex + 1])/2;
   return make_pair(newXvalue, maxfDiffValue);
 
 }
@@ -338,19 +349,18 @@ getMissingX() const
 pair<double,double>
 MonotCubicInterpolator::
 getMaximumF() const {
-  if (data.size() <= 1) {
+  if (xdata.size() <= 1) {
     throw ("MonotCubicInterpolator::getMaximumF() empty data.") ;
   }
   if (strictlyIncreasing)
-    return *data.rbegin();
+    return getMaximumX();
   else if (strictlyDecreasing)
-    return *data.begin();
+    return getMinimumX();
   else {
-    pair<double,double> maxf = *data.rbegin() ;
-    map<double,double>::const_iterator xf_iterator;
-    for (xf_iterator = data.begin() ; xf_iterator != data.end(); ++xf_iterator) {
-      if (xf_iterator->second > maxf.second) {
-        maxf = *xf_iterator ;
+    pair<double,double> maxf = getMaximumX() ;
+    for (vector<double>::size_type i = 0; i < xdata.size(); ++i) {
+      if (fdata[i] > maxf.second) {
+        maxf = make_pair(xdata[i], fdata[i]) ;
       } ;
     }
     return maxf ;
@@ -361,20 +371,19 @@ getMaximumF() const {
 pair<double,double>
 MonotCubicInterpolator::
 getMinimumF() const {
-  if (data.size() <= 1) {
+  if (xdata.size() <= 1) {
     throw ("MonotCubicInterpolator::getMinimumF() empty data.") ;
   }
   if (strictlyIncreasing)
-    return *data.begin();
+    return getMinimumX();
   else if (strictlyDecreasing) {
-    return *data.rbegin();
+    return getMaximumX();
   }
   else {
-    pair<double,double> minf = *data.rbegin() ;
-    map<double,double>::const_iterator xf_iterator;
-    for (xf_iterator = data.begin() ; xf_iterator != data.end(); ++xf_iterator) {
-      if (xf_iterator->second < minf.second) {
-        minf = *xf_iterator ;
+    pair<double,double> minf = getMaximumX() ;
+    for (vector<double>::size_type i = 0; i < xdata.size(); ++i) {
+      if (fdata[i] < minf.second) {
+        minf = make_pair(xdata[i], fdata[i]) ;
       } ;
     }
     return minf ;
@@ -387,7 +396,7 @@ MonotCubicInterpolator::
 computeInternalFunctionData() const {
 
   /* The contents of this function is meaningless if there is only one datapoint */
-  if (data.size() <= 1) {
+  if (xdata.size() <= 1) {
     return;
   }
 
@@ -398,8 +407,8 @@ computeInternalFunctionData() const {
      monotoneness, and setting to false if the function is not for
      some value */
 
-  map<double,double>::const_iterator xf_iterator;
-  map<double,double>::const_iterator xf_next_iterator;
+  const vector<double>::size_type n = fdata.size();
+  vector<double>::size_type i = 0;
 
 
   strictlyMonotone = true; // We assume this is true, and will set to false if not
@@ -410,56 +419,52 @@ computeInternalFunctionData() const {
   increasing = true;
 
   // Increasing or decreasing??
-  xf_iterator = data.begin();
-  xf_next_iterator = ++(data.begin());
   /* Cater for non-strictness, search for direction for monotoneness */
-  while (xf_next_iterator != data.end() &&
-         xf_iterator->second == xf_next_iterator->second) {
+  while (i + 1 < n && fdata[i] == fdata[i + 1]) {
     /* Ok, equal values, this is not strict. */
     strictlyMonotone = false;
     strictlyIncreasing = false;
     strictlyDecreasing = false;
 
-    ++xf_iterator;
-    ++xf_next_iterator;
+    ++i;
   }
 
 
-  if (xf_next_iterator != data.end()) {
+  if (i + 1 < n) {
 
-    if ( xf_iterator->second > xf_next_iterator->second) {
+    if (fdata[i] > fdata[i + 1]) {
       // Ok, decreasing, check monotoneness:
       strictlyDecreasing = true;// if strictlyMonotone == false, this one should not be trusted anyway
       decreasing = true;
       strictlyIncreasing = false;
       increasing = false;
-      while(++xf_iterator, ++xf_next_iterator != data.end()) {
-        if ((*xf_iterator).second <  (*xf_next_iterator).second) {
+      while (++i + 1 < n) {
+        if (fdata[i] <  fdata[i + 1]) {
           monotone = false;
           strictlyMonotone = false;
           strictlyDecreasing = false; // meaningless now
           break; // out of while loop
         }
-        if ((*xf_iterator).second <= (*xf_next_iterator).second) {
+        if (fdata[i] <= fdata[i + 1]) {
           strictlyMonotone = false;
           strictlyDecreasing = false; // meaningless now
         }
       }
     }
-    else if (xf_iterator->second < xf_next_iterator->second) {
+    else if (fdata[i] < fdata[i + 1]) {
       // Ok, assume increasing, check monotoneness:
       strictlyDecreasing = false;
       strictlyIncreasing = true;
       decreasing = false;
       increasing = true;
-      while(++xf_iterator, ++xf_next_iterator != data.end()) {
-        if ((*xf_iterator).second >  (*xf_next_iterator).second) {
+      while (++i + 1 < n) {
+        if (fdata[i] >  fdata[i + 1]) {
           monotone = false;
           strictlyMonotone = false;
           strictlyIncreasing = false; // meaningless now
           break; // out of while loop
         }
-        if ((*xf_iterator).second >= (*xf_next_iterator).second) {
+        if (fdata[i] >= fdata[i + 1]) {
           strictlyMonotone = false;
           strictlyIncreasing = false; // meaningless now
         }
@@ -485,6 +490,8 @@ computeInternalFunctionData() const {
   if (monotone) {
     adjustDerivativesForMonotoneness();
   }
+  derivativesValid = true;
+  computeCoefficients();
 
   strictlyMonotoneCached = true;
   monotoneCached = true;
@@ -515,35 +522,29 @@ chopFlatEndpoints(const double epsilon) {
         return;
     }
 
-    map<double,double>::iterator xf_iterator;
-    map<double,double>::iterator xf_next_iterator;
-
     // Clear flags:
     strictlyMonotoneCached = false;
     monotoneCached = false;
 
     // Chop left end:
-    xf_iterator = data.begin();
-    xf_next_iterator = ++(data.begin());
     // Erase data points that are similar to its right value from the left end.
-    while ((xf_next_iterator != data.end()) &&
-           (fabs(xf_iterator->second - xf_next_iterator->second) < epsilon )) {
-        xf_next_iterator++;
-        data.erase(xf_iterator);
-	xf_iterator++;
+    vector<double>::size_type first = 0;
+    while ((first + 1 < xdata.size()) &&
+           (fabs(fdata[first] - fdata[first + 1]) < epsilon )) {
+        ++first;
     }
-
-    xf_iterator = data.end();
-    xf_iterator--;   // (data.end() points beyond the last element)
-    xf_next_iterator = xf_iterator;
-    xf_next_iterator--;
-    // Erase data points that are similar to its left value from the right end.
-    while ((xf_next_iterator != data.begin()) &&
-           (fabs(xf_iterator->second - xf_next_iterator->second) < epsilon )) {
-        xf_next_iterator--;
-        data.erase(xf_iterator);
-	xf_iterator--;
+    xdata.erase(xdata.begin(), xdata.begin() + first);
+    fdata.erase(fdata.begin(), fdata.begin() + first);
+
+    // Erase data points that are similar to its left value from the right end,
+    // never comparing with the first point.
+    vector<double>::size_type last = xdata.size() - 1;
+    while ((last > 1) &&
+           (fabs(fdata[last] - fdata[last - 1]) < epsilon )) {
+        --last;
     }
+    xdata.resize(last + 1);
+    fdata.resize(last + 1);
 
     // Finished chopping, so recompute function data:
     computeInternalFunctionData();
@@ -573,10 +574,6 @@ shrinkFlatAreas(const double epsilon) {
         return;
     }
 
-    map<double,double>::iterator xf_iterator;
-    map<double,double>::iterator xf_next_iterator;
-
-
     // Nothing to do if we already are strictly monotone
     if (isStrictlyMonotone()) {
         return;
@@ -596,22 +593,23 @@ shrinkFlatAreas(const double epsilon) {
     // have equal values, delete one of the data pair.
     // Do not trust the source code on which data point is being
     // removed (x-values of equal y-points might be averaged in the future)
-    xf_iterator = data.begin();
-    xf_next_iterator = ++(data.begin());
-
-    while (xf_next_iterator != data.end()) {
-        //cout << xf_iterator->first << "," << xf_iterator->second << " " << xf_next_iterator->first << "," << xf_next_iterator->second << "\n";
-        if (fabs(xf_iterator->second - xf_next_iterator->second) < epsilon ) {
-            //cout << "erasing data pair" << xf_next_iterator->first << " " << xf_next_iterator->second << "\n";
-            map <double,double>::iterator xf_tobedeleted_iterator = xf_next_iterator;
-            xf_next_iterator++;
-            data.erase(xf_tobedeleted_iterator);
-        }
-        else {
-            xf_iterator++;
-            xf_next_iterator++;
+    vector<double>::size_type kept = 0;
+    for (vector<double>::size_type i = 1; i < xdata.size(); ++i) {
+        if (fabs(fdata[kept] - fdata[i]) >= epsilon) {
+            ++kept;
+            xdata[kept] = xdata[i];
+            fdata[kept] = fdata[i];
         }
     }
+    if (kept + 1 < xdata.size()) {
+        xdata.resize(kept + 1);
+        fdata.resize(kept + 1);
+
+        // The derivatives no longer match the data, interpolate
+        // linearly until they are recomputed.
+        derivativesValid = false;
+        computeCoefficients();
+    }
 
 }
 
@@ -620,53 +618,29 @@ void
 MonotCubicInterpolator::
 computeSimpleDerivatives() const {
 
-  ddata.clear();
+  const vector<double>::size_type n = xdata.size();
+  ddata.resize(n);
 
   // Do endpoints first:
-  map<double,double>::const_iterator xf_prev_iterator;
-  map<double,double>::const_iterator xf_iterator;
-  map<double,double>::const_iterator xf_next_iterator;
-  double diff;
-
   // Leftmost interval:
-  xf_iterator = data.begin();
-  xf_next_iterator = ++(data.begin());
-  diff =
-    (xf_next_iterator->second - xf_iterator->second) /
-    (xf_next_iterator->first  - xf_iterator->first);
-  ddata[xf_iterator->first] = diff ;
+  ddata[0] = (fdata[1] - fdata[0]) / (xdata[1] - xdata[0]);
 
   // Rightmost interval:
-  xf_iterator = --(--(data.end()));
-  xf_next_iterator = --(data.end());
-  diff =
-    (xf_next_iterator->second - xf_iterator->second) /
-    (xf_next_iterator->first  - xf_iterator->first);
-  ddata[xf_next_iterator->first] = diff ;
+  ddata[n - 1] = (fdata[n - 1] - fdata[n - 2]) / (xdata[n - 1] - xdata[n - 2]);
 
   // If we have more than two intervals, loop over internal points:
-  if (data.size() > 2) {
-
-    map<double,double>::const_iterator intpoint;
-    for (intpoint = ++data.begin(); intpoint != --data.end(); ++intpoint) {
+  for (vector<double>::size_type i = 1; i + 1 < n; ++i) {
       /*
         diff = (f2 - f1)/(x2-x1)/w + (f3-f1)/(x3-x2)/2
 
         average of the forward and backward difference.
         Weights are equal, should we weigh with h_i?
       */
-
-      map<double,double>::const_iterator lastpoint = intpoint; --lastpoint;
-      map<double,double>::const_iterator nextpoint = intpoint; ++nextpoint;
-
-      diff = (nextpoint->second - intpoint->second)/
-        (2*(nextpoint->first - intpoint->first))
+      ddata[i] = (fdata[i + 1] - fdata[i])/
+        (2*(xdata[i + 1] - xdata[i]))
         +
-        (intpoint->second - lastpoint->second) /
-        (2*(intpoint->first - lastpoint->first));
-
-      ddata[intpoint->first] = diff ;
-    }
+        (fdata[i] - fdata[i - 1]) /
+        (2*(xdata[i] - xdata[i - 1]));
   }
 }
 
@@ -675,32 +649,24 @@ computeSimpleDerivatives() const {
 void
 MonotCubicInterpolator::
 adjustDerivativesForMonotoneness() const {
-  map<double,double>::const_iterator point, dpoint;
-
   /* Loop over all intervals, ie. loop over all points and look
      at the interval to the right of the point */
-  for (point = data.begin(), dpoint = ddata.begin();
-       point != --data.end();
-       ++point, ++dpoint) {
-    map<double,double>::const_iterator nextpoint, nextdpoint;
-    nextpoint = point; ++nextpoint;
-    nextdpoint = dpoint; ++nextdpoint;
-
+  for (vector<double>::size_type i = 0; i + 1 < xdata.size(); ++i) {
     double delta =
-      (nextpoint->second - point->second) /
-      (nextpoint->first  - point->first);
+      (fdata[i + 1] - fdata[i]) /
+      (xdata[i + 1] - xdata[i]);
     if (fabs(delta) < 1e-14) {
-      ddata[point->first] = 0.0;
-      ddata[nextpoint->first] = 0.0;
+      ddata[i] = 0.0;
+      ddata[i + 1] = 0.0;
     } else {
-      double alpha = ddata[point->first] / delta;
-      double beta = ddata[nextpoint->first] / delta;
+      double alpha = ddata[i] / delta;
+      double beta = ddata[i + 1] / delta;
 
       if (! isMonotoneCoeff(alpha, beta)) {
         double tau = 3/sqrt(alpha*alpha + beta*beta);
 
-        ddata[point->first]     = tau*alpha*delta;
-        ddata[nextpoint->first] = tau*beta*delta;
+        ddata[i]     = tau*alpha*delta;
+        ddata[i + 1] = tau*beta*delta;
       }
     }
 
@@ -712,21 +678,59 @@ adjustDerivativesForMonotoneness() const {
 
 
 
+void
+MonotCubicInterpolator::
+computeCoefficients() const {
+  const vector<double>::size_type nint = xdata.empty() ? 0 : xdata.size() - 1;
+  invh.resize(nint);
+  c0.resize(nint);
+  c1.resize(nint);
+  c2.resize(nint);
+  c3.resize(nint);
+  for (vector<double>::size_type i = 0; i < nint; ++i) {
+    const double h = xdata[i + 1] - xdata[i];
+    const double f1 = fdata[i];
+    const double f2 = fdata[i + 1];
+    invh[i] = 1.0/h;
+    c0[i] = f1;
+    if (derivativesValid) {
+      // f = f1*H00(t) + d1*h*H10(t) + f2*H01(t) + d2*h*H11(t), with
+      // H00 = 2t^3 - 3t^2 + 1, H10 = t^3 - 2t^2 + t,
+      // H01 = -2t^3 + 3t^2,    H11 = t^3 - t^2.
+      const double hd1 = h*ddata[i];
+      const double hd2 = h*ddata[i + 1];
+      c1[i] = hd1;
+      c2[i] = 3*(f2 - f1) - 2*hd1 - hd2;
+      c3[i] = 2*(f1 - f2) + hd1 + hd2;
+    }
+    else {
+      c1[i] = f2 - f1;
+      c2[i] = 0.0;
+      c3[i] = 0.0;
+    }
+  }
+}
+
+
 
 void
 MonotCubicInterpolator::
 scaleData(double factor) {
-  map<double,double>::iterator it , itd  ;
-  if (data.size() == ddata.size()) {
-    for (it = data.begin() , itd = ddata.begin() ; it != data.end() ; ++it , ++itd) {
-      it->second  *= factor ;
-      itd->second *= factor ;
-    } ;
-  } else {
-    for (it = data.begin() ; it != data.end() ; ++it ) {
-      it->second  *= factor ;
+  for (vector<double>::size_type i = 0; i < fdata.size(); ++i) {
+    fdata[i] *= factor ;
+  }
+  if (derivativesValid) {
+    for (vector<double>::size_type i = 0; i < ddata.size(); ++i) {
+      ddata[i] *= factor ;
     }
   }
+  // The coefficients are linear in the data and derivatives.
+  for (vector<double>::size_type i = 0; i < c0.size(); ++i) {
+    c0[i] *= factor ;
+    c1[i] *= factor ;
+    c2[i] *= factor ;
+    c3[i] *= factor ;
+  }
 }
 
 
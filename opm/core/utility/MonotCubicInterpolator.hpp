@@ -4,8 +4,8 @@
 #define _MONOTCUBICINTERPOLATOR_H
 
 #include <vector>
-#include <map>
 #include <string>
+#include <utility>
 
 /*
   MonotCubicInterpolator
@@ -53,6 +53,12 @@ namespace Opm
    Algorithm also described here:
    http://en.wikipedia.org/wiki/Monotone_cubic_interpolation
 
+   The data points are stored in sorted arrays, together with the
+   coefficients of the cubic polynomial on each interval, so that
+   evaluation amounts to a bracket search and a Horner
+   evaluation. For many points at a time, use the batched
+   evaluate(n, x, f), which is fastest when the points are sorted.
+
 
    @author Håvard Berland <havb (at) statoil.com>, December 2006
    @brief Represents one dimensional function f with single valued argument x that can be interpolated using monotone cubic interpolation
@@ -206,6 +212,17 @@ class MonotCubicInterpolator {
    */
    double evaluate(double x) const;
 
+   /**
+      @param n number of x values
+      @param x array of n x values
+      @param f array of n values, output
+
+      Sets f[i] = evaluate(x[i]) for all i. The bracketing interval
+      of the previous point is tried first, so sorted (or nearly
+      sorted) x values are evaluated without any searching.
+   */
+   void evaluate(int n, const double* x, double* f) const;
+
    /**
       @param x x value
       @param errorestimate_output
@@ -235,7 +252,7 @@ class MonotCubicInterpolator {
    */
    std::pair<double,double> getMinimumX() const {
        // Easy since the data is sorted on x:
-       return *data.begin();
+       return std::make_pair(xdata.front(), fdata.front());
    }
 
    /**
@@ -246,7 +263,7 @@ class MonotCubicInterpolator {
    */
    std::pair<double,double> getMaximumX() const {
        // Easy since the data is sorted on x:
-       return *data.rbegin();
+       return std::make_pair(xdata.back(), fdata.back());
    }
 
    /**
@@ -269,7 +286,7 @@ class MonotCubicInterpolator {
    /**
       Provide a copy of the x-data as a vector
 
-      Unspecified order, but corresponds to get_fVector.
+      Increasing order, corresponds to get_fVector.
 
       @return x values as a vector
    */
@@ -278,7 +295,7 @@ class MonotCubicInterpolator {
    /**
       Provide a copy of tghe function data as a vector
 
-      Unspecified order, but corresponds to get_xVector
+      Ordered by increasing x, corresponds to get_xVector
 
       @return f values as a vector
 
@@ -434,7 +451,7 @@ class MonotCubicInterpolator {
      @return Number of datapoint pairs in this object
    */
    int getSize() const {
-       return data.size();
+       return xdata.size();
    }
 
     /**
@@ -494,49 +511,56 @@ class MonotCubicInterpolator {
 
 private:
 
-   // Data structure to store x- and f-values
-   std::map<double, double> data;
+   // x-values (strictly increasing), and the corresponding f-values
+   std::vector<double> xdata;
+   std::vector<double> fdata;
 
-   // Data structure to store x- and d-values
-   mutable std::map<double, double> ddata;
+   // Derivative values at the x-values
+   mutable std::vector<double> ddata;
 
+   // True if ddata corresponds to the current data, otherwise the
+   // function is interpolated linearly.
+   mutable bool derivativesValid = false;
 
-   // Storage containers for precomputed interpolation data
-   //   std::vector<double> dvalues; // derivatives in Hermite interpolation.
+   // Precomputed interpolation data, one entry per interval
+   // [xdata[i], xdata[i+1]]: the inverse interval length, and the
+   // coefficients of the interpolant as a cubic polynomial in the
+   // local coordinate t = (x - xdata[i])/(xdata[i+1] - xdata[i]),
+   //   f = c0 + c1*t + c2*t^2 + c3*t^3.
+   mutable std::vector<double> invh;
+   mutable std::vector<double> c0;
+   mutable std::vector<double> c1;
+   mutable std::vector<double> c2;
+   mutable std::vector<double> c3;
 
    // Flag to determine whether the boolean strictlyMonotone can be
    // trusted.
-   mutable bool strictlyMonotoneCached;
-   mutable bool monotoneCached; /* only monotone, not stricly montone */
+   mutable bool strictlyMonotoneCached = false;
+   mutable bool monotoneCached = false; /* only monotone, not stricly montone */
 
-   mutable bool strictlyMonotone;
-   mutable bool monotone;
+   mutable bool strictlyMonotone = false;
+   mutable bool monotone = false;
 
    // if strictlyMonotone is true (and can be trusted), the two next are meaningful
-   mutable bool strictlyDecreasing;
-   mutable bool strictlyIncreasing;
-   mutable bool decreasing;
-   mutable bool increasing;
+   mutable bool strictlyDecreasing = false;
+   mutable bool strictlyIncreasing = false;
+   mutable bool decreasing = false;
+   mutable bool increasing = false;
 
 
-   /* Hermite basis functions, t \in [0,1] ,
-      notation from:
-      http://en.wikipedia.org/w/index.php?title=Cubic_Hermite_spline&oldid=84495502
-   */
+   /* Inserts the point (x, f), replacing the f-value if x is
+      already present. Does not update internal function data. */
+   void insert(double x, double f);
 
-   double H00(double t) const {
-       return 2*t*t*t - 3*t*t + 1;
-   }
-   double H10(double t) const {
-       return t*t*t - 2*t*t + t;
-   }
-   double H01(double t) const {
-       return -2*t*t*t + 3*t*t;
-   }
-   double H11(double t) const {
-       return t*t*t - t*t;
-   }
+   /* Index i of the interval with xdata[i] <= x < xdata[i+1],
+      for xdata.front() < x < xdata.back(). */
+   int findInterval(double x) const;
 
+   /* Interpolated value in the interval i. */
+   double evaluateInterval(int i, double x) const {
+       const double t = (x - xdata[i])*invh[i];
+       return c0[i] + t*(c1[i] + t*(c2[i] + t*c3[i]));
+   }
 
    void computeInternalFunctionData() const ;
 
@@ -544,11 +568,21 @@ private:
        Computes initial derivative values using centered (second order) difference
        for internal datapoints, and one-sided derivative for endpoints
 
-       The internal datastructure map<double,double> ddata is populated by this method.
+       The internal datastructure ddata is populated by this method.
    */
 
    void computeSimpleDerivatives() const ;
 
+   /**
+      Computes the polynomial coefficients of each interval from
+      the data and derivative values, using the Hermite basis
+      functions (notation from
+      http://en.wikipedia.org/w/index.php?title=Cubic_Hermite_spline&oldid=84495502 ),
+      or from the data alone (linear interpolation) if the
+      derivatives are not valid.
+   */
+   void computeCoefficients() const ;
+
 
    /**
       Adjusts the derivative values (ddata) so that we can guarantee that
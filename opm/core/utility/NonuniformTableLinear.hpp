@@ -77,6 +77,15 @@ namespace Opm
         /// @return f'(x)
         double derivative(const double x) const;
 
+        /// @brief Evaluate the values and derivatives at n points,
+        ///        sharing the table search. Requires T to be a double.
+        /// @param n number of points
+        /// @param x n domain values
+        /// @param[out] f n values f(x)
+        /// @param[out] dfdx n derivatives f'(x), may be null
+        void evaluate(const int n, const double* x,
+                      double* f, double* dfdx) const;
+
         /// @brief Evaluate the inverse at y. Requires T to be a double.
         /// @param y a range value
         /// @return f^{-1}(y)
@@ -203,6 +212,15 @@ namespace Opm
         return Opm::linearInterpolationDerivative(x_values_, y_values_, x);
     }
 
+    template<typename T>
+    inline void
+    NonuniformTableLinear<T>
+    ::evaluate(const int n, const double* x,
+               double* f, double* dfdx) const
+    {
+        Opm::linearInterpolation(x_values_, y_values_, n, x, f, dfdx);
+    }
+
     template<typename T>
     inline double
     NonuniformTableLinear<T>
@@ -295,6 +295,105 @@ namespace Opm
 
 
 
+    template <class ErrorPolicy = ThrowOnError>
+    class NewtonBisection
+    {
+    public:
+
+
+        /// Implements a safeguarded Newton method. Full Newton steps
+        /// are taken from the initial guess as long as they stay
+        /// inside the current bracket (initially [a, b]) and at least
+        /// halve the residual. Otherwise, the zero is bracketed by
+        /// evaluating f(a) and f(b) (once), and a bisection step is
+        /// taken instead. The bracket is shrunk by every new iterate.
+        ///
+        /// The functor must provide
+        ///     double operator()(double x, double& dfdx) const
+        /// returning f(x) and setting dfdx to f'(x).
+        ///
+        /// The arguments have the same meaning as for
+        /// RegulaFalsi::solve(), so the two may be exchanged.
+        template <class Functor>
+        inline static double solve(const Functor& f,
+                                   const double initial_guess,
+                                   const double a,
+                                   const double b,
+                                   const int max_iter,
+                                   const double tolerance,
+                                   int& iterations_used)
+        {
+            using namespace std;
+            const double macheps = numeric_limits<double>::epsilon();
+            const double eps = tolerance + macheps*max(max(fabs(a), fabs(b)), 1.0);
+            const double xmin = min(a, b);
+            const double xmax = max(a, b);
+
+            iterations_used = 0;
+            double x = min(max(initial_guess, xmin), xmax);
+            double dfdx = 0.0;
+            double fx = f(x, dfdx);
+            const double epsF = tolerance + macheps*max(fabs(fx), 1.0);
+            if (fabs(fx) < epsF) {
+                return x;
+            }
+
+            // Once bracketed, f(xneg) < 0 < f(xpos).
+            bool bracketed = false;
+            double xneg = xmin;
+            double xpos = xmax;
+            double fprev = numeric_limits<double>::max();
+            while (iterations_used < max_iter) {
+                const double lo = bracketed ? min(xneg, xpos) : xmin;
+                const double hi = bracketed ? max(xneg, xpos) : xmax;
+                double xnew = (dfdx != 0.0) ? x - fx/dfdx : lo - 1.0;
+                if (!(xnew > lo && xnew < hi) || fabs(fx) > 0.5*fprev) {
+                    if (!bracketed) {
+                        double dummy;
+                        const double fa = f(a, dummy);
+                        if (fabs(fa) < epsF) {
+                            return a;
+                        }
+                        const double fb = f(b, dummy);
+                        if (fabs(fb) < epsF) {
+                            return b;
+                        }
+                        if (fa*fb > 0.0) {
+                            return ErrorPolicy::handleBracketingFailure(a, b, fa, fb);
+                        }
+                        xneg = fa < 0.0 ? a : b;
+                        xpos = fa < 0.0 ? b : a;
+                        (fx < 0.0 ? xneg : xpos) = x;
+                        bracketed = true;
+                    }
+                    xnew = 0.5*(xneg + xpos);
+                }
+                const double step = fabs(xnew - x);
+                fprev = fabs(fx);
+                x = xnew;
+                fx = f(x, dfdx);
+                ++iterations_used;
+                if (fabs(fx) < epsF) {
+                    return x;
+                }
+                if (bracketed) {
+                    (fx < 0.0 ? xneg : xpos) = x;
+                    if (fabs(xpos - xneg) < 1e-9*eps) {
+                        return 0.5*(xneg + xpos);
+                    }
+                } else if (step < 1e-9*eps) {
+                    return x;
+                }
+            }
+            return bracketed ? ErrorPolicy::handleTooManyIterations(xneg, xpos, max_iter)
+                             : ErrorPolicy::handleTooManyIterations(x, x, max_iter);
+        }
+
+
+    };
+
+
+
     /// Attempts to find an interval bracketing a zero by successive
     /// enlargement of search interval.
     template <class Functor>
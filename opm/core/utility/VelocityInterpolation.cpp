@@ -22,6 +22,8 @@
 #include <opm/core/grid.h>
 #include <opm/core/linalg/blas_lapack.h>
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 
 namespace Opm
@@ -34,6 +36,19 @@ namespace Opm
     {
     }
 
+    /// Interpolate velocity at several points in a cell, one point
+    /// at a time.
+    void VelocityInterpolationInterface::interpolate(const int cell,
+                                                     const int npoints,
+                                                     const int dim,
+                                                     const double* x,
+                                                     double* v) const
+    {
+        for (int p = 0; p < npoints; ++p) {
+            interpolate(cell, x + p*dim, v + p*dim);
+        }
+    }
+
 
 
     // --------  Methods of class VelocityInterpolationConstant  --------
@@ -81,6 +96,31 @@ namespace Opm
         }
     }
 
+    /// Interpolate velocity at several points in a cell.
+    /// \param[in]  cell    Cell in which to interpolate.
+    /// \param[in]  npoints Number of points.
+    /// \param[in]  dim     Must be equal to grid.dimensions.
+    /// \param[in]  x       Coordinates of points at which to interpolate.
+    ///                     Must be array of length npoints*grid.dimensions.
+    /// \param[out] v       Interpolated velocities.
+    ///                     Must be array of length npoints*grid.dimensions.
+    void VelocityInterpolationConstant::interpolate(const int cell,
+                                                    const int npoints,
+                                                    const int dim,
+                                                    const double* x,
+                                                    double* v) const
+    {
+        assert(dim == grid_.dimensions);
+        if (npoints <= 0) {
+            return;
+        }
+        // The velocity is the same for all points of the cell.
+        interpolate(cell, x, v);
+        for (int p = 1; p < npoints; ++p) {
+            std::copy(v, v + dim, v + p*dim);
+        }
+    }
+
 
     // --------  Methods of class VelocityInterpolationECVI  --------
 
@@ -169,14 +209,52 @@ namespace Opm
     {
         const int n = bcmethod_.numCorners(cell);
         const int dim = grid_.dimensions;
-        bary_coord_.resize(n);
-        bcmethod_.cartToBary(cell, x, &bary_coord_[0]);
+        thread_local std::vector<double> bary_coord;
+        bary_coord.resize(n);
+        bcmethod_.cartToBary(cell, x, &bary_coord[0]);
         std::fill(v, v + dim, 0.0);
         const SparseTable<WachspressCoord::CornerInfo>& all_ci = bcmethod_.cornerInfo();
         for (int i = 0; i < n; ++i) {
             const int cid = all_ci[cell][i].corner_id;
             for (int dd = 0; dd < dim; ++dd) {
-                v[dd] += corner_velocity_[dim*cid + dd] * bary_coord_[i];
+                v[dd] += corner_velocity_[dim*cid + dd] * bary_coord[i];
+            }
+        }
+    }
+
+    /// Interpolate velocity at several points in a cell.
+    /// \param[in]  cell    Cell in which to interpolate.
+    /// \param[in]  npoints Number of points.
+    /// \param[in]  dim     Must be equal to grid.dimensions.
+    /// \param[in]  x       Coordinates of points at which to interpolate.
+    ///                     Must be array of length npoints*grid.dimensions.
+    /// \param[out] v       Interpolated velocities.
+    ///                     Must be array of length npoints*grid.dimensions.
+    void VelocityInterpolationECVI::interpolate(const int cell,
+                                                const int npoints,
+                                                const int dim,
+                                                const double* x,
+                                                double* v) const
+    {
+        assert(dim == grid_.dimensions);
+        if (npoints <= 0) {
+            return;
+        }
+        const int n = bcmethod_.numCorners(cell);
+        // Per-thread scratch space, so that concurrent calls do not
+        // share the barycentric coordinates.
+        thread_local std::vector<double> bary_coord;
+        bary_coord.resize(npoints*n);
+        bcmethod_.cartToBary(cell, npoints, x, &bary_coord[0]);
+        std::fill(v, v + npoints*dim, 0.0);
+        const SparseTable<WachspressCoord::CornerInfo>& all_ci = bcmethod_.cornerInfo();
+        for (int i = 0; i < n; ++i) {
+            const double* cv = &corner_velocity_[dim*all_ci[cell][i].corner_id];
+            for (int p = 0; p < npoints; ++p) {
+                const double b = bary_coord[p*n + i];
+                for (int dd = 0; dd < dim; ++dd) {
+                    v[p*dim + dd] += cv[dd] * b;
+                }
             }
         }
     }
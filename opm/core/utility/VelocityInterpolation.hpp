@@ -47,6 +47,25 @@ namespace Opm
         virtual void interpolate(const int cell,
                                  const double* x,
                                  double* v) const = 0;
+
+        /// Interpolate velocity at several points in a cell.
+        /// Implementations must not modify any shared state, so that
+        /// several threads may interpolate concurrently. The default
+        /// implementation calls the single-point interpolate() once
+        /// per point.
+        /// \param[in]  cell    Cell in which to interpolate.
+        /// \param[in]  npoints Number of points.
+        /// \param[in]  dim     Number of coordinates per point,
+        ///                     equal to grid.dimensions.
+        /// \param[in]  x       Coordinates of points at which to interpolate.
+        ///                     Must be array of length npoints*dim.
+        /// \param[out] v       Interpolated velocities.
+        ///                     Must be array of length npoints*dim.
+        virtual void interpolate(const int cell,
+                                 const int npoints,
+                                 const int dim,
+                                 const double* x,
+                                 double* v) const;
     };
 
 
@@ -61,6 +80,8 @@ namespace Opm
         /// \param[in]  grid   A grid.
         explicit VelocityInterpolationConstant(const UnstructuredGrid& grid);
 
+        using VelocityInterpolationInterface::interpolate;
+
         /// Set up fluxes for interpolation.
         /// \param[in]  flux   One signed flux per face in the grid.
         virtual void setupFluxes(const double* flux);
@@ -74,6 +95,20 @@ namespace Opm
         virtual void interpolate(const int cell,
                                  const double* x,
                                  double* v) const;
+
+        /// Interpolate velocity at several points in a cell.
+        /// \param[in]  cell    Cell in which to interpolate.
+        /// \param[in]  npoints Number of points.
+        /// \param[in]  dim     Must be equal to grid.dimensions.
+        /// \param[in]  x       Coordinates of points at which to interpolate.
+        ///                     Must be array of length npoints*grid.dimensions.
+        /// \param[out] v       Interpolated velocities.
+        ///                     Must be array of length npoints*grid.dimensions.
+        virtual void interpolate(const int cell,
+                                 const int npoints,
+                                 const int dim,
+                                 const double* x,
+                                 double* v) const;
     private:
         const UnstructuredGrid& grid_;
         const double* flux_;
@@ -94,6 +129,8 @@ namespace Opm
         /// \param[in]  grid   A grid.
         explicit VelocityInterpolationECVI(const UnstructuredGrid& grid);
 
+        using VelocityInterpolationInterface::interpolate;
+
         /// Set up fluxes for interpolation.
         /// \param[in]  flux   One signed flux per face in the grid.
         virtual void setupFluxes(const double* flux);
@@ -107,10 +144,23 @@ namespace Opm
         virtual void interpolate(const int cell,
                                  const double* x,
                                  double* v) const;
+
+        /// Interpolate velocity at several points in a cell.
+        /// \param[in]  cell    Cell in which to interpolate.
+        /// \param[in]  npoints Number of points.
+        /// \param[in]  dim     Must be equal to grid.dimensions.
+        /// \param[in]  x       Coordinates of points at which to interpolate.
+        ///                     Must be array of length npoints*grid.dimensions.
+        /// \param[out] v       Interpolated velocities.
+        ///                     Must be array of length npoints*grid.dimensions.
+        virtual void interpolate(const int cell,
+                                 const int npoints,
+                                 const int dim,
+                                 const double* x,
+                                 double* v) const;
     private:
         WachspressCoord bcmethod_;
         const UnstructuredGrid& grid_;
-        mutable std::vector<double> bary_coord_;
         std::vector<double> corner_velocity_; // size = dim * #corners
     };
 
@@ -20,9 +20,11 @@
 #include "config.h"
 #include <opm/core/utility/WachspressCoord.hpp>
 #include <opm/core/grid.h>
+#include <opm/common/ErrorMacros.hpp>
+#include <algorithm>
 #include <cmath>
-#include <map>
-#include <set>
+#include <utility>
+#include <vector>
 
 namespace Opm
 {
@@ -62,6 +64,31 @@ namespace Opm
             return std::fabs(det);
         }
 
+        /// Collects the (vertex, half-face) incidences of a cell, sorted
+        /// on vertex and then on half-face, so that the faces adjacent
+        /// to each vertex are contiguous and in cell order.
+        /// \return the number of distinct vertices of the cell.
+        int cellIncidences(const UnstructuredGrid& grid,
+                           const int cell,
+                           std::vector<std::pair<int, int> >& incidences)
+        {
+            incidences.clear();
+            for (int hface = grid.cell_facepos[cell]; hface < grid.cell_facepos[cell + 1]; ++hface) {
+                const int face = grid.cell_faces[hface];
+                for (int fn = grid.face_nodepos[face]; fn < grid.face_nodepos[face + 1]; ++fn) {
+                    incidences.push_back(std::make_pair(grid.face_nodes[fn], hface));
+                }
+            }
+            std::sort(incidences.begin(), incidences.end());
+            int num_vertices = 0;
+            for (int i = 0; i < int(incidences.size()); ++i) {
+                if (i == 0 || incidences[i].first != incidences[i - 1].first) {
+                    ++num_vertices;
+                }
+            }
+            return num_vertices;
+        }
+
     } // anonymous namespace
 
 
@@ -102,59 +129,103 @@ namespace Opm
         if (dim > Maxdim) {
             OPM_THROW(std::runtime_error, "Grid has more than " << Maxdim << " dimensions.");
         }
-        // Compute static data for each corner.
+        // Corners are numbered by cell and by increasing vertex index
+        // within each cell. First count the corners of each cell, so
+        // that all cells can then be processed independently, writing
+        // to precomputed positions in flat arrays.
         const int num_cells = grid.number_of_cells;
-        int corner_id_count = 0;
+        std::vector<int> num_corners(num_cells);
+#pragma omp parallel
+        {
+            std::vector<std::pair<int, int> > incidences;
+#pragma omp for schedule(static)
+            for (int cell = 0; cell < num_cells; ++cell) {
+                num_corners[cell] = cellIncidences(grid, cell, incidences);
+            }
+        }
+
+        // Each corner has dim adjacent faces, and the remaining faces of
+        // its cell are nonadjacent.
+        std::vector<int> corner_start(num_cells + 1, 0);
+        std::vector<int> nonadj_start(num_cells + 1, 0);
         for (int cell = 0; cell < num_cells; ++cell) {
-            std::set<int> cell_vertices;
-            std::vector<int> cell_faces;
-            std::multimap<int, int> vertex_adj_faces;
-            for (int hface = grid.cell_facepos[cell]; hface < grid.cell_facepos[cell + 1]; ++hface) {
-                const int face = grid.cell_faces[hface];
-                cell_faces.push_back(face);
-                const int fn0 = grid.face_nodepos[face];
-                const int fn1 = grid.face_nodepos[face + 1];
-                cell_vertices.insert(grid.face_nodes + fn0, grid.face_nodes + fn1);
-                for (int fn = fn0; fn < fn1; ++fn) {
-                    const int vertex = grid.face_nodes[fn];
-                    vertex_adj_faces.insert(std::make_pair(vertex, face));
-                }
+            const int num_faces = grid.cell_facepos[cell + 1] - grid.cell_facepos[cell];
+            if (num_faces < dim) {
+                OPM_THROW(std::runtime_error, "Cell " << cell << " has fewer than " << dim << " faces.");
             }
-            std::sort(cell_faces.begin(), cell_faces.end()); // set_difference requires sorted ranges
-            std::vector<CornerInfo> cell_corner_info;
-            std::set<int>::const_iterator it = cell_vertices.begin();
-            for (; it != cell_vertices.end(); ++it) {
-                CornerInfo ci;
-                ci.corner_id = corner_id_count++;;
-                ci.vertex = *it;
-                double* fnorm[Maxdim] = { 0 };
-                typedef std::multimap<int, int>::const_iterator MMIt;
-                std::pair<MMIt, MMIt> frange = vertex_adj_faces.equal_range(ci.vertex);
-                int fi = 0;
-                std::vector<int> vert_adj_faces(dim);
-                for (MMIt face_it = frange.first; face_it != frange.second; ++face_it, ++fi) {
-                    if (fi >= dim) {
-                        OPM_THROW(std::runtime_error, "In cell " << cell << ", vertex " << ci.vertex << " has "
-                              << " more than " << dim << " adjacent faces.");
+            corner_start[cell + 1] = corner_start[cell] + num_corners[cell];
+            nonadj_start[cell + 1] = nonadj_start[cell] + num_corners[cell]*(num_faces - dim);
+        }
+        const int num_total_corners = corner_start[num_cells];
+        std::vector<CornerInfo> corner_info(num_total_corners);
+        std::vector<int> nonadj_faces(nonadj_start[num_cells], 0);
+        std::vector<int> num_nonadj_faces(num_total_corners);
+        adj_faces_.assign(dim*num_total_corners, 0);
+
+        // Compute static data for each corner.
+        int bad_cell = -1;
+        int bad_vertex = -1;
+#pragma omp parallel
+        {
+            std::vector<std::pair<int, int> > incidences;
+            std::vector<int> cell_faces;
+#pragma omp for schedule(static)
+            for (int cell = 0; cell < num_cells; ++cell) {
+                cellIncidences(grid, cell, incidences);
+                cell_faces.assign(grid.cell_faces + grid.cell_facepos[cell],
+                                  grid.cell_faces + grid.cell_facepos[cell + 1]);
+                std::sort(cell_faces.begin(), cell_faces.end()); // set_difference requires sorted ranges
+                const int num_nonadj = cell_faces.size() - dim;
+                int corner = corner_start[cell];
+                int* nonadj = nonadj_faces.data() + nonadj_start[cell];
+                for (int b = 0; b < int(incidences.size()); ++corner, nonadj += num_nonadj) {
+                    const int vertex = incidences[b].first;
+                    int e = b;
+                    while (e < int(incidences.size()) && incidences[e].first == vertex) {
+                        ++e;
+                    }
+                    if (e - b > dim) {
+#pragma omp critical
+                        {
+                            if (bad_cell < 0 || cell < bad_cell) {
+                                bad_cell = cell;
+                                bad_vertex = vertex;
+                            }
+                        }
+                        b = e;
+                        continue;
+                    }
+                    assert(e - b == dim);
+                    CornerInfo& ci = corner_info[corner];
+                    ci.corner_id = corner;
+                    ci.vertex = vertex;
+                    double* fnorm[Maxdim] = { 0 };
+                    int* vert_adj_faces = adj_faces_.data() + dim*corner;
+                    for (int fi = 0; b < e; ++b, ++fi) {
+                        const int face = grid.cell_faces[incidences[b].second];
+                        fnorm[fi] = grid_.face_normals + dim*face;
+                        vert_adj_faces[fi] = face;
                     }
-                    fnorm[fi] = grid_.face_normals + dim*(face_it->second);
-                    vert_adj_faces[fi] = face_it->second;
+                    ci.volume = cornerVolume(fnorm, dim);
+                    int sorted_adj_faces[Maxdim];
+                    std::copy(vert_adj_faces, vert_adj_faces + dim, sorted_adj_faces);
+                    std::sort(sorted_adj_faces, sorted_adj_faces + dim);
+                    std::set_difference(cell_faces.begin(), cell_faces.end(),
+                                        sorted_adj_faces, sorted_adj_faces + dim,
+                                        nonadj);
+                    num_nonadj_faces[corner] = num_nonadj;
                 }
-                assert(fi == dim);
-                adj_faces_.insert(adj_faces_.end(), vert_adj_faces.begin(), vert_adj_faces.end());
-                const double corner_vol = cornerVolume(fnorm, dim);
-                ci.volume = corner_vol;
-                cell_corner_info.push_back(ci);
-                std::sort(vert_adj_faces.begin(), vert_adj_faces.end());
-                std::vector<int> vert_nonadj_faces(cell_faces.size() - vert_adj_faces.size());
-                std::set_difference(cell_faces.begin(), cell_faces.end(),
-                                    vert_adj_faces.begin(), vert_adj_faces.end(),
-                                    vert_nonadj_faces.begin());
-                nonadj_faces_.appendRow(vert_nonadj_faces.begin(), vert_nonadj_faces.end());
             }
-            corner_info_.appendRow(cell_corner_info.begin(), cell_corner_info.end());
         }
-        assert(corner_id_count == corner_info_.dataSize());
+        if (bad_cell >= 0) {
+            OPM_THROW(std::runtime_error, "In cell " << bad_cell << ", vertex " << bad_vertex << " has "
+                      << " more than " << dim << " adjacent faces.");
+        }
+        corner_info_ = SparseTable<CornerInfo>(corner_info.begin(), corner_info.end(),
+                                               num_corners.begin(), num_corners.end());
+        nonadj_faces_ = SparseTable<int>(nonadj_faces.begin(), nonadj_faces.end(),
+                                         num_nonadj_faces.begin(), num_nonadj_faces.end());
+        assert(num_total_corners == corner_info_.dataSize());
     }
 
 
@@ -197,6 +268,25 @@ namespace Opm
     void WachspressCoord::cartToBary(const int cell,
                                      const double* x,
                                      double* xb) const
+    {
+        cartToBary(cell, 1, x, xb);
+    }
+
+
+
+    /// Compute generalized barycentric coordinates for several
+    /// points with respect to the vertices of a grid cell.
+    /// \param[in]  cell    Cell in which to compute coordinates.
+    /// \param[in]  npoints Number of points.
+    /// \param[in]  x       Coordinates of points in cartesian coordinates.
+    ///                     Must be array of length npoints*grid.dimensions.
+    /// \param[out] xb      Coordinates of points in barycentric coordinates,
+    ///                     numCorners(cell) consecutive values per point.
+    ///                     Must be array of length npoints*numCorners(cell).
+    void WachspressCoord::cartToBary(const int cell,
+                                     const int npoints,
+                                     const double* x,
+                                     double* xb) const
     {
         // Note:
         // A possible optimization is: compute all n_j * (c_j - x) factors
@@ -204,32 +294,34 @@ namespace Opm
         // which j is a nonadjacent face).
         const int n = numCorners(cell);
         const int dim = grid_.dimensions;
-        double totw = 0.0;
-        for (int i = 0; i < n; ++i) {
-            const CornerInfo& ci = corner_info_[cell][i];
-            // Weight (unnormalized) is equal to:
-            // V_i * (prod_{j \in nonadjacent faces} n_j * (c_j - x) )
-            // ^^^                                   ^^^    ^^^
-            // corner "volume"                    normal    centroid
-            xb[i] = ci.volume;
-            const int num_nonadj_faces = nonadj_faces_[ci.corner_id].size();
-            for (int j = 0; j < num_nonadj_faces; ++j) {
-                const int face = nonadj_faces_[ci.corner_id][j];
-                double factor = 0.0;
-                for (int dd = 0; dd < dim; ++dd) {
-                    factor += grid_.face_normals[dim*face + dd]*(grid_.face_centroids[dim*face + dd] - x[dd]);
-                }
-                // Assumes outward-pointing normals, so negate factor if necessary.
-                if (grid_.face_cells[2*face] != cell) {
-                    assert(grid_.face_cells[2*face + 1] == cell);
-                    factor = -factor;
+        for (int p = 0; p < npoints; ++p, x += dim, xb += n) {
+            double totw = 0.0;
+            for (int i = 0; i < n; ++i) {
+                const CornerInfo& ci = corner_info_[cell][i];
+                // Weight (unnormalized) is equal to:
+                // V_i * (prod_{j \in nonadjacent faces} n_j * (c_j - x) )
+                // ^^^                                   ^^^    ^^^
+                // corner "volume"                    normal    centroid
+                xb[i] = ci.volume;
+                const int num_nonadj_faces = nonadj_faces_[ci.corner_id].size();
+                for (int j = 0; j < num_nonadj_faces; ++j) {
+                    const int face = nonadj_faces_[ci.corner_id][j];
+                    double factor = 0.0;
+                    for (int dd = 0; dd < dim; ++dd) {
+                        factor += grid_.face_normals[dim*face + dd]*(grid_.face_centroids[dim*face + dd] - x[dd]);
+                    }
+                    // Assumes outward-pointing normals, so negate factor if necessary.
+                    if (grid_.face_cells[2*face] != cell) {
+                        assert(grid_.face_cells[2*face + 1] == cell);
+                        factor = -factor;
+                    }
+                    xb[i] *= factor;
                 }
-                xb[i] *= factor;
+                totw += xb[i];
+            }
+            for (int i = 0; i < n; ++i) {
+                xb[i] /= totw;
             }
-            totw += xb[i];
-        }
-        for (int i = 0; i < n; ++i) {
-            xb[i] /= totw;
         }
     }
 
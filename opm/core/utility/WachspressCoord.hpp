@@ -56,6 +56,20 @@ namespace Opm
                         const double* x,
                         double* xb) const;
 
+        /// Compute generalized barycentric coordinates for several
+        /// points with respect to the vertices of a grid cell.
+        /// \param[in]  cell    Cell in which to compute coordinates.
+        /// \param[in]  npoints Number of points.
+        /// \param[in]  x       Coordinates of points in cartesian coordinates.
+        ///                     Must be array of length npoints*grid.dimensions.
+        /// \param[out] xb      Coordinates of points in barycentric coordinates,
+        ///                     numCorners(cell) consecutive values per point.
+        ///                     Must be array of length npoints*numCorners(cell).
+        void cartToBary(const int cell,
+                        const int npoints,
+                        const double* x,
+                        double* xb) const;
+
         // A corner is here defined as a {cell, vertex} pair where the
         // vertex is adjacent to the cell.
         struct CornerInfo
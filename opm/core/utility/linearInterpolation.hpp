@@ -52,6 +52,52 @@ namespace Opm
     }
 
 
+    inline int tableIndex(const std::vector<double>& table, double x, int guess)
+    {
+        // Returns the same index as tableIndex(table, x), searching
+        // from the interval guess (typically the result for a nearby
+        // x) in steps of doubling length, followed by a binary
+        // search. The cost is logarithmic in the distance from guess.
+        int n = table.size() - 1;
+        if (n < 2) {
+            return 0;
+        }
+        guess = std::min(std::max(guess, 0), n - 1);
+        bool ascend = (table[n] > table[0]);
+        // As in tableIndex(), jl is zero or table[jl] is on the lower
+        // side of x, and ju is n or table[ju] is on the upper side.
+        int jl = guess;
+        int ju = guess;
+        int step = 1;
+        if (guess == 0 || (x >= table[guess]) == ascend) {
+            ju = jl + 1;
+            while (ju < n && (x >= table[ju]) == ascend) {
+                jl = ju;
+                ju = jl + step;
+                step *= 2;
+            }
+            ju = std::min(ju, n);
+        } else {
+            jl = ju - 1;
+            while (jl > 0 && (x >= table[jl]) != ascend) {
+                ju = jl;
+                jl = ju - step;
+                step *= 2;
+            }
+            jl = std::max(jl, 0);
+        }
+        while (ju - jl > 1) {
+            int jm = (ju + jl)/2;
+            if ( (x >= table[jm]) == ascend) {
+                jl = jm;
+            } else {
+                ju = jm;
+            }
+        }
+        return jl;
+    }
+
+
     inline double linearInterpolationDerivative(const std::vector<double>& xv,
                                                 const std::vector<double>& yv, double x)
     {
@@ -96,6 +142,29 @@ namespace Opm
 	return (yv[ix2] - yv[ix1])/(xv[ix2] - xv[ix1])*(x - xv[ix1]) + yv[ix1];
     }
 
+    /// Values and derivatives of the piecewise linear function (xv, yv)
+    /// at n points, extrapolating as linearInterpolation(). Each table
+    /// search starts from the interval of the previous point, so that
+    /// sorted or spatially coherent points need little searching.
+    /// \param[out] y     n values
+    /// \param[out] dydx  n derivatives, or null if not needed
+    inline void linearInterpolation(const std::vector<double>& xv,
+                                    const std::vector<double>& yv,
+                                    const int n, const double* x,
+                                    double* y, double* dydx)
+    {
+        int ix1 = 0;
+        for (int i = 0; i < n; ++i) {
+            ix1 = tableIndex(xv, x[i], ix1);
+            int ix2 = ix1 + 1;
+            const double slope = (yv[ix2] - yv[ix1])/(xv[ix2] - xv[ix1]);
+            y[i] = slope*(x[i] - xv[ix1]) + yv[ix1];
+            if (dydx) {
+                dydx[i] = slope;
+            }
+        }
+    }
+
 
 
 } // namespace Opm
@@ -80,8 +80,9 @@ namespace Opm
     {
         int num_cells = grid.number_of_cells;
         porosity.resize(num_cells);
+        rock_comp.poroMult(num_cells, pressure.data(), porosity.data(), 0);
         for (int i = 0; i < num_cells; ++i) {
-            porosity[i] = porosity_standard[i]*rock_comp.poroMult(pressure[i]);
+            porosity[i] *= porosity_standard[i];
         }
     }
 
@@ -204,13 +205,29 @@ namespace Opm
                               std::vector<double>& totmob)
     {
         std::vector<double> pmobc;
+        computeTotalMobility(props, cells, s, pmobc, totmob);
+    }
+
 
+    /// @brief Computes total mobility for a set of saturation values,
+    ///        using caller-owned workspace.
+    /// @param[in]  props     rock and fluid properties
+    /// @param[in]  cells     cells with which the saturation values are associated
+    /// @param[in]  s         saturation values (for all phases)
+    /// @param[out] pmobc     workspace, holds the phase mobilities on return
+    /// @param[out] totmob    total mobilities.
+    void computeTotalMobility(const Opm::IncompPropertiesInterface& props,
+                              const std::vector<int>& cells,
+                              const std::vector<double>& s,
+                              std::vector<double>& pmobc,
+                              std::vector<double>& totmob)
+    {
         computePhaseMobilities(props, cells, s, pmobc);
 
         const std::size_t                 np = props.numPhases();
         const std::vector<int>::size_type nc = cells.size();
 
-        std::vector<double>(cells.size(), 0.0).swap(totmob);
+        totmob.assign(nc, 0.0);
 
         for (std::vector<int>::size_type c = 0; c < nc; ++c) {
             for (std::size_t p = 0; p < np; ++p) {
@@ -233,14 +250,32 @@ namespace Opm
                                    std::vector<double>& omega)
     {
         std::vector<double> pmobc;
+        computeTotalMobilityOmega(props, cells, s, pmobc, totmob, omega);
+    }
+
 
+    /// @brief Computes total mobility and omega for a set of saturation values,
+    ///        using caller-owned workspace.
+    /// @param[in]  props     rock and fluid properties
+    /// @param[in]  cells     cells with which the saturation values are associated
+    /// @param[in]  s         saturation values (for all phases)
+    /// @param[out] pmobc     workspace, holds the phase mobilities on return
+    /// @param[out] totmob    total mobility
+    /// @param[out] omega     fractional-flow weighted fluid densities.
+    void computeTotalMobilityOmega(const Opm::IncompPropertiesInterface& props,
+                                   const std::vector<int>& cells,
+                                   const std::vector<double>& s,
+                                   std::vector<double>& pmobc,
+                                   std::vector<double>& totmob,
+                                   std::vector<double>& omega)
+    {
         computePhaseMobilities(props, cells, s, pmobc);
 
         const std::size_t                 np = props.numPhases();
         const std::vector<int>::size_type nc = cells.size();
 
-        std::vector<double>(cells.size(), 0.0).swap(totmob);
-        std::vector<double>(cells.size(), 0.0).swap(omega );
+        totmob.assign(nc, 0.0);
+        omega .assign(nc, 0.0);
 
         const double* rho = props.density();
         for (std::vector<int>::size_type c = 0; c < nc; ++c) {
@@ -386,6 +421,83 @@ namespace Opm
         }
     }
 
+    /// Find the boundary faces of a grid.
+    TransportSourceBuilder::TransportSourceBuilder(const UnstructuredGrid& grid)
+        : num_cells_(grid.number_of_cells)
+    {
+        // Visit half-faces in grid order, so that each cell sums its
+        // boundary contributions in the same order as before.
+        for (int c = 0; c < num_cells_; ++c) {
+            for (int hf = grid.cell_facepos[c]; hf < grid.cell_facepos[c + 1]; ++hf) {
+                const int f = grid.cell_faces[hf];
+                const int* f2c = &grid.face_cells[2*f];
+                if (f2c[0] == c && f2c[1] == -1) {
+                    bdy_cells_.push_back(c);
+                    bdy_faces_.push_back(f);
+                    bdy_sign_.push_back(-1.0);
+                } else if (f2c[0] == -1 && f2c[1] == c) {
+                    bdy_cells_.push_back(c);
+                    bdy_faces_.push_back(f);
+                    bdy_sign_.push_back(1.0);
+                }
+            }
+        }
+    }
+
+    /// Compute transport source terms.
+    void TransportSourceBuilder::compute(const std::vector<double>& src,
+                                         const std::vector<double>& faceflux,
+                                         const double inflow_frac,
+                                         const Wells* wells,
+                                         const std::vector<double>& well_perfrates,
+                                         std::vector<double>& transport_src) const
+    {
+        const int nc = num_cells_;
+        transport_src.resize(nc);
+        // Source term and boundary contributions.
+        for (int c = 0; c < nc; ++c) {
+            transport_src[c] = 0.0;
+            transport_src[c] += src[c] > 0.0 ? inflow_frac*src[c] : src[c];
+        }
+        const int nbdy = bdy_faces_.size();
+        for (int i = 0; i < nbdy; ++i) {
+            const double bdy_influx = bdy_sign_[i]*faceflux[bdy_faces_[i]];
+            if (bdy_influx != 0.0) {
+                transport_src[bdy_cells_[i]] += bdy_influx > 0.0 ? inflow_frac*bdy_influx : bdy_influx;
+            }
+        }
+
+        // Well contributions.
+        if (wells) {
+            const int nw = wells->number_of_wells;
+            const int np = wells->number_of_phases;
+            if (np != 2) {
+                OPM_THROW(std::runtime_error, "computeTransportSource() requires a 2 phase case.");
+            }
+            for (int w = 0; w < nw; ++w) {
+                const double* comp_frac = wells->comp_frac + np*w;
+                for (int perf = wells->well_connpos[w]; perf < wells->well_connpos[w + 1]; ++perf) {
+                    const int perf_cell = wells->well_cells[perf];
+                    double perf_rate = well_perfrates[perf];
+                    if (perf_rate > 0.0) {
+                        // perf_rate is a total inflow rate, we want a water rate.
+                        if (wells->type[w] != INJECTOR) {
+                            std::cout << "**** Warning: crossflow in well "
+                                      << w << " perf " << perf - wells->well_connpos[w]
+                                      << " ignored. Rate was "
+                                      << perf_rate/Opm::unit::day << " m^3/day." << std::endl;
+                            perf_rate = 0.0;
+                        } else {
+                            assert(std::fabs(comp_frac[0] + comp_frac[1] - 1.0) < 1e-6);
+                            perf_rate *= comp_frac[0];
+                        }
+                    }
+                    transport_src[perf_cell] += perf_rate;
+                }
+            }
+        }
+    }
+
     /// @brief Estimates a scalar cell velocity from face fluxes.
     /// @param[in]  grid            a grid
     /// @param[in]  face_flux       signed per-face fluxes
@@ -144,6 +144,19 @@ namespace Opm
 			      const std::vector<double>& s,
 			      std::vector<double>& totmob);
 
+    /// @brief Computes total mobility for a set of saturation values,
+    ///        using caller-owned workspace.
+    /// @param[in]  props     rock and fluid properties
+    /// @param[in]  cells     cells with which the saturation values are associated
+    /// @param[in]  s         saturation values (for all phases)
+    /// @param[out] pmobc     workspace, holds the phase mobilities on return
+    /// @param[out] totmob    total mobilities.
+    void computeTotalMobility(const Opm::IncompPropertiesInterface& props,
+			      const std::vector<int>& cells,
+			      const std::vector<double>& s,
+			      std::vector<double>& pmobc,
+			      std::vector<double>& totmob);
+
     /// @brief Computes total mobility and omega for a set of saturation values.
     /// @param[in]  props     rock and fluid properties
     /// @param[in]  cells     cells with which the saturation values are associated
@@ -156,6 +169,21 @@ namespace Opm
 				   std::vector<double>& totmob,
 				   std::vector<double>& omega);
 
+    /// @brief Computes total mobility and omega for a set of saturation values,
+    ///        using caller-owned workspace.
+    /// @param[in]  props     rock and fluid properties
+    /// @param[in]  cells     cells with which the saturation values are associated
+    /// @param[in]  s         saturation values (for all phases)
+    /// @param[out] pmobc     workspace, holds the phase mobilities on return
+    /// @param[out] totmob    total mobility
+    /// @param[out] omega     fractional-flow weighted fluid densities.
+    void computeTotalMobilityOmega(const Opm::IncompPropertiesInterface& props,
+				   const std::vector<int>& cells,
+				   const std::vector<double>& s,
+				   std::vector<double>& pmobc,
+				   std::vector<double>& totmob,
+				   std::vector<double>& omega);
+
 
     /// @brief Computes phase mobilities for a set of saturation values.
     /// @param[in]  props     rock and fluid properties
@@ -205,6 +233,36 @@ namespace Opm
 				std::vector<double>& transport_src);
 
 
+    /// Computes the same transport source terms as
+    /// computeTransportSource(), but finds the boundary faces of the
+    /// grid once, on construction, so that each computation only
+    /// visits boundary faces and well perforations instead of all
+    /// half-faces of the grid. Keep one builder per grid to benefit.
+    class TransportSourceBuilder
+    {
+    public:
+        /// Find the boundary faces of a grid.
+        explicit TransportSourceBuilder(const UnstructuredGrid& grid);
+
+        /// Compute transport source terms.
+        /// The arguments are as for computeTransportSource().
+        void compute(const std::vector<double>& src,
+                     const std::vector<double>& faceflux,
+                     const double inflow_frac,
+                     const Wells* wells,
+                     const std::vector<double>& well_perfrates,
+                     std::vector<double>& transport_src) const;
+
+    private:
+        int num_cells_;
+        // Boundary half-faces in grid order: their cell, face, and
+        // the sign that turns the face flux into an inflow.
+        std::vector<int> bdy_cells_;
+        std::vector<int> bdy_faces_;
+        std::vector<double> bdy_sign_;
+    };
+
+
     /// @brief Estimates a scalar cell velocity from face fluxes.
     /// @param[in]  grid            a grid
     /// @param[in]  face_flux       signed per-face fluxes
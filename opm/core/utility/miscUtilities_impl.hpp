@@ -70,8 +70,9 @@ namespace Opm
                            std::vector<double>& porevol)
     {
         porevol.resize(number_of_cells);
+        rock_comp.poroMult(number_of_cells, pressure.data(), porevol.data(), 0);
         for (int i = 0; i < number_of_cells; ++i) {
-            porevol[i] = porosity[i]*begin_cell_volumes[i]*rock_comp.poroMult(pressure[i]);
+            porevol[i] *= porosity[i]*begin_cell_volumes[i];
         }
     }
 
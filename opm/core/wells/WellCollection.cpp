@@ -36,6 +36,7 @@ namespace Opm
         }
 
         roots_.push_back(createGroupWellsGroup(fieldGroup, timeStep, phaseUsage));
+        indexNodes(roots_.back().get());
     }
 
     void WellCollection::addGroup(const Group& groupChild, std::string parent_name,
@@ -66,6 +67,7 @@ namespace Opm
         }
         parent_as_group->addChild(child);
         child->setParent(parent);
+        indexNodes(child.get());
     }
 
     void WellCollection::addWell(const Well* wellChild, size_t timeStep, const PhaseUsage& phaseUsage) {
@@ -90,6 +92,7 @@ namespace Opm
         leaf_nodes_.push_back(static_cast<WellNode*>(child.get()));
 
         child->setParent(parent);
+        indexNodes(child.get());
     }
 
     const std::vector<WellNode*>& WellCollection::getLeafNodes() const {
@@ -98,42 +101,51 @@ namespace Opm
 
     WellsGroupInterface* WellCollection::findNode(const std::string& name)
     {
-
-        for (size_t i = 0; i < roots_.size(); i++) {
-            WellsGroupInterface* result = roots_[i]->findGroup(name);
-            if (result) {
-                return result;
-            }
-        }
-        return NULL;
+        auto it = node_index_.find(name);
+        return it == node_index_.end() ? NULL : it->second;
     }
 
     const WellsGroupInterface* WellCollection::findNode(const std::string& name) const
     {
-
-        for (size_t i = 0; i < roots_.size(); i++) {
-            WellsGroupInterface* result = roots_[i]->findGroup(name);
-            if (result) {
-                return result;
-            }
-        }
-        return NULL;
+        auto it = node_index_.find(name);
+        return it == node_index_.end() ? NULL : it->second;
     }
 
 
     WellNode& WellCollection::findWellNode(const std::string& name) const
     {
-        auto well_node = std::find_if(leaf_nodes_.begin(), leaf_nodes_.end(),
-                    [&] ( WellNode* w) {
-                    return w->name() == name;
-                    });
+        auto it = node_index_.find(name);
 
         // Does not find the well
-        if (well_node == leaf_nodes_.end()) {
+        if (it == node_index_.end() || !it->second->isLeafNode()) {
             OPM_THROW(std::runtime_error, "Could not find well " << name << " in the well collection!\n");
         }
 
-        return *(*well_node);
+        return *static_cast<WellNode*>(it->second);
+    }
+
+
+    void WellCollection::indexNodes(WellsGroupInterface* node)
+    {
+        // Keep the first node of a given name, as the depth-first
+        // search of findGroup() did.
+        node_index_.emplace(node->name(), node);
+        if (!node->isLeafNode()) {
+            for (const std::shared_ptr<WellsGroupInterface>& child : static_cast<WellsGroup*>(node)->children()) {
+                indexNodes(child.get());
+            }
+        }
+        group_tree_valid_ = false;
+    }
+
+
+    WellGroupTree& WellCollection::groupTree()
+    {
+        if (!group_tree_valid_) {
+            group_tree_.build(roots_);
+            group_tree_valid_ = true;
+        }
+        return group_tree_;
     }
 
     /// Adds the child to the collection
@@ -153,7 +165,7 @@ namespace Opm
         if (child_node->isLeafNode()) {
             leaf_nodes_.push_back(static_cast<WellNode*>(child_node.get()));
         }
-
+        indexNodes(child_node.get());
     }
 
     /// Adds the node to the collection (as a root node)
@@ -164,6 +176,7 @@ namespace Opm
         if (child_node->isLeafNode()) {
             leaf_nodes_.push_back(static_cast<WellNode*> (child_node.get()));
         }
+        indexNodes(child_node.get());
     }
 
     bool WellCollection::conditionsMet(const std::vector<double>& well_bhp,
@@ -190,9 +203,10 @@ namespace Opm
 
     void WellCollection::applyGroupControls()
     {
-        for (size_t i = 0; i < roots_.size(); ++i) {
-            roots_[i]->applyProdGroupControls();
-            roots_[i]->applyInjGroupControls();
+        WellGroupTree& tree = groupTree();
+        for (int i = 0; i < tree.numTrees(); ++i) {
+            tree.applyProdGroupControls(i);
+            tree.applyInjGroupControls(i);
         }
 
         group_control_applied_ = true;
@@ -211,8 +225,9 @@ namespace Opm
     void WellCollection::applyExplicitReinjectionControls(const std::vector<double>& well_reservoirrates_phase,
                                                           const std::vector<double>& well_surfacerates_phase)
     {
-        for (size_t i = 0; i < roots_.size(); ++i) {
-            roots_[i]->applyExplicitReinjectionControls(well_reservoirrates_phase, well_surfacerates_phase);
+        WellGroupTree& tree = groupTree();
+        for (int i = 0; i < tree.numTrees(); ++i) {
+            tree.applyExplicitReinjectionControls(i, well_reservoirrates_phase, well_surfacerates_phase);
         }
     }
 
@@ -21,8 +21,11 @@
 
 #include <vector>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 #include <opm/core/wells/WellsGroup.hpp>
+#include <opm/core/wells/WellGroupTree.hpp>
 #include <opm/core/grid.h>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 
@@ -159,12 +162,25 @@ namespace Opm
         bool requireWellPotentials() const;
 
     private:
+        // Adds the node and all its descendants to the name index.
+        void indexNodes(WellsGroupInterface* node);
+
+        // The flattened hierarchy, rebuilt if nodes have been added.
+        WellGroupTree& groupTree();
+
         // To account for the possibility of a forest
         std::vector<std::shared_ptr<WellsGroupInterface> > roots_;
 
         // This will be used to traverse the bottom nodes.
         std::vector<WellNode*> leaf_nodes_;
 
+        // All nodes by name, for findNode().
+        std::unordered_map<std::string, WellsGroupInterface*> node_index_;
+
+        // Used by applyGroupControls() and applyExplicitReinjectionControls().
+        WellGroupTree group_tree_;
+        bool group_tree_valid_ = false;
+
         bool having_vrep_groups_ = false;
 
         bool group_control_active_ = false;
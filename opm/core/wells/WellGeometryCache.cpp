@@ -0,0 +1,177 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/wells/WellGeometryCache.hpp>
+
+#include <opm/core/props/rock/RockFromDeck.hpp>
+#include <opm/core/utility/CompressedPropertyAccess.hpp>
+#include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
+#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
+
+#include <algorithm>
+
+namespace Opm
+{
+
+    namespace
+    {
+        // Use a dense Cartesian-to-active map unless the Cartesian box
+        // has more than this many cells per active cell.
+        const int max_dense_ratio = 8;
+    }
+
+
+    bool CompletionKey::operator==(const CompletionKey& other) const
+    {
+        return i == other.i && j == other.j && k == other.k
+            && direction == other.direction
+            && sat_table_id == other.sat_table_id
+            && has_trans_factor == other.has_trans_factor
+            && trans_factor == other.trans_factor
+            && diameter == other.diameter
+            && skin_factor == other.skin_factor
+            && well_pi == other.well_pi;
+    }
+
+
+    WellGeometryCache::WellGeometryCache()
+        : number_of_cells_(-1),
+          cart_dims_{{ 0, 0, 0 }}
+    {
+    }
+
+
+    bool WellGeometryCache::matchesGrid(const int number_of_cells,
+                                        const int* global_cell,
+                                        const int* cart_dims) const
+    {
+        if (number_of_cells != number_of_cells_
+            || !std::equal(cart_dims_.begin(), cart_dims_.end(), cart_dims)) {
+            return false;
+        }
+        if (global_cell == 0) {
+            return global_cell_.empty();
+        }
+        return int(global_cell_.size()) == number_of_cells
+            && std::equal(global_cell_.begin(), global_cell_.end(), global_cell);
+    }
+
+
+    bool WellGeometryCache::init(const EclipseState& eclipseState,
+                                 const int number_of_cells,
+                                 const int* global_cell,
+                                 const int* cart_dims)
+    {
+        if (matchesGrid(number_of_cells, global_cell, cart_dims)) {
+            return false;
+        }
+        number_of_cells_ = number_of_cells;
+        std::copy(cart_dims, cart_dims + 3, cart_dims_.begin());
+        if (global_cell) {
+            global_cell_.assign(global_cell, global_cell + number_of_cells);
+        } else {
+            global_cell_.clear();
+        }
+        wells_.clear();
+
+        // Cartesian to active cell map.
+        const int num_cartesian = cart_dims[0]*cart_dims[1]*cart_dims[2];
+        cartesian_to_active_.clear();
+        cartesian_to_active_map_.clear();
+        if (num_cartesian <= max_dense_ratio*number_of_cells) {
+            cartesian_to_active_.assign(num_cartesian, -1);
+            for (int cell = 0; cell < number_of_cells; ++cell) {
+                cartesian_to_active_[global_cell ? global_cell[cell] : cell] = cell;
+            }
+        } else {
+            cartesian_to_active_map_.reserve(number_of_cells);
+            for (int cell = 0; cell < number_of_cells; ++cell) {
+                cartesian_to_active_map_[global_cell ? global_cell[cell] : cell] = cell;
+            }
+        }
+
+        // Net-to-gross.
+        typedef GridPropertyAccess::ArrayPolicy::ExtractFromDeck<double> DoubleArray;
+        typedef GridPropertyAccess::Compressed<DoubleArray, GridPropertyAccess::Tag::NTG> NTGArray;
+        DoubleArray ntg_glob(eclipseState, "NTG", 1.0);
+        NTGArray    ntg(ntg_glob, global_cell);
+        ntg_.resize(number_of_cells);
+        for (int cell = 0; cell < number_of_cells; ++cell) {
+            ntg_[cell] = ntg[cell];
+        }
+
+        // Cell thickness from the input grid.
+        const auto& eclGrid = eclipseState.getInputGrid();
+        dz_.resize(number_of_cells);
+        for (int cell = 0; cell < number_of_cells; ++cell) {
+            dz_[cell] = eclGrid.getCellThicknes(global_cell ? global_cell[cell] : cell);
+        }
+
+        RockFromDeck::extractInterleavedPermeability(eclipseState,
+                                                     number_of_cells,
+                                                     global_cell,
+                                                     cart_dims,
+                                                     0.0,
+                                                     permeability_);
+        return true;
+    }
+
+
+    void WellGeometryCache::invalidate()
+    {
+        number_of_cells_ = -1;
+        global_cell_.clear();
+        cart_dims_.fill(0);
+        cartesian_to_active_.clear();
+        cartesian_to_active_map_.clear();
+        permeability_.clear();
+        ntg_.clear();
+        dz_.clear();
+        wells_.clear();
+    }
+
+
+    const std::vector<PerfData>*
+    WellGeometryCache::perforations(const std::string& well_name,
+                                    const std::vector<CompletionKey>& completions,
+                                    const std::vector<int>& closed_connections) const
+    {
+        auto it = wells_.find(well_name);
+        if (it == wells_.end()
+            || !(it->second.completions == completions)
+            || it->second.closed_connections != closed_connections) {
+            return 0;
+        }
+        return &it->second.perforations;
+    }
+
+
+    void WellGeometryCache::setPerforations(const std::string& well_name,
+                                            const std::vector<CompletionKey>& completions,
+                                            const std::vector<int>& closed_connections,
+                                            const std::vector<PerfData>& perforations)
+    {
+        CachedWell& cached = wells_[well_name];
+        cached.completions = completions;
+        cached.closed_connections = closed_connections;
+        cached.perforations = perforations;
+    }
+
+} // namespace Opm
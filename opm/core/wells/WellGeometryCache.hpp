@@ -0,0 +1,151 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_WELLGEOMETRYCACHE_HEADER_INCLUDED
+#define OPM_WELLGEOMETRYCACHE_HEADER_INCLUDED
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Opm
+{
+
+    class EclipseState;
+
+    struct PerfData
+    {
+        int cell;
+        double well_index;
+        int satnumid;
+    };
+
+
+    /// The completion data that determine a perforation's well index.
+    struct CompletionKey
+    {
+        int i;
+        int j;
+        int k;
+        int direction;
+        int sat_table_id;
+        bool has_trans_factor;
+        double trans_factor;
+        double diameter;
+        double skin_factor;
+        double well_pi;
+
+        bool operator==(const CompletionKey& other) const;
+    };
+
+
+    /// Grid-wide data needed to set up wells, and the perforations of
+    /// each well, kept across report steps.
+    ///
+    /// Pass the same cache to the WellsManager constructed at each
+    /// report step. The Cartesian-to-active cell map, permeability,
+    /// net-to-gross and cell thickness are then extracted from the
+    /// input only once, and well indices are only recomputed for wells
+    /// whose open completions have changed.
+    ///
+    /// The grid-wide data are extracted again whenever init() is called
+    /// with a different cell count, Cartesian dimensions or active cell
+    /// map. A cache must only be used with one input deck, unless
+    /// invalidate() is called after switching decks.
+    class WellGeometryCache
+    {
+    public:
+        WellGeometryCache();
+
+        /// Extract the grid-wide arrays, unless already done for this
+        /// grid.
+        /// \return true if the arrays were extracted, false if the
+        ///         cached arrays were kept.
+        bool init(const EclipseState& eclipseState,
+                  const int number_of_cells,
+                  const int* global_cell,
+                  const int* cart_dims);
+
+        /// Discard all cached data, so that the next init() extracts
+        /// the grid-wide arrays again.
+        void invalidate();
+
+        /// Active cell index of a Cartesian cell, or -1 if inactive.
+        int activeCell(const int cartesian_index) const
+        {
+            if (!cartesian_to_active_.empty()) {
+                return (cartesian_index >= 0 && cartesian_index < int(cartesian_to_active_.size()))
+                    ? cartesian_to_active_[cartesian_index] : -1;
+            }
+            auto it = cartesian_to_active_map_.find(cartesian_index);
+            return it == cartesian_to_active_map_.end() ? -1 : it->second;
+        }
+
+        /// Interleaved permeability, 9 values per active cell.
+        const double* permeability() const { return permeability_.data(); }
+
+        /// Net-to-gross per active cell.
+        const std::vector<double>& ntg() const { return ntg_; }
+
+        /// Cell thickness per active cell.
+        const std::vector<double>& dz() const { return dz_; }
+
+        /// Perforations computed earlier for a well, or null if there
+        /// are none or they were computed from different completions
+        /// or closed connections.
+        const std::vector<PerfData>* perforations(const std::string& well_name,
+                                                  const std::vector<CompletionKey>& completions,
+                                                  const std::vector<int>& closed_connections) const;
+
+        /// Store the perforations computed for a well.
+        void setPerforations(const std::string& well_name,
+                             const std::vector<CompletionKey>& completions,
+                             const std::vector<int>& closed_connections,
+                             const std::vector<PerfData>& perforations);
+
+    private:
+        struct CachedWell
+        {
+            std::vector<CompletionKey> completions;
+            std::vector<int> closed_connections;
+            std::vector<PerfData> perforations;
+        };
+
+        bool matchesGrid(const int number_of_cells,
+                         const int* global_cell,
+                         const int* cart_dims) const;
+
+        int number_of_cells_;
+        // Copy of the grid's active cell map, empty if it has none.
+        std::vector<int> global_cell_;
+        std::array<int, 3> cart_dims_;
+        // Dense map when the Cartesian box is not much larger than the
+        // active grid, otherwise a hash map.
+        std::vector<int> cartesian_to_active_;
+        std::unordered_map<int, int> cartesian_to_active_map_;
+        std::vector<double> permeability_;
+        std::vector<double> ntg_;
+        std::vector<double> dz_;
+        std::unordered_map<std::string, CachedWell> wells_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_WELLGEOMETRYCACHE_HEADER_INCLUDED
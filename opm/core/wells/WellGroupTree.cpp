@@ -0,0 +1,394 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+#include <opm/core/wells/WellGroupTree.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+
+namespace Opm
+{
+
+    void WellGroupTree::build(const std::vector<std::shared_ptr<WellsGroupInterface> >& roots)
+    {
+        nodes_.clear();
+        parent_.clear();
+        child_begin_.clear();
+        child_end_.clear();
+        tree_begin_.assign(1, 0);
+
+        for (const std::shared_ptr<WellsGroupInterface>& root : roots) {
+            // Breadth-first numbering: the children of node i are
+            // appended when i is visited, which makes them contiguous.
+            nodes_.push_back(root.get());
+            parent_.push_back(-1);
+            for (int i = tree_begin_.back(); i < int(nodes_.size()); ++i) {
+                child_begin_.push_back(nodes_.size());
+                if (!nodes_[i]->isLeafNode()) {
+                    const WellsGroup* group = static_cast<const WellsGroup*>(nodes_[i]);
+                    for (const std::shared_ptr<WellsGroupInterface>& child : group->children()) {
+                        nodes_.push_back(child.get());
+                        parent_.push_back(i);
+                    }
+                }
+                child_end_.push_back(nodes_.size());
+            }
+            tree_begin_.push_back(nodes_.size());
+        }
+
+        const int num_nodes = nodes_.size();
+        calls_.resize(num_nodes);
+        rates_all_.resize(num_nodes);
+        rates_group_.resize(num_nodes);
+        flows_.resize(num_nodes);
+    }
+
+
+
+    void WellGroupTree::productionGuideRates(const bool only_group,
+                                             std::vector<double>& rates) const
+    {
+        rates.resize(nodes_.size());
+        guideRates(true, only_group, 0, nodes_.size(), rates);
+    }
+
+
+
+    void WellGroupTree::injectionGuideRates(const bool only_group,
+                                            std::vector<double>& rates) const
+    {
+        rates.resize(nodes_.size());
+        guideRates(false, only_group, 0, nodes_.size(), rates);
+    }
+
+
+
+    void WellGroupTree::totalProductionFlows(const std::vector<double>& phase_flows,
+                                             const BlackoilPhases::PhaseIndex phase,
+                                             std::vector<double>& flows) const
+    {
+        flows.resize(nodes_.size());
+        productionFlows(phase_flows, phase, 0, nodes_.size(), flows);
+    }
+
+
+
+    void WellGroupTree::applyProdGroupControls(const int tree)
+    {
+        const int first = tree_begin_[tree];
+        const int last = tree_begin_[tree + 1];
+        guideRates(true, false, first, last, rates_all_);
+        guideRates(true, true, first, last, rates_group_);
+        for (int i = first; i < last; ++i) {
+            calls_[i].type = NoCall;
+        }
+        calls_[first].type = ApplyControls;
+        distributeProduction(first, last);
+    }
+
+
+
+    void WellGroupTree::applyInjGroupControls(const int tree)
+    {
+        const int first = tree_begin_[tree];
+        const int last = tree_begin_[tree + 1];
+        guideRates(false, false, first, last, rates_all_);
+        guideRates(false, true, first, last, rates_group_);
+        for (int i = first; i < last; ++i) {
+            calls_[i].type = NoCall;
+        }
+        calls_[first].type = ApplyControls;
+        distributeInjection(first, last);
+    }
+
+
+
+    void WellGroupTree::applyExplicitReinjectionControls(const int tree,
+                                                         const std::vector<double>& well_reservoirrates_phase,
+                                                         const std::vector<double>& well_surfacerates_phase)
+    {
+        const int first = tree_begin_[tree];
+        const int last = tree_begin_[tree + 1];
+        WellsGroupInterface* root = nodes_[first];
+        if (root->isLeafNode()) {
+            // Do nothing at well level.
+            return;
+        }
+
+        const InjectionSpecification& inj_spec = root->injSpec();
+        const InjectionSpecification::ControlMode inj_mode = inj_spec.control_mode_;
+        if (inj_mode != InjectionSpecification::REIN && inj_mode != InjectionSpecification::VREP) {
+            return;
+        }
+
+        guideRates(false, false, first, last, rates_all_);
+        guideRates(false, true, first, last, rates_group_);
+        for (int i = first; i < last; ++i) {
+            calls_[i].type = NoCall;
+        }
+
+        PendingCall call;
+        call.type = ApplyControl;
+        call.injector_type = inj_spec.injector_type_;
+        const double my_guide_rate = rates_group_[first];
+        if (inj_mode == InjectionSpecification::REIN) {
+            // Defaulting to water to satisfy -Wmaybe-uninitialized
+            BlackoilPhases::PhaseIndex phase = BlackoilPhases::Aqua;
+            switch (inj_spec.injector_type_) {
+            case InjectionSpecification::WATER:
+                phase = BlackoilPhases::Aqua;
+                break;
+            case InjectionSpecification::GAS:
+                phase = BlackoilPhases::Vapour;
+                break;
+            case InjectionSpecification::OIL:
+                phase = BlackoilPhases::Liquid;
+                break;
+            }
+            productionFlows(well_surfacerates_phase, phase, first, last, flows_);
+            const double total_reinjected = - flows_[first]; // Production negative, injection positive
+            call.mode = InjectionSpecification::RATE;
+            call.only_group = true;
+            for (int c = child_begin_[first]; c < child_end_[first]; ++c) {
+                call.target = (rates_group_[c] / my_guide_rate) * total_reinjected * inj_spec.reinjection_fraction_target_;
+                calls_[c] = call;
+            }
+        } else {
+            const BlackoilPhases::PhaseIndex phases[] = { BlackoilPhases::Aqua,
+                                                          BlackoilPhases::Liquid,
+                                                          BlackoilPhases::Vapour };
+            double total_produced = 0.0;
+            for (const BlackoilPhases::PhaseIndex phase : phases) {
+                if (root->phaseUsage().phase_used[phase]) {
+                    productionFlows(well_reservoirrates_phase, phase, first, last, flows_);
+                    total_produced += flows_[first];
+                }
+            }
+            const double total_reinjected = - total_produced; // Production negative, injection positive
+            call.mode = InjectionSpecification::RESV;
+            call.only_group = false;
+            for (int c = child_begin_[first]; c < child_end_[first]; ++c) {
+                call.target = (rates_all_[c] / my_guide_rate) * total_reinjected * inj_spec.voidage_replacment_fraction_;
+                calls_[c] = call;
+            }
+        }
+        distributeInjection(first, last);
+    }
+
+
+
+    void WellGroupTree::guideRates(const bool production, const bool only_group,
+                                   const int first, const int last,
+                                   std::vector<double>& rates) const
+    {
+        // Children come after their parents, so a reverse sweep sees
+        // every child before its parent.
+        for (int i = last - 1; i >= first; --i) {
+            WellsGroupInterface* node = nodes_[i];
+            if (node->isLeafNode()) {
+                rates[i] = production ? node->productionGuideRate(only_group)
+                                      : node->injectionGuideRate(only_group);
+                continue;
+            }
+            double sum = 0.0;
+            for (int c = child_begin_[i]; c < child_end_[i]; ++c) {
+                // Groups skip individually controlled children only
+                // when summing production guide rates.
+                if (production && only_group && nodes_[c]->individualControl()) {
+                    continue;
+                }
+                sum += rates[c];
+            }
+            rates[i] = sum;
+        }
+    }
+
+
+
+    void WellGroupTree::productionFlows(const std::vector<double>& phase_flows,
+                                        const BlackoilPhases::PhaseIndex phase,
+                                        const int first, const int last,
+                                        std::vector<double>& flows) const
+    {
+        for (int i = last - 1; i >= first; --i) {
+            if (nodes_[i]->isLeafNode()) {
+                flows[i] = nodes_[i]->getTotalProductionFlow(phase_flows, phase);
+                continue;
+            }
+            double sum = 0.0;
+            for (int c = child_begin_[i]; c < child_end_[i]; ++c) {
+                sum += flows[c];
+            }
+            flows[i] = sum;
+        }
+    }
+
+
+
+    // Forward sweep replacing the recursion of
+    // WellsGroup::applyProdGroupControls() and applyProdGroupControl().
+    // The guide rates are computed before the sweep; they are valid
+    // throughout since a node is only modified after its ancestors
+    // have been visited.
+    void WellGroupTree::distributeProduction(const int first, const int last)
+    {
+        for (int i = first; i < last; ++i) {
+            const PendingCall call = calls_[i];
+            if (call.type == NoCall) {
+                continue;
+            }
+            WellsGroupInterface* node = nodes_[i];
+            const ProductionSpecification::ControlMode mode
+                = static_cast<ProductionSpecification::ControlMode>(call.mode);
+
+            if (node->isLeafNode()) {
+                if (call.type == ApplyControl) {
+                    node->applyProdGroupControl(mode, call.target, call.only_group);
+                }
+                continue;
+            }
+
+            if (call.type == ApplyControls) {
+                const ProductionSpecification::ControlMode prod_mode = node->prodSpec().control_mode_;
+                switch (prod_mode) {
+                case ProductionSpecification::ORAT:
+                case ProductionSpecification::WRAT:
+                case ProductionSpecification::LRAT:
+                case ProductionSpecification::RESV:
+                {
+                    const double my_guide_rate = rates_all_[i];
+                    if (my_guide_rate == 0) {
+                        OPM_THROW(std::runtime_error, "Can't apply group control for group " << node->name() << " as the sum of guide rates for all group controlled wells is zero.");
+                    }
+                    for (int c = child_begin_[i]; c < child_end_[i]; ++c) {
+                        calls_[c].type = ApplyControl;
+                        calls_[c].mode = prod_mode;
+                        calls_[c].target = (rates_all_[c] / my_guide_rate) * node->getTarget(prod_mode);
+                        calls_[c].only_group = false;
+                    }
+                    break;
+                }
+                case ProductionSpecification::FLD:
+                case ProductionSpecification::NONE:
+                    for (int c = child_begin_[i]; c < child_end_[i]; ++c) {
+                        calls_[c].type = ApplyControls;
+                    }
+                    break;
+                default:
+                    OPM_THROW(std::runtime_error, "Unhandled group production control type " << prod_mode);
+                }
+                continue;
+            }
+
+            ProductionSpecification& prod_spec = node->prodSpec();
+            if (prod_spec.control_mode_ == ProductionSpecification::NONE) {
+                continue;
+            }
+            if (!call.only_group || prod_spec.control_mode_ == ProductionSpecification::FLD) {
+                const std::vector<double>& rates = call.only_group ? rates_group_ : rates_all_;
+                const double my_guide_rate = rates[i];
+                if (my_guide_rate == 0.0) {
+                    // Nothing to do here
+                    continue;
+                }
+                for (int c = child_begin_[i]; c < child_end_[i]; ++c) {
+                    calls_[c] = call;
+                    calls_[c].target = call.target / node->efficiencyFactor() * rates[c] / my_guide_rate;
+                }
+                prod_spec.control_mode_ = ProductionSpecification::FLD;
+            }
+        }
+    }
+
+
+
+    // Forward sweep replacing the recursion of
+    // WellsGroup::applyInjGroupControls() and applyInjGroupControl().
+    void WellGroupTree::distributeInjection(const int first, const int last)
+    {
+        for (int i = first; i < last; ++i) {
+            const PendingCall call = calls_[i];
+            if (call.type == NoCall) {
+                continue;
+            }
+            WellsGroupInterface* node = nodes_[i];
+            const InjectionSpecification::ControlMode mode
+                = static_cast<InjectionSpecification::ControlMode>(call.mode);
+
+            if (node->isLeafNode()) {
+                if (call.type == ApplyControl) {
+                    node->applyInjGroupControl(mode, call.injector_type, call.target, call.only_group);
+                }
+                continue;
+            }
+
+            if (call.type == ApplyControls) {
+                const InjectionSpecification::ControlMode inj_mode = node->injSpec().control_mode_;
+                switch (inj_mode) {
+                case InjectionSpecification::RATE:
+                case InjectionSpecification::RESV:
+                {
+                    const double my_guide_rate = rates_all_[i];
+                    for (int c = child_begin_[i]; c < child_end_[i]; ++c) {
+                        calls_[c].type = ApplyControl;
+                        calls_[c].mode = inj_mode;
+                        calls_[c].injector_type = node->injSpec().injector_type_;
+                        calls_[c].target = (rates_all_[c] / my_guide_rate) * node->getTarget(inj_mode) / node->efficiencyFactor();
+                        calls_[c].only_group = false;
+                    }
+                    break;
+                }
+                case InjectionSpecification::VREP:
+                case InjectionSpecification::REIN:
+                    break;
+                case InjectionSpecification::FLD:
+                case InjectionSpecification::NONE:
+                    for (int c = child_begin_[i]; c < child_end_[i]; ++c) {
+                        calls_[c].type = ApplyControls;
+                    }
+                    break;
+                default:
+                    OPM_THROW(std::runtime_error, "Unhandled group injection control mode " << inj_mode);
+                }
+                continue;
+            }
+
+            InjectionSpecification& inj_spec = node->injSpec();
+            if (inj_spec.control_mode_ == InjectionSpecification::NONE) {
+                // TODO: for multiple level of group control, it can be wrong to return here.
+                continue;
+            }
+            if (!call.only_group || inj_spec.control_mode_ == InjectionSpecification::FLD) {
+                const std::vector<double>& rates = call.only_group ? rates_group_ : rates_all_;
+                const double my_guide_rate = rates[i];
+                if (my_guide_rate == 0.0) {
+                    // Nothing to do here
+                    continue;
+                }
+                for (int c = child_begin_[i]; c < child_end_[i]; ++c) {
+                    calls_[c] = call;
+                    calls_[c].target = call.target / node->efficiencyFactor() * rates[c] / my_guide_rate;
+                    calls_[c].only_group = false;
+                }
+                inj_spec.control_mode_ = InjectionSpecification::FLD;
+            }
+        }
+    }
+
+} // namespace Opm
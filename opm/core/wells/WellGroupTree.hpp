@@ -0,0 +1,139 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_WELLGROUPTREE_HEADER_INCLUDED
+#define OPM_WELLGROUPTREE_HEADER_INCLUDED
+
+#include <opm/core/wells/WellsGroup.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Flattened view of a forest of well groups and wells.
+    ///
+    /// The nodes are numbered breadth-first, one tree after the
+    /// other, so that the children of each node occupy a contiguous
+    /// index range and every node comes after its parent. Quantities
+    /// that are sums over descendants (guide rates, production
+    /// flows) are then computed by one reverse sweep over the nodes,
+    /// and group targets are distributed by one forward sweep,
+    /// instead of by recursion through the virtual methods of
+    /// WellsGroupInterface, which recompute the child sums at every
+    /// level.
+    ///
+    /// The sweeps give the same results as the recursive methods
+    /// applyProdGroupControls(), applyInjGroupControls() and
+    /// applyExplicitReinjectionControls() of the root nodes. The
+    /// nodes are not owned, and the structure must be rebuilt when
+    /// nodes are added to the hierarchy.
+    class WellGroupTree
+    {
+    public:
+        /// Number the nodes of the trees with the given roots.
+        void build(const std::vector<std::shared_ptr<WellsGroupInterface> >& roots);
+
+        /// Number of nodes in all trees.
+        int numNodes() const { return nodes_.size(); }
+
+        /// Number of trees.
+        int numTrees() const { return tree_begin_.empty() ? 0 : tree_begin_.size() - 1; }
+
+        /// The node with the given index.
+        WellsGroupInterface* node(const int index) const { return nodes_[index]; }
+
+        /// Index of the parent of a node, or -1 for roots.
+        int parent(const int index) const { return parent_[index]; }
+
+        /// Range [childBegin(), childEnd()) of child indices of a node.
+        int childBegin(const int index) const { return child_begin_[index]; }
+        int childEnd(const int index) const { return child_end_[index]; }
+
+        /// Production guide rates of all nodes, as returned by
+        /// WellsGroupInterface::productionGuideRate(only_group).
+        void productionGuideRates(const bool only_group,
+                                  std::vector<double>& rates) const;
+
+        /// Injection guide rates of all nodes, as returned by
+        /// WellsGroupInterface::injectionGuideRate(only_group).
+        void injectionGuideRates(const bool only_group,
+                                 std::vector<double>& rates) const;
+
+        /// Total production flows of the given phase for all nodes,
+        /// as returned by WellsGroupInterface::getTotalProductionFlow().
+        void totalProductionFlows(const std::vector<double>& phase_flows,
+                                  const BlackoilPhases::PhaseIndex phase,
+                                  std::vector<double>& flows) const;
+
+        /// Apply the production group controls of one tree, as
+        /// applyProdGroupControls() on its root.
+        void applyProdGroupControls(const int tree);
+
+        /// Apply the injection group controls of one tree, as
+        /// applyInjGroupControls() on its root.
+        void applyInjGroupControls(const int tree);
+
+        /// Apply the explicit reinjection controls of one tree, as
+        /// applyExplicitReinjectionControls() on its root.
+        void applyExplicitReinjectionControls(const int tree,
+                                              const std::vector<double>& well_reservoirrates_phase,
+                                              const std::vector<double>& well_surfacerates_phase);
+
+    private:
+        // A group control call waiting to be applied to a node by the
+        // forward sweep: either applyProd/InjGroupControls() or
+        // applyProd/InjGroupControl() with the stored arguments.
+        enum CallType { NoCall, ApplyControls, ApplyControl };
+        struct PendingCall
+        {
+            CallType type;
+            int mode;
+            InjectionSpecification::InjectorType injector_type;
+            double target;
+            bool only_group;
+        };
+
+        void guideRates(const bool production, const bool only_group,
+                        const int first, const int last,
+                        std::vector<double>& rates) const;
+        void productionFlows(const std::vector<double>& phase_flows,
+                             const BlackoilPhases::PhaseIndex phase,
+                             const int first, const int last,
+                             std::vector<double>& flows) const;
+        void distributeProduction(const int first, const int last);
+        void distributeInjection(const int first, const int last);
+
+        std::vector<WellsGroupInterface*> nodes_;
+        std::vector<int> parent_;
+        std::vector<int> child_begin_;
+        std::vector<int> child_end_;
+        std::vector<int> tree_begin_;
+
+        // Work arrays for the sweeps.
+        std::vector<PendingCall> calls_;
+        std::vector<double> rates_all_;
+        std::vector<double> rates_group_;
+        std::vector<double> flows_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_WELLGROUPTREE_HEADER_INCLUDED
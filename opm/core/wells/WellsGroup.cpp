@@ -454,6 +454,12 @@ namespace Opm
     }
 
 
+    const std::vector<std::shared_ptr<WellsGroupInterface> >& WellsGroup::children() const
+    {
+        return children_;
+    }
+
+
     int WellsGroup::numberOfLeafNodes() {
         // This could probably use some caching, but seeing as how the number of
         // wells is relatively small, we'll do without for now.
@@ -295,6 +295,9 @@ namespace Opm
 
         void addChild(std::shared_ptr<WellsGroupInterface> child);
 
+        /// The direct children of this group, in the order they were added.
+        const std::vector<std::shared_ptr<WellsGroupInterface> >& children() const;
+
         virtual bool conditionsMet(const std::vector<double>& well_bhp,
                                    const std::vector<double>& well_reservoirrates_phase,
                                    const std::vector<double>& well_surfacerates_phase,
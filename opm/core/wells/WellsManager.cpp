@@ -335,15 +335,33 @@ namespace Opm
         // TODO: not sure about the usage of this WellsManager constructor
         // TODO: not sure whether this is the correct thing to do here.
         DynamicListEconLimited dummy_list_econ_limited;
+        WellGeometryCache geometry;
         init(eclipseState, schedule, timeStep, UgGridHelpers::numCells(grid),
              UgGridHelpers::globalCell(grid), UgGridHelpers::cartDims(grid), 
              UgGridHelpers::dimensions(grid),
              UgGridHelpers::cell2Faces(grid), UgGridHelpers::beginFaceCentroids(grid),
-             dummy_list_econ_limited,
+             dummy_list_econ_limited, geometry,
              std::unordered_set<std::string>());
 
     }
 
+    /// Construct wells from deck, reusing cached grid data.
+    WellsManager::WellsManager(const Opm::EclipseState& eclipseState,
+                               const Opm::Schedule& schedule,
+                               const size_t timeStep,
+                               const UnstructuredGrid& grid,
+                               WellGeometryCache& geometry)
+        : w_(0), is_parallel_run_(false)
+    {
+        DynamicListEconLimited dummy_list_econ_limited;
+        init(eclipseState, schedule, timeStep, UgGridHelpers::numCells(grid),
+             UgGridHelpers::globalCell(grid), UgGridHelpers::cartDims(grid),
+             UgGridHelpers::dimensions(grid),
+             UgGridHelpers::cell2Faces(grid), UgGridHelpers::beginFaceCentroids(grid),
+             dummy_list_econ_limited, geometry,
+             std::unordered_set<std::string>());
+    }
+
     /// Destructor.
     WellsManager::~WellsManager()
     {
@@ -403,26 +421,6 @@ namespace Opm
         well_collection_.applyExplicitReinjectionControls(well_reservoirrates_phase, well_surfacerates_phase);
     }
 
-    void WellsManager::setupCompressedToCartesian(const int* global_cell, int number_of_cells,
-                                                  std::map<int,int>& cartesian_to_compressed ) {
-        // global_cell is a map from compressed cells to Cartesian grid cells.
-        // We must make the inverse lookup.
-
-        if (global_cell) {
-            for (int i = 0; i < number_of_cells; ++i) {
-                cartesian_to_compressed.insert(std::make_pair(global_cell[i], i));
-            }
-        }
-        else {
-            for (int i = 0; i < number_of_cells; ++i) {
-                cartesian_to_compressed.insert(std::make_pair(i, i));
-            }
-        }
-
-    }
-
-
-
     void WellsManager::setupWellControls(std::vector< const Well* >& wells, size_t timeStep,
                                          std::vector<std::string>& well_names, const PhaseUsage& phaseUsage,
                                          const std::vector<int>& wells_on_proc,
@@ -25,6 +25,7 @@
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 
 #include <opm/core/wells/WellCollection.hpp>
+#include <opm/core/wells/WellGeometryCache.hpp>
 #include <opm/core/wells/WellsGroup.hpp>
 #include <opm/core/wells/DynamicListEconLimited.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/GroupTree.hpp>
@@ -51,13 +52,6 @@ namespace Opm
         int welspecsline;
     };
 
-
-    struct PerfData
-    {
-        int cell;
-        double well_index;
-        int satnumid;
-    };
     /// This class manages a Wells struct in the sense that it
     /// encapsulates creation and destruction of the wells
     /// data structure.
@@ -97,10 +91,38 @@ namespace Opm
                      bool is_parallel_run=false,
                      const std::unordered_set<std::string>& deactivated_wells = std::unordered_set<std::string> ());
 
+        /// Construct from input deck and grid, reusing grid data and
+        /// well indices from earlier report steps.
+        ///
+        /// \param geometry Cache kept by the caller across report steps.
+        ///        Must only be used with one grid and one input deck.
+        template<class F2C, class FC>
+        WellsManager(const Opm::EclipseState& eclipseState,
+                     const Opm::Schedule& schedule,
+                     const size_t timeStep,
+                     int num_cells,
+                     const int* global_cell,
+                     const int* cart_dims,
+                     int dimensions,
+                     const F2C& f2c,
+                     FC begin_face_centroids,
+                     const DynamicListEconLimited& list_econ_limited,
+                     WellGeometryCache& geometry,
+                     bool is_parallel_run=false,
+                     const std::unordered_set<std::string>& deactivated_wells = std::unordered_set<std::string> ());
+
         WellsManager(const Opm::EclipseState& eclipseState,
                      const Opm::Schedule& schedule,
                      const size_t timeStep,
                      const UnstructuredGrid& grid);
+
+        /// Construct from input deck and grid, reusing grid data and
+        /// well indices from earlier report steps.
+        WellsManager(const Opm::EclipseState& eclipseState,
+                     const Opm::Schedule& schedule,
+                     const size_t timeStep,
+                     const UnstructuredGrid& grid,
+                     WellGeometryCache& geometry);
         /// Destructor.
         ~WellsManager();
 
@@ -165,30 +187,27 @@ namespace Opm
                   const C2F& cell_to_faces,
                   FC begin_face_centroids,
                   const DynamicListEconLimited& list_econ_limited,
+                  WellGeometryCache& geometry,
                   const std::unordered_set<std::string>& deactivated_wells);
         // Disable copying and assignment.
         WellsManager(const WellsManager& other);
         WellsManager& operator=(const WellsManager& other);
-        static void setupCompressedToCartesian(const int* global_cell, int number_of_cells, std::map<int,int>& cartesian_to_compressed );
         void setupWellControls(std::vector<const Well*>& wells, size_t timeStep,
                                std::vector<std::string>& well_names, const PhaseUsage& phaseUsage,
                                const std::vector<int>& wells_on_proc,
                                const DynamicListEconLimited& list_econ_limited);
 
-        template<class C2F, class FC, class NTG>
+        template<class C2F, class FC>
         void createWellsFromSpecs( std::vector<const Well*>& wells, size_t timeStep,
                                    const C2F& cell_to_faces,
                                    const int* cart_dims,
                                    FC begin_face_centroids,
                                    int dimensions,
-                                   std::vector<double>& dz,
                                    std::vector<std::string>& well_names,
                                    std::vector<WellData>& well_data,
                                    std::map<std::string, int> & well_names_to_index,
                                    const PhaseUsage& phaseUsage,
-                                   const std::map<int,int>& cartesian_to_compressed,
-                                   const double* permeability,
-                                   const NTG& ntg,
+                                   WellGeometryCache& geometry,
                                    std::vector<int>& wells_on_proc,
                                    const std::unordered_set<std::string>& deactivated_wells,
                                    const DynamicListEconLimited& list_econ_limited);
@@ -107,20 +107,17 @@ getCubeDim(const C2F& c2f,
 
 namespace Opm
 {
-template<class C2F, class FC, class NTG>
+template<class C2F, class FC>
 void WellsManager::createWellsFromSpecs(std::vector<const Well*>& wells, size_t timeStep,
                                         const C2F& c2f,
                                         const int* cart_dims,
                                         FC begin_face_centroids,
                                         int dimensions,
-                                        std::vector<double>& dz,
                                         std::vector<std::string>& well_names,
                                         std::vector<WellData>& well_data,
                                         std::map<std::string, int>& well_names_to_index,
                                         const PhaseUsage& phaseUsage,
-                                        const std::map<int,int>& cartesian_to_compressed,
-                                        const double* permeability,
-                                        const NTG& ntg,
+                                        WellGeometryCache& geometry,
                                         std::vector<int>& wells_on_proc,
                                         const std::unordered_set<std::string>& ignored_wells,
                                         const DynamicListEconLimited& list_econ_limited)
@@ -161,9 +158,38 @@ void WellsManager::createWellsFromSpecs(std::vector<const Well*>& wells, size_t
             cells_connection_closed = list_econ_limited.getClosedConnectionsForWell(well->name());
         }
 
-        {   // COMPDAT handling
+        // The open completions, to check whether the perforations
+        // computed at an earlier report step can be reused.
+        std::vector<CompletionKey> completion_keys;
+        for(const auto& completion : well->getCompletions(timeStep)) {
+            if (completion.getState() == WellCompletion::OPEN) {
+                const Value<double>& transmissibilityFactor = completion.getConnectionTransmissibilityFactorAsValueObject();
+                CompletionKey key;
+                key.i = completion.getI();
+                key.j = completion.getJ();
+                key.k = completion.getK();
+                key.direction = static_cast<int>(completion.getDirection());
+                key.sat_table_id = completion.getSatTableId();
+                key.has_trans_factor = transmissibilityFactor.hasValue();
+                key.trans_factor = key.has_trans_factor ? transmissibilityFactor.getValue() : 0.0;
+                key.diameter = completion.getDiameter();
+                key.skin_factor = completion.getSkinFactor();
+                key.well_pi = completion.getWellPi();
+                completion_keys.push_back(key);
+            } else if (completion.getState() != WellCompletion::SHUT) {
+                OPM_THROW(std::runtime_error, "Completion state: " << WellCompletion::StateEnum2String( completion.getState() ) << " not handled");
+            }
+        }
+
+        const std::vector<PerfData>* cached_perfs =
+            geometry.perforations(well->name(), completion_keys, cells_connection_closed);
+        if (cached_perfs) {
+            wellperf_data[active_well_index] = *cached_perfs;
+        } else {   // COMPDAT handling
             // shut completions and open ones stored in this process will have 1 others 0.
 
+            const std::vector<double>& dz = geometry.dz();
+            const std::vector<double>& ntg = geometry.ntg();
             for(const auto& completion : well->getCompletions(timeStep)) {
                 if (completion.getState() == WellCompletion::OPEN) {
                     int i = completion.getI();
@@ -172,15 +198,14 @@ void WellsManager::createWellsFromSpecs(std::vector<const Well*>& wells, size_t
 
                     const int* cpgdim = cart_dims;
                     int cart_grid_indx = i + cpgdim[0]*(j + cpgdim[1]*k);
-                    std::map<int, int>::const_iterator cgit = cartesian_to_compressed.find(cart_grid_indx);
-                    if (cgit == cartesian_to_compressed.end()) {
+                    const int cell = geometry.activeCell(cart_grid_indx);
+                    if (cell < 0) {
                         OPM_MESSAGE("****Warning: Cell with i,j,k indices " << i << ' ' << j << ' '
                                     << k << " not found in grid. The completion will be igored (well = "
                                     << well->name() << ')');
                     }
                     else
                     {
-                        int cell = cgit->second;
                         // check if the connection is closed due to economic limits
                         if (!cells_connection_closed.empty()) {
                             const bool connection_found = std::find(cells_connection_closed.begin(),
@@ -213,7 +238,7 @@ void WellsManager::createWellsFromSpecs(std::vector<const Well*>& wells, size_t
                                     cubical[2] = dz[cell];
                                 }
 
-                                const double* cell_perm = &permeability[dimensions*dimensions*cell];
+                                const double* cell_perm = &geometry.permeability()[dimensions*dimensions*cell];
                                 pd.well_index =
                                     WellsManagerDetail::computeWellIndex(radius, cubical, cell_perm,
                                                                          completion.getSkinFactor(),
@@ -225,12 +250,10 @@ void WellsManager::createWellsFromSpecs(std::vector<const Well*>& wells, size_t
                         }
                         wellperf_data[active_well_index].push_back(pd);
                     }
-                } else {
-                    if (completion.getState() != WellCompletion::SHUT) {
-                        OPM_THROW(std::runtime_error, "Completion state: " << WellCompletion::StateEnum2String( completion.getState() ) << " not handled");
-                    }
                 }
             }
+            geometry.setPerforations(well->name(), completion_keys, cells_connection_closed,
+                                     wellperf_data[active_well_index]);
         }
         {   // WELSPECS handling
             well_names_to_index[well->name()] = active_well_index;
@@ -322,9 +345,32 @@ WellsManager(const Opm::EclipseState& eclipseState,
              const std::unordered_set<std::string>&    deactivated_wells)
     : w_(0), is_parallel_run_(is_parallel_run)
 {
+  WellGeometryCache geometry;
   init(eclipseState, schedule, timeStep, number_of_cells, global_cell,
          cart_dims, dimensions,
-         cell_to_faces, begin_face_centroids, list_econ_limited, deactivated_wells);
+         cell_to_faces, begin_face_centroids, list_econ_limited, geometry, deactivated_wells);
+}
+
+template <class C2F, class FC>
+WellsManager::
+WellsManager(const Opm::EclipseState& eclipseState,
+             const Opm::Schedule& schedule,
+             const size_t                    timeStep,
+             int                             number_of_cells,
+             const int*                      global_cell,
+             const int*                      cart_dims,
+             int                             dimensions,
+             const C2F&                      cell_to_faces,
+             FC                              begin_face_centroids,
+             const DynamicListEconLimited&   list_econ_limited,
+             WellGeometryCache&              geometry,
+             bool                            is_parallel_run,
+             const std::unordered_set<std::string>&    deactivated_wells)
+    : w_(0), is_parallel_run_(is_parallel_run)
+{
+  init(eclipseState, schedule, timeStep, number_of_cells, global_cell,
+         cart_dims, dimensions,
+         cell_to_faces, begin_face_centroids, list_econ_limited, geometry, deactivated_wells);
 }
 
 /// Construct wells from deck.
@@ -340,6 +386,7 @@ WellsManager::init(const Opm::EclipseState& eclipseState,
                    const C2F&                      cell_to_faces,
                    FC                              begin_face_centroids,
                    const DynamicListEconLimited&   list_econ_limited,
+                   WellGeometryCache&              geometry,
                    const std::unordered_set<std::string>&    deactivated_wells)
 {
     if (dimensions != 3) {
@@ -354,9 +401,7 @@ WellsManager::init(const Opm::EclipseState& eclipseState,
         return;
     }
 
-    std::map<int,int> cartesian_to_compressed;
-    setupCompressedToCartesian(global_cell, number_of_cells,
-                               cartesian_to_compressed);
+    geometry.init(eclipseState, number_of_cells, global_cell, cart_dims);
 
     // Obtain phase usage data.
     PhaseUsage pu = phaseUsageFromDeck(eclipseState);
@@ -376,40 +421,12 @@ WellsManager::init(const Opm::EclipseState& eclipseState,
     well_names.reserve(wells.size());
     well_data.reserve(wells.size());
 
-    typedef GridPropertyAccess::ArrayPolicy::ExtractFromDeck<double> DoubleArray;
-    typedef GridPropertyAccess::Compressed<DoubleArray, GridPropertyAccess::Tag::NTG> NTGArray;
-
-    DoubleArray ntg_glob(eclipseState, "NTG", 1.0);
-    NTGArray    ntg(ntg_glob, global_cell);
-
-    const auto& eclGrid = eclipseState.getInputGrid();
-
-    // use cell thickness (dz) from eclGrid
-    // dz overwrites values calculated by WellDetails::getCubeDim
-    std::vector<double> dz(number_of_cells);
-    {
-        std::vector<int> gc = compressedToCartesian(number_of_cells, global_cell);
-        for (int cell = 0; cell < number_of_cells; ++cell) {
-            dz[cell] = eclGrid.getCellThicknes(gc[cell]);
-        }
-    }
-
-
-    std::vector<double> interleavedPerm;
-    RockFromDeck::extractInterleavedPermeability(eclipseState,
-                                                 number_of_cells,
-                                                 global_cell,
-                                                 cart_dims,
-                                                 0.0,
-                                                 interleavedPerm);
-
     createWellsFromSpecs(wells, timeStep, cell_to_faces,
                          cart_dims,
                          begin_face_centroids,
                          dimensions,
-                         dz,
                          well_names, well_data, well_names_to_index,
-                         pu, cartesian_to_compressed, interleavedPerm.data(), ntg,
+                         pu, geometry,
                          wells_on_proc, deactivated_wells, list_econ_limited);
 
     setupWellControls(wells, timeStep, well_names, pu, wells_on_proc, list_econ_limited);
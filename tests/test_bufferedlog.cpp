@@ -0,0 +1,92 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE BufferedLogTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/utility/BufferedLog.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using Opm::BufferedLog;
+
+namespace {
+    int evaluations = 0;
+
+    int countEvaluation()
+    {
+        return ++evaluations;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(verbosityFilter)
+{
+    std::ostringstream sink;
+    BufferedLog::setSink(sink);
+    BufferedLog::setVerbosity(BufferedLog::Summary);
+
+    evaluations = 0;
+    OPM_BUFFERED_LOG(BufferedLog::Summary, "summary " << countEvaluation());
+    OPM_BUFFERED_LOG(BufferedLog::Detailed, "detailed " << countEvaluation());
+    BOOST_CHECK_EQUAL(evaluations, 1);
+
+    // Nothing is written before the buffer is flushed.
+    BOOST_CHECK(sink.str().empty());
+    BufferedLog::flush();
+    BOOST_CHECK_EQUAL(sink.str(), "summary 1\n");
+
+    BufferedLog::setVerbosity(BufferedLog::Silent);
+    OPM_BUFFERED_LOG(BufferedLog::Summary, "silenced " << countEvaluation());
+    BufferedLog::flush();
+    BOOST_CHECK_EQUAL(evaluations, 1);
+    BOOST_CHECK_EQUAL(sink.str(), "summary 1\n");
+
+    BufferedLog::setVerbosity(BufferedLog::Summary);
+    BufferedLog::setSink(std::cout);
+}
+
+BOOST_AUTO_TEST_CASE(threadBuffers)
+{
+    std::ostringstream sink;
+    BufferedLog::setSink(sink);
+    BufferedLog::setVerbosity(BufferedLog::Detailed);
+
+    OPM_BUFFERED_LOG(BufferedLog::Detailed, "main");
+    std::thread worker([]() {
+            OPM_BUFFERED_LOG(BufferedLog::Detailed, "worker");
+            BufferedLog::flush();
+        });
+    worker.join();
+    BOOST_CHECK_EQUAL(sink.str(), "worker\n");
+    BufferedLog::flush();
+    BOOST_CHECK_EQUAL(sink.str(), "worker\nmain\n");
+
+    BufferedLog::setVerbosity(BufferedLog::Summary);
+    BufferedLog::setSink(std::cout);
+}
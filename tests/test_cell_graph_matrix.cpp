@@ -0,0 +1,128 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+#define NVERBOSE // to suppress our messages when throwing
+
+#define BOOST_TEST_MODULE CellGraphMatrixTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/pressure/tpfa/cell_graph_matrix.h>
+#include <opm/core/linalg/sparse_sys.h>
+#include <opm/core/grid/GridManager.hpp>
+#include <opm/core/grid.h>
+#include <opm/core/wells.h>
+#include <memory>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+
+    bool hasEntry(const CSRMatrix& A, int i, int j)
+    {
+        for (int k = A.ia[i]; k < A.ia[i + 1]; ++k) {
+            if (A.ja[k] == j) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // anonymous namespace
+
+
+BOOST_AUTO_TEST_CASE(cellsOnly)
+{
+    GridManager g(4, 3, 2);
+    const UnstructuredGrid& grid = *g.c_grid();
+    const int nc = grid.number_of_cells;
+
+    std::shared_ptr<CSRMatrix> A(cell_graph_matrix_construct(&grid, nullptr),
+                                 csrmatrix_delete);
+    BOOST_REQUIRE(A);
+    BOOST_CHECK_EQUAL(A->m, std::size_t(nc));
+    BOOST_CHECK(csrmatrix_rows_sorted(A.get()));
+
+    int ninterior = 0;
+    for (int f = 0; f < grid.number_of_faces; ++f) {
+        const int c1 = grid.face_cells[2*f + 0];
+        const int c2 = grid.face_cells[2*f + 1];
+        if (c1 >= 0 && c2 >= 0) {
+            BOOST_CHECK(hasEntry(*A, c1, c2));
+            BOOST_CHECK(hasEntry(*A, c2, c1));
+            ++ninterior;
+        }
+    }
+    for (int c = 0; c < nc; ++c) {
+        BOOST_CHECK(hasEntry(*A, c, c));
+    }
+    BOOST_CHECK_EQUAL(A->nnz, std::size_t(nc + 2*ninterior));
+}
+
+
+BOOST_AUTO_TEST_CASE(wellRows)
+{
+    GridManager g(3, 3, 1);
+    const UnstructuredGrid& grid = *g.c_grid();
+    const int nc = grid.number_of_cells;
+
+    std::shared_ptr<Wells> W(create_wells(2, 2, 4), destroy_wells);
+    BOOST_REQUIRE(W);
+
+    const double frac[] = { 1.0, 0.0 };
+    const double WI[]   = { 1.0, 1.0, 1.0 };
+    const int    sat[]  = { -1, -1, -1 };
+
+    // Second well perforates cell 8 twice.
+    const int cells0[] = { 0 };
+    const int cells1[] = { 8, 4, 8 };
+    BOOST_REQUIRE(add_well(INJECTOR, 0.0, 1, frac, cells0, WI, sat,
+                           "INJ", true, W.get()));
+    BOOST_REQUIRE(add_well(PRODUCER, 0.0, 3, frac, cells1, WI, sat,
+                           "PROD", true, W.get()));
+
+    std::shared_ptr<CSRMatrix> A(cell_graph_matrix_construct(&grid, W.get()),
+                                 csrmatrix_delete);
+    BOOST_REQUIRE(A);
+    BOOST_CHECK_EQUAL(A->m, std::size_t(nc + 2));
+    BOOST_CHECK(csrmatrix_rows_sorted(A.get()));
+
+    // Well rows: diagonal plus distinct perforated cells.
+    BOOST_CHECK_EQUAL(A->ia[nc + 1] - A->ia[nc + 0], 2);
+    BOOST_CHECK_EQUAL(A->ia[nc + 2] - A->ia[nc + 1], 3);
+
+    BOOST_CHECK(hasEntry(*A, 0, nc + 0));
+    BOOST_CHECK(hasEntry(*A, nc + 0, 0));
+    BOOST_CHECK(hasEntry(*A, 4, nc + 1));
+    BOOST_CHECK(hasEntry(*A, 8, nc + 1));
+    BOOST_CHECK(hasEntry(*A, nc + 1, 4));
+    BOOST_CHECK(hasEntry(*A, nc + 1, 8));
+    BOOST_CHECK(!hasEntry(*A, 4, nc + 0));
+
+    // Corner cell 8 has two neighbours, the diagonal and one well.
+    BOOST_CHECK_EQUAL(A->ia[9] - A->ia[8], 4);
+}
@@ -0,0 +1,100 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE CfsTpfaKernelsTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/pressure/tpfa/cfs_tpfa_kernels.h>
+
+#include <vector>
+
+namespace {
+
+    // Diagonally dominant, non-symmetric test matrix (column major).
+    std::vector<double> testMatrix(const int np)
+    {
+        std::vector<double> A(np*np);
+        for (int j = 0; j < np; ++j) {
+            for (int i = 0; i < np; ++i) {
+                A[i + np*j] = (i == j) ? 4.0 + i : 0.5*(i + 1) - 0.3*j;
+            }
+        }
+        return A;
+    }
+
+    void checkKernels(const int np)
+    {
+        cfs_tpfa_kernels k;
+        cfs_tpfa_kernels_select(np, &k);
+        BOOST_CHECK_EQUAL(k.np, np);
+
+        const std::vector<double> A = testMatrix(np);
+        const int nrhs = 3;
+        std::vector<double> x(np*nrhs);
+        for (int i = 0; i < np*nrhs; ++i) {
+            x[i] = 1.0 + 0.25*i;
+        }
+
+        // b <- A*x, computed with matmat and, column by column, matvec.
+        std::vector<double> b(np*nrhs);
+        std::vector<double> bcol(np);
+        k.matmat(np, nrhs, &A[0], &x[0], &b[0]);
+        for (int c = 0; c < nrhs; ++c) {
+            k.matvec(np, np, &A[0], &x[np*c], &bcol[0]);
+            for (int i = 0; i < np; ++i) {
+                double expected = 0.0;
+                for (int j = 0; j < np; ++j) {
+                    expected += A[i + np*j]*x[j + np*c];
+                }
+                BOOST_CHECK_CLOSE(bcol[i], expected, 1e-12);
+                BOOST_CHECK_CLOSE(b[i + np*c], expected, 1e-12);
+            }
+        }
+
+        // Solving A*y = b must recover x.
+        std::vector<double> lu(np*np);
+        std::vector<MAT_SIZE_T> ipiv(np);
+        k.factorise(np, &A[0], &lu[0], &ipiv[0]);
+        k.solve(np, nrhs, &lu[0], &ipiv[0], &b[0]);
+        for (int i = 0; i < np*nrhs; ++i) {
+            BOOST_CHECK_CLOSE(b[i], x[i], 1e-10);
+        }
+    }
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(fixedSize)
+{
+    checkKernels(1);
+    checkKernels(2);
+    checkKernels(3);
+}
+
+BOOST_AUTO_TEST_CASE(generic)
+{
+    checkKernels(4);
+}
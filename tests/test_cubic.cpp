@@ -70,4 +70,28 @@ BOOST_AUTO_TEST_CASE (cubic)
     BOOST_REQUIRE_CLOSE (interp.evaluate(4.0), 2., 0.00001);
 }
 
+BOOST_AUTO_TEST_CASE (cubicBatch)
+{
+    const int num_v = 5;
+    double xv[num_v] = {0.0, 1.0, 2.0, 3.0, 5.0};
+    double fv[num_v] = {10.0, 21.0, 2.0, 2.5, -1.0};
+    std::vector<double> x(xv, xv + num_v);
+    std::vector<double> f(fv, fv + num_v);
+    MonotCubicInterpolator interp(x, f);
+
+    // Sorted points, with repeats, points outside the table and
+    // points hitting the data points, followed by unsorted points.
+    const int num_q = 16;
+    double q[num_q] = {-1.0, 0.0, 0.0001, 0.5, 0.5, 1.0, 2.9, 3.0, 4.5, 5.0, 7.0,
+                       4.5, 0.25, 6.0, -2.0, 1.5};
+    double fq[num_q];
+    interp.evaluate(num_q, q, fq);
+    for (int i = 0; i < num_q; ++i) {
+        BOOST_CHECK_EQUAL(fq[i], interp.evaluate(q[i]));
+    }
+    BOOST_CHECK_CLOSE (fq[3], 17.375, 0.00001);
+    BOOST_CHECK_EQUAL (fq[0], 10.0);
+    BOOST_CHECK_EQUAL (fq[10], -1.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
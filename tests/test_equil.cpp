@@ -49,6 +49,10 @@
 #include <string>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define CHECK(value, expected, reltol) \
 { \
   if (std::fabs((expected)) < 1.e-14) \
@@ -115,6 +119,40 @@ static Opm::EquilRecord mkEquilRecord( double datd, double datp,
     return EquilRecord( rec );
 }
 
+namespace
+{
+    struct Exponential
+    {
+        double operator()(const double /* x */, const double y) const { return y; }
+    };
+
+    // y' = 1 for x < 0.5, y' = 2 after: a kink in the solution.
+    struct Kinked
+    {
+        double operator()(const double x, const double /* y */) const { return x < 0.5 ? 1.0 : 2.0; }
+    };
+}
+
+BOOST_AUTO_TEST_CASE (AdaptiveRK4)
+{
+    const std::array<double,2> down = {{ 0.0, 2.0 }};
+    const std::array<double,2> up   = {{ 0.0, -2.0 }};
+    const Opm::Details::RK4IVP<Exponential> edown(Exponential(), down, 1.0, 10, 1.0e-12);
+    const Opm::Details::RK4IVP<Exponential> eup  (Exponential(), up  , 1.0, 10, 1.0e-12);
+    for (int i = 0; i <= 40; ++i) {
+        const double x = 0.05*i;
+        BOOST_CHECK_CLOSE(edown(x), std::exp(x), 1.0e-7);
+        BOOST_CHECK_CLOSE(eup(-x), std::exp(-x), 1.0e-7);
+    }
+
+    const Opm::Details::RK4IVP<Kinked> kinked(Kinked(), {{ 0.0, 1.0 }}, 0.0, 10, 1.0e-12);
+    for (int i = 0; i <= 40; ++i) {
+        const double x = 0.025*i;
+        const double expected = x < 0.5 ? x : 0.5 + 2.0*(x - 0.5);
+        BOOST_CHECK_SMALL(kinked(x) - expected, 1.0e-9);
+    }
+}
+
 BOOST_AUTO_TEST_CASE (PhasePressure)
 {
     typedef std::vector<double> PVal;
@@ -425,6 +463,25 @@ BOOST_AUTO_TEST_CASE (CapillaryInversion)
         }
     }
 
+    // Test the tabulated inversions, shared by all cells.
+    {
+        std::vector<int> cells(grid.number_of_cells);
+        for (int c = 0; c < grid.number_of_cells; ++c) {
+            cells[c] = c;
+        }
+        const Opm::EQUIL::InversePcTables water_tables(props, 0, false, cells);
+        const Opm::EQUIL::InversePcTables gas_tables(props, 2, true, cells);
+        const std::vector<double> pc = { 10.0e5, 0.5e5, 0.45e5, 0.3e5, 0.1e5, 0.0e5, -10.0e5 };
+        for (size_t i = 0; i < pc.size(); ++i) {
+            for (int c = 0; c < grid.number_of_cells; c += 13) {
+                BOOST_CHECK_CLOSE(water_tables.satFromPc(c, pc[i]),
+                                  Opm::EQUIL::satFromPc(props, 0, c, pc[i], false), reltol);
+                BOOST_CHECK_CLOSE(gas_tables.satFromPc(c, pc[i]),
+                                  Opm::EQUIL::satFromPc(props, 2, c, pc[i], true), reltol);
+            }
+        }
+    }
+
     // Test the capillary inversion for gas-water.
     {
         const int water = 0;
@@ -905,4 +962,45 @@ BOOST_AUTO_TEST_CASE (DeckWithSwatinit)
     }
 }
 
+
+BOOST_AUTO_TEST_CASE (ThreadedMatchesSerial)
+{
+    // 400 cells, so that the saturation loop is split between threads.
+    Opm::GridManager gm(1, 1, 400, 1.0, 1.0, 0.25);
+    const UnstructuredGrid& grid = *(gm.c_grid());
+    Opm::Parser parser;
+    Opm::ParseContext parseContext;
+    Opm::Deck deck = parser.parseFile("equil_liveoil_column.DATA" , parseContext);
+    Opm::EclipseState eclipseState(deck , parseContext);
+    Opm::BlackoilPropertiesFromDeck props(deck, eclipseState, grid, false);
+
+#ifdef _OPENMP
+    const int max_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    Opm::EQUIL::DeckDependent::InitialStateComputer serial(props, deck, eclipseState, grid, 9.80665);
+#ifdef _OPENMP
+    omp_set_num_threads(4);
+#endif
+    Opm::EQUIL::DeckDependent::InitialStateComputer threaded(props, deck, eclipseState, grid, 9.80665);
+#ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+#endif
+
+    // Each value is computed by one thread in either case, so the
+    // results must be identical, not only close.
+    for (int phase = 0; phase < 3; ++phase) {
+        BOOST_REQUIRE(threaded.press()[phase].size() == serial.press()[phase].size());
+        BOOST_REQUIRE(threaded.saturation()[phase].size() == serial.saturation()[phase].size());
+        for (int c = 0; c < grid.number_of_cells; ++c) {
+            BOOST_CHECK_EQUAL(threaded.press()[phase][c], serial.press()[phase][c]);
+            BOOST_CHECK_EQUAL(threaded.saturation()[phase][c], serial.saturation()[phase][c]);
+        }
+    }
+    for (int c = 0; c < grid.number_of_cells; ++c) {
+        BOOST_CHECK_EQUAL(threaded.rs()[c], serial.rs()[c]);
+        BOOST_CHECK_EQUAL(threaded.rv()[c], serial.rv()[c]);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+#define NVERBOSE // to suppress our messages when throwing
+
+#define BOOST_TEST_MODULE GridRenumberingTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/utility/GridRenumbering.hpp>
+#include <opm/core/grid/GridManager.hpp>
+#include <opm/core/grid.h>
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+
+    // Largest index difference between neighbouring cells.
+    int bandwidth(const UnstructuredGrid& grid)
+    {
+        int bw = 0;
+        for (int face = 0; face < grid.number_of_faces; ++face) {
+            const int c0 = grid.face_cells[2*face];
+            const int c1 = grid.face_cells[2*face + 1];
+            if (c0 >= 0 && c1 >= 0) {
+                bw = std::max(bw, std::abs(c0 - c1));
+            }
+        }
+        return bw;
+    }
+
+    bool isPermutation(std::vector<int> order)
+    {
+        std::sort(order.begin(), order.end());
+        for (int i = 0; i < int(order.size()); ++i) {
+            if (order[i] != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // anonymous namespace
+
+
+BOOST_AUTO_TEST_CASE(orderings)
+{
+    GridManager g(6, 5, 4);
+    const UnstructuredGrid& grid = *g.c_grid();
+    BOOST_CHECK(isPermutation(reverseCuthillMcKeeOrder(grid)));
+    BOOST_CHECK(isPermutation(hilbertOrder(grid)));
+}
+
+
+BOOST_AUTO_TEST_CASE(renumberedGrid)
+{
+    GridManager g(6, 5, 4);
+    const UnstructuredGrid& grid = *g.c_grid();
+    const int nc = grid.number_of_cells;
+
+    // Scramble the cells, then let RCM recover a narrow band.
+    std::vector<int> scramble(nc);
+    for (int cell = 0; cell < nc; ++cell) {
+        scramble[cell] = (7*cell) % nc;
+    }
+    GridRenumbering scrambled(grid, scramble);
+    const UnstructuredGrid& sgrid = scrambled.grid();
+    BOOST_CHECK_EQUAL(sgrid.global_cell[0], scramble[0]);
+    GridRenumbering rcm(sgrid);
+    const UnstructuredGrid& rgrid = rcm.grid();
+    BOOST_CHECK(bandwidth(rgrid) < bandwidth(sgrid));
+
+    // Faces keep their geometry and orientation.
+    const std::vector<int>& cell_order = rcm.cellOrder();
+    const std::vector<int>& face_order = rcm.faceOrder();
+    for (int face = 0; face < rgrid.number_of_faces; ++face) {
+        const int old = face_order[face];
+        BOOST_CHECK_EQUAL(rgrid.face_areas[face], sgrid.face_areas[old]);
+        BOOST_CHECK_EQUAL(rgrid.face_normals[3*face], sgrid.face_normals[3*old]);
+        for (int side = 0; side < 2; ++side) {
+            const int c = rgrid.face_cells[2*face + side];
+            BOOST_CHECK_EQUAL(c < 0 ? c : cell_order[c], sgrid.face_cells[2*old + side]);
+        }
+    }
+    for (int cell = 0; cell < nc; ++cell) {
+        BOOST_CHECK_EQUAL(rgrid.cell_volumes[cell], sgrid.cell_volumes[cell_order[cell]]);
+        BOOST_CHECK_EQUAL(rgrid.global_cell[cell], sgrid.global_cell[cell_order[cell]]);
+    }
+
+    // Arrays and indices map back and forth.
+    std::vector<double> perm(3*nc);
+    for (int i = 0; i < 3*nc; ++i) {
+        perm[i] = i;
+    }
+    std::vector<double> rperm;
+    rcm.toRenumberedCells(&perm[0], 3, rperm);
+    BOOST_CHECK_EQUAL(rperm[3*1 + 2], perm[3*cell_order[1] + 2]);
+    std::vector<double> back;
+    rcm.toOriginalCells(&rperm[0], 3, back);
+    BOOST_CHECK_EQUAL_COLLECTIONS(back.begin(), back.end(), perm.begin(), perm.end());
+
+    std::vector<int> cells = { cell_order[4], -1 };
+    rcm.renumberCells(cells.size(), &cells[0]);
+    BOOST_CHECK_EQUAL(cells[0], 4);
+    BOOST_CHECK_EQUAL(cells[1], -1);
+
+    std::vector<int> bad(nc, 0);
+    BOOST_CHECK_THROW(GridRenumbering invalid(grid, bad), std::runtime_error);
+}
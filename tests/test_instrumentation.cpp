@@ -0,0 +1,108 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE InstrumentationTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/utility/Instrumentation.hpp>
+
+#include <sstream>
+#include <thread>
+
+using namespace Opm::Instrumentation;
+
+BOOST_AUTO_TEST_CASE(nestedScopes)
+{
+    Registry& reg = Registry::instance();
+    reg.clear();
+    for (int i = 0; i < 3; ++i) {
+        ScopedTimer outer("outer");
+        {
+            ScopedTimer inner("inner");
+            reg.addToCounter("iterations", i + 1);
+        }
+    }
+    reg.addToCounter("toplevel", 1.0);
+
+    const std::vector<Node> nodes = reg.nodes();
+    BOOST_REQUIRE_EQUAL(nodes.size(), 3u);
+    BOOST_CHECK_EQUAL(nodes[0].name, "root");
+    BOOST_REQUIRE_EQUAL(nodes[0].children.size(), 1u);
+    const Node& outer = nodes[nodes[0].children[0]];
+    BOOST_CHECK_EQUAL(outer.name, "outer");
+    BOOST_CHECK_EQUAL(outer.calls, 3);
+    BOOST_REQUIRE_EQUAL(outer.children.size(), 1u);
+    const Node& inner = nodes[outer.children[0]];
+    BOOST_CHECK_EQUAL(inner.name, "inner");
+    BOOST_CHECK_EQUAL(inner.calls, 3);
+    BOOST_CHECK(outer.seconds >= inner.seconds);
+
+    const CounterStats& its = inner.counters.at("iterations");
+    BOOST_CHECK_EQUAL(its.samples, 3);
+    BOOST_CHECK_EQUAL(its.sum, 6.0);
+    BOOST_CHECK_EQUAL(its.min, 1.0);
+    BOOST_CHECK_EQUAL(its.max, 3.0);
+    BOOST_CHECK_EQUAL(nodes[0].counters.at("toplevel").samples, 1);
+}
+
+BOOST_AUTO_TEST_CASE(threadsAggregate)
+{
+    Registry& reg = Registry::instance();
+    reg.clear();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([]() {
+                    for (int i = 0; i < 100; ++i) {
+                        ScopedTimer timer("work");
+                        Registry::instance().addToCounter("items", 1.0);
+                    }
+                }));
+    }
+    for (std::size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    const std::vector<Node> nodes = reg.nodes();
+    BOOST_REQUIRE_EQUAL(nodes.size(), 2u);
+    BOOST_CHECK_EQUAL(nodes[1].calls, 400);
+    BOOST_CHECK_EQUAL(nodes[1].counters.at("items").sum, 400.0);
+}
+
+BOOST_AUTO_TEST_CASE(output)
+{
+    Registry& reg = Registry::instance();
+    reg.clear();
+    {
+        ScopedTimer timer("solve");
+    }
+    std::ostringstream json;
+    reg.writeJson(json);
+    BOOST_CHECK(json.str().find("\"name\": \"solve\"") != std::string::npos);
+    std::ostringstream trace;
+    reg.writeChromeTrace(trace);
+    BOOST_CHECK(trace.str().find("\"traceEvents\"") != std::string::npos);
+    BOOST_CHECK(trace.str().find("\"name\": \"solve\"") != std::string::npos);
+}
@@ -28,6 +28,9 @@
 #include <boost/test/unit_test.hpp>
 
 #include <opm/core/linalg/LinearSolverFactory.hpp>
+#if HAVE_PETSC
+#include <opm/core/linalg/LinearSolverPetsc.hpp>
+#endif
 #include <opm/core/utility/parameters/ParameterGroup.hpp>
 
 #include <dune/common/version.hh>
@@ -124,6 +127,64 @@ void run_test(const Opm::ParameterGroup& param)
 }
 
 
+// Solve the Laplacian and compare with the exact solution.
+void run_exact_test(const Opm::ParameterGroup& param)
+{
+    const int N = 10;
+    auto mat = createLaplacian(N);
+    std::vector<double> x, b;
+    createRandomVectors(N*N, x, b, *mat);
+    const std::vector<double> exact(x);
+    std::fill(x.begin(), x.end(), 0.0);
+    Opm::LinearSolverFactory ls(param);
+    const Opm::LinearSolverInterface::LinearSolverReport rep =
+        ls.solve(N*N, mat->data.size(), &(mat->rowStart[0]),
+                 &(mat->colIndex[0]), &(mat->data[0]), &(b[0]),
+                 &(x[0]));
+    BOOST_CHECK(rep.converged);
+    for (int i = 0; i < N*N; ++i) {
+        BOOST_CHECK_SMALL(x[i] - exact[i], 1e-8);
+    }
+}
+
+
+// Solve the Kronecker product of the Laplacian with an SPD 2x2 block.
+void run_block_test(const Opm::ParameterGroup& param)
+{
+    const int N = 4;
+    const int bs = 2;
+    const double K[bs*bs] = { 2.0, 0.5, 0.5, 1.0 };
+    auto mat = createLaplacian(N);
+    std::vector<double> sa;
+    for (double a : mat->data) {
+        for (int k = 0; k < bs*bs; ++k) {
+            sa.push_back(a*K[k]);
+        }
+    }
+    std::vector<double> exact(N*N*bs);
+    for (int i = 0; i < N*N*bs; ++i) {
+        exact[i] = ((double) (rand()%100))/10.0;
+    }
+    std::vector<double> b(N*N*bs, 0.0);
+    for (int row = 0; row < N*N; ++row) {
+        for (int i = mat->rowStart[row]; i < mat->rowStart[row + 1]; ++i) {
+            for (int r = 0; r < bs; ++r) {
+                for (int c = 0; c < bs; ++c) {
+                    b[bs*row + r] += sa[bs*bs*i + bs*r + c]*exact[bs*mat->colIndex[i] + c];
+                }
+            }
+        }
+    }
+    std::vector<double> x(N*N*bs, 0.0);
+    Opm::LinearSolverFactory ls(param);
+    ls.solveBlock(bs, N*N, mat->data.size(), &(mat->rowStart[0]),
+                  &(mat->colIndex[0]), &(sa[0]), &(b[0]), &(x[0]));
+    for (int i = 0; i < N*N*bs; ++i) {
+        BOOST_CHECK_SMALL(x[i] - exact[i], 1e-5);
+    }
+}
+
+
 BOOST_AUTO_TEST_CASE(DefaultTest)
 {
     Opm::ParameterGroup param;
@@ -132,6 +193,14 @@ BOOST_AUTO_TEST_CASE(DefaultTest)
     run_test(param);
 }
 
+BOOST_AUTO_TEST_CASE(DefaultBlockTest)
+{
+    Opm::ParameterGroup param;
+    param.insertParameter(std::string("linsolver_max_iterations"), std::string("200"));
+    param.insertParameter(std::string("linsolver_residual_tolerance"), std::string("1e-10"));
+    run_block_test(param);
+}
+
 #ifdef HAVE_DUNE_ISTL
 BOOST_AUTO_TEST_CASE(CGAMGTest)
 {
@@ -143,6 +212,50 @@ BOOST_AUTO_TEST_CASE(CGAMGTest)
     run_test(param);
 }
 
+BOOST_AUTO_TEST_CASE(CGAMGSinglePrecisionTest)
+{
+    Opm::ParameterGroup param;
+    param.insertParameter(std::string("linsolver"), std::string("istl"));
+    param.insertParameter(std::string("linsolver_type"), std::string("1"));
+    param.insertParameter(std::string("linsolver_amg_single_precision"), std::string("true"));
+    param.insertParameter(std::string("linsolver_max_iterations"), std::string("200"));
+    run_test(param);
+}
+
+BOOST_AUTO_TEST_CASE(CGAMGSinglePrecisionFallbackTest)
+{
+    // One single precision iteration cannot reach the tolerance, so
+    // the double precision fallback must solve the original system.
+    Opm::ParameterGroup param;
+    param.insertParameter(std::string("linsolver"), std::string("istl"));
+    param.insertParameter(std::string("linsolver_type"), std::string("1"));
+    param.insertParameter(std::string("linsolver_amg_single_precision"), std::string("true"));
+    param.insertParameter(std::string("linsolver_amg_single_precision_max_iterations"), std::string("1"));
+    param.insertParameter(std::string("linsolver_max_iterations"), std::string("200"));
+    param.insertParameter(std::string("linsolver_residual_tolerance"), std::string("1e-12"));
+    run_exact_test(param);
+}
+
+BOOST_AUTO_TEST_CASE(CGAMGBlockTest)
+{
+    Opm::ParameterGroup param;
+    param.insertParameter(std::string("linsolver"), std::string("istl"));
+    param.insertParameter(std::string("linsolver_type"), std::string("1"));
+    param.insertParameter(std::string("linsolver_max_iterations"), std::string("200"));
+    param.insertParameter(std::string("linsolver_residual_tolerance"), std::string("1e-10"));
+    run_block_test(param);
+}
+
+BOOST_AUTO_TEST_CASE(BiCGILUBlockTest)
+{
+    Opm::ParameterGroup param;
+    param.insertParameter(std::string("linsolver"), std::string("istl"));
+    param.insertParameter(std::string("linsolver_type"), std::string("2"));
+    param.insertParameter(std::string("linsolver_max_iterations"), std::string("200"));
+    param.insertParameter(std::string("linsolver_residual_tolerance"), std::string("1e-10"));
+    run_block_test(param);
+}
+
 BOOST_AUTO_TEST_CASE(CGILUTest)
 {
     Opm::ParameterGroup param;
@@ -194,4 +307,51 @@ BOOST_AUTO_TEST_CASE(PETScTest)
     param.insertParameter(std::string("ksp_view"), std::string("0"));
     run_test(param);
 }
+
+// Solve two systems with the same pattern and solution, but scaled
+// values, and count how often the PETSc objects were set up.
+void run_petsc_reuse_test(const bool reuse_pc, const int expected_pc_setups)
+{
+    Opm::ParameterGroup param;
+    param.insertParameter(std::string("linsolver"), std::string("petsc"));
+    param.insertParameter(std::string("ksp_type"), std::string("cg"));
+    param.insertParameter(std::string("pc_type"), std::string("jacobi"));
+    param.insertParameter(std::string("ksp_rtol"), std::string("1e-10"));
+    param.insertParameter(std::string("ksp_reuse_pc"), std::string(reuse_pc ? "true" : "false"));
+    param.insertParameter(std::string("ksp_initial_guess_nonzero"), std::string("true"));
+    const int N = 4;
+    auto mat = createLaplacian(N);
+    std::vector<double> exact, b;
+    createRandomVectors(N*N, exact, b, *mat);
+    Opm::LinearSolverPetsc ls(param);
+    for (int solve = 0; solve < 2; ++solve) {
+        std::vector<double> x(N*N, 0.0);
+        ls.solve(N*N, mat->data.size(), &(mat->rowStart[0]),
+                 &(mat->colIndex[0]), &(mat->data[0]), &(b[0]),
+                 &(x[0]));
+        for (int i = 0; i < N*N; ++i) {
+            BOOST_CHECK_SMALL(x[i] - exact[i], 1e-6);
+        }
+        // Same pattern and solution, new values.
+        for (double& a : mat->data) {
+            a *= 2.0;
+        }
+        for (double& r : b) {
+            r *= 2.0;
+        }
+    }
+    // The KSP is kept for the second solve in either case.
+    BOOST_CHECK_EQUAL(ls.kspCreateCount(), 1);
+    BOOST_CHECK_EQUAL(ls.preconditionerSetupCount(), expected_pc_setups);
+}
+
+BOOST_AUTO_TEST_CASE(PETScReuseTest)
+{
+    run_petsc_reuse_test(true, 1);
+}
+
+BOOST_AUTO_TEST_CASE(PETScRebuildTest)
+{
+    run_petsc_reuse_test(false, 2);
+}
 #endif
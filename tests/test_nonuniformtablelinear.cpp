@@ -89,3 +89,34 @@ BOOST_AUTO_TEST_CASE(table_operations)
     BOOST_CHECK_EQUAL(t1(0.0), 3.0);
     BOOST_CHECK(std::fabs(t1.derivative(0.0)  + 1.0/20.0) < 1e-11);
 }
+
+BOOST_AUTO_TEST_CASE(batch_evaluation)
+{
+    double xva[] = { -1.0, 2.0, 2.2, 3.0, 5.0, 5.5, 8.0 };
+    const int numvals = sizeof(xva)/sizeof(xva[0]);
+    std::vector<double> xv(xva, xva + numvals);
+    double yva[numvals] = { 1.0, 2.0, 3.0, 4.0, 2.0, 2.5, 0.0 };
+    std::vector<double> yv(yva, yva + numvals);
+    Opm::NonuniformTableLinear<double> t1(xv, yv);
+
+    // Increasing, repeated, decreasing, far jumping and out of range
+    // points, including the table nodes.
+    double xq[] = { -3.0, -1.0, 0.0, 2.0, 2.1, 2.1, 5.5, 7.0, 9.0,
+                    2.2, 1.0, -2.0, 8.0, 3.0, 2.9, 5.0, 4.0, 0.5 };
+    const int numq = sizeof(xq)/sizeof(xq[0]);
+    std::vector<double> f(numq);
+    std::vector<double> dfdx(numq);
+    t1.evaluate(numq, xq, f.data(), dfdx.data());
+    for (int i = 0; i < numq; ++i) {
+        BOOST_CHECK_EQUAL(f[i], t1(xq[i]));
+        BOOST_CHECK_EQUAL(dfdx[i], t1.derivative(xq[i]));
+    }
+
+    // Decreasing tables are searched like increasing ones.
+    std::vector<double> xr(xv.rbegin(), xv.rend());
+    std::vector<double> yr(yv.rbegin(), yv.rend());
+    Opm::linearInterpolation(xr, yr, numq, xq, f.data(), 0);
+    for (int i = 0; i < numq; ++i) {
+        BOOST_CHECK_EQUAL(f[i], Opm::linearInterpolation(xr, yr, xq[i]));
+    }
+}
@@ -0,0 +1,111 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define NVERBOSE  // Suppress own messages when throw()ing
+
+#define BOOST_TEST_MODULE RootFindersTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/utility/RootFinders.hpp>
+
+#include <cmath>
+
+namespace {
+
+    // f(x) = x^3 - 0.25, zero at x = 0.25^(1/3).
+    struct Cubic
+    {
+        double operator()(const double x) const
+        {
+            return x*x*x - 0.25;
+        }
+        double operator()(const double x, double& dfdx) const
+        {
+            dfdx = 3.0*x*x;
+            return x*x*x - 0.25;
+        }
+    };
+
+    // A fractional flow type residual, r(s) = s - s0 + c*f(s),
+    // with f(s) = s^2/(s^2 + (1 - s)^2).
+    struct FracFlowResidual
+    {
+        double s0;
+        double c;
+        double operator()(const double s) const
+        {
+            double dummy;
+            return operator()(s, dummy);
+        }
+        double operator()(const double s, double& drds) const
+        {
+            const double d = s*s + (1.0 - s)*(1.0 - s);
+            const double f = s*s/d;
+            const double dfds = (2.0*s*d - s*s*(4.0*s - 2.0))/(d*d);
+            drds = 1.0 + c*dfds;
+            return s - s0 + c*f;
+        }
+    };
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(newtonCubic)
+{
+    const double tol = 1e-12;
+    const double exact = std::pow(0.25, 1.0/3.0);
+    int iters = 0;
+    const double x = Opm::NewtonBisection<>::solve(Cubic(), 0.5, 0.0, 1.0, 50, tol, iters);
+    BOOST_CHECK_CLOSE(x, exact, 1e-8);
+
+    // A poor initial guess with a vanishing derivative must fall
+    // back to bisection and still converge.
+    const double x0 = Opm::NewtonBisection<>::solve(Cubic(), 0.0, 0.0, 1.0, 100, tol, iters);
+    BOOST_CHECK_CLOSE(x0, exact, 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(newtonMatchesRegulaFalsi)
+{
+    const double tol = 1e-12;
+    for (int i = 0; i <= 10; ++i) {
+        FracFlowResidual res = { 0.1*i, 5.0 };
+        int iters_rf = 0;
+        int iters_nb = 0;
+        const double s_rf = Opm::RegulaFalsi<>::solve(res, 0.5, 0.0, 1.0, 100, tol, iters_rf);
+        const double s_nb = Opm::NewtonBisection<>::solve(res, 0.5, 0.0, 1.0, 100, tol, iters_nb);
+        BOOST_CHECK_SMALL(s_rf - s_nb, 1e-8);
+        BOOST_CHECK_SMALL(res(s_nb), 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(newtonNotBracketed)
+{
+    // No zero in [0.8, 1]; Newton steps leave the interval, and the
+    // bracketing failure must be reported.
+    int iters = 0;
+    BOOST_CHECK_THROW(Opm::NewtonBisection<>::solve(Cubic(), 0.9, 0.8, 1.0, 50, 1e-12, iters),
+                      std::runtime_error);
+    const double x = Opm::NewtonBisection<Opm::ContinueOnError>::solve(Cubic(), 0.9, 0.8, 1.0, 50, 1e-12, iters);
+    BOOST_CHECK_EQUAL(x, 0.8);
+}
@@ -0,0 +1,128 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+#define NVERBOSE // to suppress our messages when throwing
+
+#define BOOST_TEST_MODULE SequentialSplittingTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/simulator/SequentialSplittingStepper.hpp>
+#include <opm/core/simulator/TwophaseState.hpp>
+#include <opm/core/simulator/WellState.hpp>
+#include <opm/core/pressure/IncompTpfa.hpp>
+#include <opm/core/transport/reorder/TransportSolverTwophaseReorder.hpp>
+#include <opm/core/props/IncompPropertiesBasic.hpp>
+#include <opm/core/linalg/LinearSolverUmfpack.hpp>
+#include <opm/core/utility/miscUtilities.hpp>
+#include <opm/core/grid/GridManager.hpp>
+#include <opm/core/grid.h>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+
+    void initState(const UnstructuredGrid& grid, TwophaseState& state)
+    {
+        for (int c = 0; c < grid.number_of_cells; ++c) {
+            state.saturation()[2*c + 0] = 0.0;
+            state.saturation()[2*c + 1] = 1.0;
+        }
+    }
+
+    void checkEqual(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        BOOST_REQUIRE_EQUAL(a.size(), b.size());
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            BOOST_CHECK_EQUAL(a[i], b[i]);
+        }
+    }
+
+} // anonymous namespace
+
+
+BOOST_AUTO_TEST_CASE(stepperMatchesSplittingLoop)
+{
+    const int n = 8;
+    GridManager g(n, n, 1);
+    const UnstructuredGrid& grid = *g.c_grid();
+    const int nc = grid.number_of_cells;
+    const std::vector<double> rho = { 1000.0, 800.0 };
+    const std::vector<double> mu  = { 1.0e-3, 5.0e-3 };
+    IncompPropertiesBasic props(2, SaturationPropsBasic::Quadratic, rho, mu,
+                                0.2, 1.0e-13, 3, nc);
+
+    // Inject water in one corner and produce from the opposite one.
+    std::vector<double> src(nc, 0.0);
+    src[0] = 1.0e-2;
+    src[nc - 1] = -1.0e-2;
+    const double inflow_frac = 1.0;
+    const double dt = 2.0;
+    const int num_steps = 3;
+
+    LinearSolverUmfpack linsolver;
+
+    // The explicit splitting loop.
+    TwophaseState state(nc, grid.number_of_faces);
+    initState(grid, state);
+    WellState well_state;
+    well_state.init(0, state);
+    {
+        IncompTpfa psolver(grid, props, linsolver, 0, 0, src, 0);
+        TransportSolverTwophaseReorder tsolver(grid, props, 0, 1e-9, 30);
+        std::vector<double> porevol;
+        computePorevolume(grid, props.porosity(), porevol);
+        std::vector<double> transport_src;
+        for (int step = 0; step < num_steps; ++step) {
+            psolver.solve(dt, state, well_state);
+            computeTransportSource(grid, src, state.faceflux(), inflow_frac,
+                                   0, well_state.perfRates(), transport_src);
+            tsolver.solve(&porevol[0], &transport_src[0], dt, state);
+        }
+    }
+
+    // The same steps through the stepper.
+    TwophaseState stepper_state(nc, grid.number_of_faces);
+    initState(grid, stepper_state);
+    WellState stepper_well_state;
+    stepper_well_state.init(0, stepper_state);
+    {
+        IncompTpfa psolver(grid, props, linsolver, 0, 0, src, 0);
+        TransportSolverTwophaseReorder tsolver(grid, props, 0, 1e-9, 30);
+        SequentialSplittingStepper stepper(grid, props, psolver, tsolver,
+                                           0, src, inflow_frac);
+        for (int step = 0; step < num_steps; ++step) {
+            stepper.step(dt, stepper_state, stepper_well_state);
+        }
+    }
+
+    checkEqual(stepper_state.pressure(), state.pressure());
+    checkEqual(stepper_state.faceflux(), state.faceflux());
+    checkEqual(stepper_state.saturation(), state.saturation());
+
+    // Water must have entered the model, or the comparison is void.
+    BOOST_CHECK(state.saturation()[0] > 0.0);
+}
@@ -0,0 +1,130 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+#define NVERBOSE // to suppress our messages when throwing
+
+#define BOOST_TEST_MODULE StreamlineTracerTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/flowdiagnostics/StreamlineTracer.hpp>
+#include <opm/core/utility/VelocityInterpolation.hpp>
+#include <opm/core/grid/GridManager.hpp>
+#include <opm/core/grid.h>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+
+    // Flux of the unit velocity in the x direction.
+    std::vector<double> unitXFlux(const UnstructuredGrid& grid)
+    {
+        const int dim = grid.dimensions;
+        std::vector<double> flux(grid.number_of_faces);
+        for (int face = 0; face < grid.number_of_faces; ++face) {
+            flux[face] = grid.face_normals[dim*face];
+        }
+        return flux;
+    }
+
+} // anonymous namespace
+
+
+BOOST_AUTO_TEST_CASE(traceRow)
+{
+    // A row of four unit cells with porosity 0.5.
+    GridManager g(4, 1, 1);
+    const UnstructuredGrid& grid = *g.c_grid();
+    const std::vector<double> flux = unitXFlux(grid);
+    VelocityInterpolationConstant vic(grid);
+    vic.setupFluxes(&flux[0]);
+    const std::vector<double> porevolume(grid.number_of_cells, 0.5);
+    StreamlineTracer tracer(grid, vic, &porevolume[0]);
+
+    Streamline sl;
+    const double x0[3] = { 0.5, 0.5, 0.5 };
+    tracer.traceOne(0, x0, StreamlineTracer::Forward, sl);
+    BOOST_CHECK(sl.termination == Streamline::ReachedBoundary);
+    BOOST_REQUIRE_EQUAL(sl.cells.size(), 4);
+    for (int i = 0; i < 4; ++i) {
+        BOOST_CHECK_EQUAL(sl.cells[i], i);
+        BOOST_CHECK_CLOSE(sl.exit_tof[i], 0.25 + 0.5*i, 1e-8);
+    }
+
+    const double x2[3] = { 2.5, 0.5, 0.5 };
+    tracer.traceOne(2, x2, StreamlineTracer::Backward, sl);
+    BOOST_CHECK(sl.termination == Streamline::ReachedBoundary);
+    BOOST_REQUIRE_EQUAL(sl.cells.size(), 3);
+    for (int i = 0; i < 3; ++i) {
+        BOOST_CHECK_EQUAL(sl.cells[i], 2 - i);
+        BOOST_CHECK_CLOSE(sl.exit_tof[i], 0.25 + 0.5*i, 1e-8);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(traceChunksAndAverage)
+{
+    GridManager g(4, 1, 1);
+    const UnstructuredGrid& grid = *g.c_grid();
+    const std::vector<double> flux = unitXFlux(grid);
+    VelocityInterpolationECVI vic(grid);
+    vic.setupFluxes(&flux[0]);
+    const std::vector<double> porevolume(grid.number_of_cells, 0.5);
+    StreamlineTracer tracer(grid, vic, &porevolume[0]);
+
+    // One seed per cell, halfway to the outflow face.
+    std::vector<int> seed_cells;
+    std::vector<double> seed_points;
+    const std::vector<int> cells = { 0, 1, 2 };
+    StreamlineTracer::seedsFromCells(grid, &flux[0], cells, StreamlineTracer::Forward,
+                                     seed_cells, seed_points);
+    BOOST_REQUIRE_EQUAL(seed_cells.size(), 3);
+    BOOST_CHECK_CLOSE(seed_points[0], 0.75, 1e-12);
+
+    // Chunks smaller than the number of seeds must still deliver
+    // the streamlines in seed order.
+    std::vector<int> seeds;
+    StreamlineCellAverages averages(grid.number_of_cells, 3);
+    tracer.trace(seed_cells.size(), &seed_cells[0], &seed_points[0], StreamlineTracer::Forward,
+                 [&](const Streamline& sl) {
+                     seeds.push_back(sl.seed);
+                     averages.add(sl, 1.0, sl.seed);
+                 }, 2);
+    const std::vector<int> expected_seeds = { 0, 1, 2 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(seeds.begin(), seeds.end(), expected_seeds.begin(), expected_seeds.end());
+
+    // Cell 0 is only visited by the first streamline, in x in [0.75, 1].
+    std::vector<double> tof;
+    averages.tof(tof);
+    BOOST_CHECK_CLOSE(tof[0], 0.0625, 1e-8);
+    std::vector<double> tracers;
+    averages.tracer(tracers);
+    BOOST_CHECK_CLOSE(tracers[0], 1.0, 1e-8);
+    BOOST_CHECK_SMALL(tracers[1], 1e-12);
+    // All three streamlines pass through the whole of cell 3.
+    for (int t = 0; t < 3; ++t) {
+        BOOST_CHECK_CLOSE(tracers[3*3 + t], 1.0/3.0, 1e-8);
+    }
+}
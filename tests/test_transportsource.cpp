@@ -0,0 +1,108 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+#define NVERBOSE // to suppress our messages when throwing
+
+#define BOOST_TEST_MODULE TransportSourceTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/utility/miscUtilities.hpp>
+#include <opm/core/grid/GridManager.hpp>
+#include <opm/core/grid.h>
+#include <opm/core/wells.h>
+#include <memory>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+
+    // Fluxes on all faces, with boundary faces either given the
+    // same treatment as interior ones or set to zero (no-flow).
+    std::vector<double> faceFluxes(const UnstructuredGrid& grid, const bool bdy_flow)
+    {
+        std::vector<double> flux(grid.number_of_faces);
+        for (int f = 0; f < grid.number_of_faces; ++f) {
+            const bool bdy = grid.face_cells[2*f] < 0 || grid.face_cells[2*f + 1] < 0;
+            flux[f] = (bdy && !bdy_flow) ? 0.0 : double((7*f) % 11) - 5.0;
+        }
+        return flux;
+    }
+
+    std::shared_ptr<Wells> twoWells(const UnstructuredGrid& grid)
+    {
+        std::shared_ptr<Wells> W(create_wells(2, 2, 3), destroy_wells);
+        const int inj_cells[] = { 0, 1 };
+        const int prod_cells[] = { grid.number_of_cells - 1 };
+        const double WI[] = { 1.0, 1.0 };
+        const int sat_table_id[] = { -1, -1 };
+        const double ifrac[] = { 0.7, 0.3 };
+        const double pfrac[] = { 0.0, 0.0 };
+        add_well(INJECTOR, 0.0, 2, ifrac, inj_cells, WI, sat_table_id, "INJ", true, W.get());
+        add_well(PRODUCER, 0.0, 1, pfrac, prod_cells, WI, sat_table_id, "PROD", true, W.get());
+        return W;
+    }
+
+    void checkBuilderMatches(const UnstructuredGrid& grid,
+                             const TransportSourceBuilder& builder,
+                             const bool bdy_flow,
+                             const Wells* wells)
+    {
+        std::vector<double> src(grid.number_of_cells);
+        for (int c = 0; c < grid.number_of_cells; ++c) {
+            src[c] = double(c % 3) - 1.0;
+        }
+        const std::vector<double> flux = faceFluxes(grid, bdy_flow);
+        const double perfrates[] = { 2.0, 0.5, -1.5 };
+        const std::vector<double> well_perfrates(perfrates, perfrates + 3);
+        const double inflow_frac = 0.8;
+
+        std::vector<double> expected;
+        computeTransportSource(grid, src, flux, inflow_frac, wells, well_perfrates, expected);
+        std::vector<double> computed;
+        builder.compute(src, flux, inflow_frac, wells, well_perfrates, computed);
+
+        BOOST_REQUIRE_EQUAL(computed.size(), expected.size());
+        for (int c = 0; c < grid.number_of_cells; ++c) {
+            BOOST_CHECK_EQUAL(computed[c], expected[c]);
+        }
+    }
+
+} // anonymous namespace
+
+
+BOOST_AUTO_TEST_CASE(builderMatchesFreeFunction)
+{
+    GridManager g(4, 3, 2);
+    const UnstructuredGrid& grid = *g.c_grid();
+    std::shared_ptr<Wells> wells = twoWells(grid);
+    // One builder serves all computations on the grid.
+    const TransportSourceBuilder builder(grid);
+    checkBuilderMatches(grid, builder, false, 0);
+    checkBuilderMatches(grid, builder, true, 0);
+    checkBuilderMatches(grid, builder, false, wells.get());
+    checkBuilderMatches(grid, builder, true, wells.get());
+}
@@ -0,0 +1,115 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+#define NVERBOSE // to suppress our messages when throwing
+
+#define BOOST_TEST_MODULE UMFPACKSolverTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/linalg/call_umfpack.h>
+#include <opm/core/linalg/sparse_sys.h>
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+    typedef std::unique_ptr<CSRMatrix, void (*)(CSRMatrix*)> MatrixPtr;
+    typedef std::unique_ptr<UMFPACKSolver, void (*)(UMFPACKSolver*)> SolverPtr;
+
+    // Nonsymmetric five-point operator on an nx-by-ny grid. If
+    // skip > 0, each row also couples to the row skip places ahead.
+    MatrixPtr fivePoint(const int nx, const int ny, const double shift, const int skip)
+    {
+        const int n = nx*ny;
+        MatrixPtr A(csrmatrix_new_known_nnz(n, 6*n), csrmatrix_delete);
+        BOOST_REQUIRE(A);
+        int k = 0;
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < nx; ++i) {
+                const int row = i + nx*j;
+                A->ia[row] = k;
+                const int cols[] = { row - nx, row - 1, row, row + 1, row + nx };
+                const bool present[] = { j > 0, i > 0, true, i < nx - 1, j < ny - 1 };
+                const double vals[] = { -1.0, -1.5, 4.0 + shift, -0.5, -1.0 };
+                for (int c = 0; c < 5; ++c) {
+                    if (present[c]) {
+                        A->ja[k] = cols[c];
+                        A->sa[k] = vals[c];
+                        ++k;
+                    }
+                }
+                if (skip > 0 && row + skip < n) {
+                    A->ja[k] = row + skip;
+                    A->sa[k] = 0.25;
+                    ++k;
+                }
+            }
+        }
+        A->ia[n] = k;
+        A->nnz = k;
+        return A;
+    }
+
+    void checkAgainstReference(UMFPACKSolver* solver, CSRMatrix* A)
+    {
+        const int n = A->m;
+        std::vector<double> b(n);
+        for (int i = 0; i < n; ++i) {
+            b[i] = 1.0 + 0.1*i;
+        }
+        std::vector<double> x(n, 0.0);
+        std::vector<double> x_ref(n, 0.0);
+        BOOST_REQUIRE(umfpack_solver_solve(solver, A, &b[0], &x[0]));
+        call_UMFPACK(A, &b[0], &x_ref[0]);
+        for (int i = 0; i < n; ++i) {
+            BOOST_CHECK_CLOSE(x[i], x_ref[i], 1e-10);
+        }
+    }
+
+} // anonymous namespace
+
+
+BOOST_AUTO_TEST_CASE(reuseAndPatternChange)
+{
+    SolverPtr solver(umfpack_solver_new(), umfpack_solver_delete);
+    BOOST_REQUIRE(solver);
+
+    // Same pattern twice, with different values.
+    MatrixPtr A1 = fivePoint(6, 5, 0.0, 0);
+    checkAgainstReference(solver.get(), A1.get());
+    MatrixPtr A2 = fivePoint(6, 5, 1.0, 0);
+    BOOST_CHECK_EQUAL(A1->nnz, A2->nnz);
+    checkAgainstReference(solver.get(), A2.get());
+
+    // Changed pattern, same size.
+    MatrixPtr B = fivePoint(6, 5, 0.5, 8);
+    BOOST_CHECK(B->nnz > A1->nnz);
+    checkAgainstReference(solver.get(), B.get());
+
+    // And back to the first pattern.
+    checkAgainstReference(solver.get(), A1.get());
+}
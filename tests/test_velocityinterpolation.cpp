@@ -465,12 +465,102 @@ void testLinearVelReproIrregPrism()
 }
 
 
+// Interpolation class that only implements the single-point
+// interpolate(), relying on the default batched interpolate().
+template <class VelInterp>
+class SinglePointOnly : public VelocityInterpolationInterface
+{
+public:
+    explicit SinglePointOnly(const UnstructuredGrid& grid)
+        : vic_(grid)
+    {
+    }
+    using VelocityInterpolationInterface::interpolate;
+    virtual void setupFluxes(const double* flux)
+    {
+        vic_.setupFluxes(flux);
+    }
+    virtual void interpolate(const int cell,
+                             const double* x,
+                             double* v) const
+    {
+        vic_.interpolate(cell, x, v);
+    }
+private:
+    VelInterp vic_;
+};
+
+
+template <class VelInterp>
+void testBatchInterpolation3d()
+{
+    // Set up 3d 2x2x2 cartesian case.
+    GridManager g(2, 2, 2);
+    const UnstructuredGrid& grid = *g.c_grid();
+    std::vector<double> v0(3);
+    v0[0] = 0.12345;
+    v0[1] = -0.6789;
+    v0[2] = 0.4242;
+    std::vector<double> v1(3);
+    v1[0] = -0.1;
+    v1[1] = 0.2;
+    v1[2] = 0.3;
+
+    // A few points in each cell.
+    const int npoints = 4;
+    std::vector<double> x(3*npoints*grid.number_of_cells);
+    for (int cell = 0; cell < grid.number_of_cells; ++cell) {
+        for (int p = 0; p < npoints; ++p) {
+            for (int dd = 0; dd < 3; ++dd) {
+                x[3*(npoints*cell + p) + dd] = grid.cell_centroids[3*cell + dd] + 0.1*(p - 1.5)*(dd + 1);
+            }
+        }
+    }
+
+    // A constant velocity must be reproduced at all points.
+    std::vector<double> flux;
+    computeFlux(grid, v0, flux);
+    VelInterp vic(grid);
+    vic.setupFluxes(&flux[0]);
+    for (int cell = 0; cell < grid.number_of_cells; ++cell) {
+        std::vector<double> v_batch(3*npoints);
+        vic.interpolate(cell, npoints, 3, &x[3*npoints*cell], &v_batch[0]);
+        for (int p = 0; p < npoints; ++p) {
+            std::vector<double> v_p(v_batch.begin() + 3*p, v_batch.begin() + 3*(p + 1));
+            BOOST_CHECK(vectorDiff2(v0, v_p) < 1e-12);
+        }
+    }
+
+    // For a nonconstant flux field, the batched interpolation must
+    // match interpolating one point at a time, and the default
+    // batched interpolation of the base class.
+    computeFluxLinear(grid, v0, v1, flux);
+    vic.setupFluxes(&flux[0]);
+    SinglePointOnly<VelInterp> single(grid);
+    single.setupFluxes(&flux[0]);
+    for (int cell = 0; cell < grid.number_of_cells; ++cell) {
+        std::vector<double> v_batch(3*npoints);
+        std::vector<double> v_default(3*npoints);
+        vic.interpolate(cell, npoints, 3, &x[3*npoints*cell], &v_batch[0]);
+        single.interpolate(cell, npoints, 3, &x[3*npoints*cell], &v_default[0]);
+        BOOST_CHECK(vectorDiff2(v_batch, v_default) < 1e-24);
+        for (int p = 0; p < npoints; ++p) {
+            std::vector<double> v_single(3);
+            vic.interpolate(cell, &x[3*(npoints*cell + p)], &v_single[0]);
+            std::vector<double> v_p(v_batch.begin() + 3*p, v_batch.begin() + 3*(p + 1));
+            BOOST_CHECK(vectorDiff2(v_single, v_p) < 1e-24);
+        }
+    }
+}
+
+
 BOOST_AUTO_TEST_CASE(test_VelocityInterpolationConstant)
 {
     testConstantVelRepro2d<VelocityInterpolationConstant>();
     testConstantVelReproPyramid<VelocityInterpolationConstant>();
     testConstantVelReproIrreg2d<VelocityInterpolationConstant>();
     testConstantVelReproIrregPrism<VelocityInterpolationConstant>();
+    testBatchInterpolation3d<VelocityInterpolationConstant>();
 }
 
 BOOST_AUTO_TEST_CASE(test_VelocityInterpolationECVI)
@@ -479,6 +569,7 @@ BOOST_AUTO_TEST_CASE(test_VelocityInterpolationECVI)
     BOOST_CHECK_THROW(testConstantVelReproPyramid<VelocityInterpolationECVI>(), std::exception);
     testConstantVelReproIrreg2d<VelocityInterpolationECVI>();
     testConstantVelReproIrregPrism<VelocityInterpolationECVI>();
+    testBatchInterpolation3d<VelocityInterpolationECVI>();
     // Though the interpolation has linear precision, the corner velocity
     // construction does not, so the below test cannot be expected to succeed.
     // testLinearVelReproIrregPrism<VelocityInterpolationECVI>();
@@ -28,6 +28,9 @@
 #define BOOST_TEST_MODULE WellCollectionTest
 #include <boost/test/unit_test.hpp>
 #include <opm/core/wells/WellCollection.hpp>
+#include <opm/core/wells/WellGroupTree.hpp>
+#include <opm/core/wells.h>
+#include <opm/core/well_controls.h>
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 #include <opm/parser/eclipse/Parser/ParseContext.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
@@ -78,3 +81,211 @@ BOOST_AUTO_TEST_CASE(AddWellsAndGroupToCollection) {
     BOOST_CHECK_EQUAL("G2", collection.findNode("PROD2")->getParent()->name());
 }
 
+
+
+namespace {
+
+    PhaseUsage waterOilPhases()
+    {
+        PhaseUsage pu;
+        pu.num_phases = 2;
+        pu.phase_used[BlackoilPhases::Aqua] = 1;
+        pu.phase_used[BlackoilPhases::Liquid] = 1;
+        pu.phase_used[BlackoilPhases::Vapour] = 0;
+        pu.phase_pos[BlackoilPhases::Aqua] = 0;
+        pu.phase_pos[BlackoilPhases::Liquid] = 1;
+        pu.phase_pos[BlackoilPhases::Vapour] = -1;
+        pu.has_solvent = false;
+        pu.has_polymer = false;
+        return pu;
+    }
+
+    // FIELD -> { G1 -> { P1, I1 }, G2 -> { G3 -> { P2, P3, I2 } } },
+    // with FIELD under ORAT and RATE control and the other groups
+    // under FLD control.
+    Wells* buildControlledHierarchy(WellCollection& collection)
+    {
+        const PhaseUsage pu = waterOilPhases();
+        ProductionSpecification field_prod;
+        field_prod.control_mode_ = ProductionSpecification::ORAT;
+        field_prod.oil_max_rate_ = 100.0;
+        InjectionSpecification field_inj;
+        field_inj.control_mode_ = InjectionSpecification::RATE;
+        field_inj.injector_type_ = InjectionSpecification::WATER;
+        field_inj.surface_flow_max_rate_ = 50.0;
+        field_inj.reinjection_fraction_target_ = 0.5;
+        field_inj.voidage_replacment_fraction_ = 0.8;
+        std::shared_ptr<WellsGroupInterface> field(new WellsGroup("FIELD", 0.9, field_prod, field_inj, pu));
+        collection.addChild(field);
+
+        const char* group_names[] = { "G1", "G2", "G3" };
+        const char* group_parents[] = { "FIELD", "FIELD", "G2" };
+        for (int g = 0; g < 3; ++g) {
+            ProductionSpecification prod_spec;
+            InjectionSpecification inj_spec;
+            prod_spec.control_mode_ = ProductionSpecification::FLD;
+            inj_spec.control_mode_ = InjectionSpecification::FLD;
+            std::shared_ptr<WellsGroupInterface> group(new WellsGroup(group_names[g], 0.8 + 0.05*g, prod_spec,
+                                                                      inj_spec, pu));
+            collection.addChild(group, group_parents[g]);
+        }
+
+        const char* well_names[] = { "P1", "I1", "P2", "P3", "I2" };
+        const char* well_parents[] = { "G1", "G1", "G3", "G3", "G3" };
+        const WellType well_types[] = { PRODUCER, INJECTOR, PRODUCER, PRODUCER, INJECTOR };
+        const double guide_rates[] = { 1.0, 2.0, 3.0, 5.0, 7.0 };
+        Wells* wells = create_wells(pu.num_phases, 5, 0);
+        for (int w = 0; w < 5; ++w) {
+            ProductionSpecification prod_spec;
+            InjectionSpecification inj_spec;
+            prod_spec.guide_rate_ = guide_rates[w];
+            inj_spec.guide_rate_ = guide_rates[w];
+            std::shared_ptr<WellsGroupInterface> well(new WellNode(well_names[w], 0.7 + 0.05*w, prod_spec,
+                                                                   inj_spec, pu));
+            collection.addChild(well, well_parents[w]);
+            add_well(well_types[w], 0.0, 0, NULL, NULL, NULL, NULL, well_names[w], 1, wells);
+        }
+        collection.setWellsPointer(wells);
+        return wells;
+    }
+
+    void checkSameControls(const Wells* expected, const Wells* actual)
+    {
+        BOOST_REQUIRE_EQUAL(expected->number_of_wells, actual->number_of_wells);
+        for (int w = 0; w < expected->number_of_wells; ++w) {
+            const WellControls* ctrl_e = expected->ctrls[w];
+            const WellControls* ctrl_a = actual->ctrls[w];
+            BOOST_REQUIRE_EQUAL(well_controls_get_num(ctrl_e), well_controls_get_num(ctrl_a));
+            BOOST_CHECK_EQUAL(well_controls_get_current(ctrl_e), well_controls_get_current(ctrl_a));
+            for (int c = 0; c < well_controls_get_num(ctrl_e); ++c) {
+                BOOST_CHECK_EQUAL(well_controls_iget_type(ctrl_e, c), well_controls_iget_type(ctrl_a, c));
+                BOOST_CHECK_CLOSE(well_controls_iget_target(ctrl_e, c), well_controls_iget_target(ctrl_a, c), 1e-12);
+                const double* distr_e = well_controls_iget_distr(ctrl_e, c);
+                const double* distr_a = well_controls_iget_distr(ctrl_a, c);
+                for (int p = 0; p < expected->number_of_phases; ++p) {
+                    BOOST_CHECK_EQUAL(distr_e[p], distr_a[p]);
+                }
+            }
+        }
+    }
+
+} // anonymous namespace
+
+
+BOOST_AUTO_TEST_CASE(FlatGroupTreeMatchesRecursion) {
+    const PhaseUsage pu = waterOilPhases();
+
+    // FIELD -> { G1 -> { P1, I1 }, G2 -> { G3 -> { P2, P3 } } }
+    const char* well_names[] = { "P1", "I1", "P2", "P3" };
+    const WellType well_types[] = { PRODUCER, INJECTOR, PRODUCER, PRODUCER };
+    const double guide_rates[] = { 1.0, 2.0, 3.0, 5.0 };
+
+    WellCollection collection;
+    std::shared_ptr<WellsGroupInterface> field(new WellsGroup("FIELD", 1.0, ProductionSpecification(),
+                                                              InjectionSpecification(), pu));
+    collection.addChild(field);
+    const char* group_names[] = { "G1", "G2", "G3" };
+    const char* group_parents[] = { "FIELD", "FIELD", "G2" };
+    for (int g = 0; g < 3; ++g) {
+        std::shared_ptr<WellsGroupInterface> group(new WellsGroup(group_names[g], 1.0, ProductionSpecification(),
+                                                                  InjectionSpecification(), pu));
+        collection.addChild(group, group_parents[g]);
+    }
+    const char* well_parents[] = { "G1", "G1", "G3", "G3" };
+    Wells* wells = create_wells(pu.num_phases, 4, 0);
+    for (int w = 0; w < 4; ++w) {
+        ProductionSpecification prod_spec;
+        InjectionSpecification inj_spec;
+        prod_spec.guide_rate_ = guide_rates[w];
+        inj_spec.guide_rate_ = guide_rates[w];
+        std::shared_ptr<WellsGroupInterface> well(new WellNode(well_names[w], 1.0, prod_spec, inj_spec, pu));
+        collection.addChild(well, well_parents[w]);
+        add_well(well_types[w], 0.0, 0, NULL, NULL, NULL, NULL, well_names[w], 1, wells);
+    }
+    collection.setWellsPointer(wells);
+
+    BOOST_CHECK_EQUAL("P2", collection.findWellNode("P2").name());
+    BOOST_CHECK_THROW(collection.findWellNode("G3"), std::runtime_error);
+    BOOST_CHECK(collection.findNode("G4") == NULL);
+
+    std::vector<std::shared_ptr<WellsGroupInterface> > roots(1, field);
+    WellGroupTree tree;
+    tree.build(roots);
+    BOOST_CHECK_EQUAL(tree.numTrees(), 1);
+    BOOST_REQUIRE_EQUAL(tree.numNodes(), 8);
+    BOOST_CHECK_EQUAL(tree.parent(0), -1);
+    for (int i = 0; i < tree.numNodes(); ++i) {
+        for (int c = tree.childBegin(i); c < tree.childEnd(i); ++c) {
+            BOOST_CHECK_EQUAL(tree.parent(c), i);
+            BOOST_CHECK(c > i);
+        }
+    }
+
+    std::vector<double> prod_rates;
+    std::vector<double> inj_rates;
+    tree.productionGuideRates(false, prod_rates);
+    tree.injectionGuideRates(false, inj_rates);
+    for (int i = 0; i < tree.numNodes(); ++i) {
+        BOOST_CHECK_EQUAL(prod_rates[i], tree.node(i)->productionGuideRate(false));
+        BOOST_CHECK_EQUAL(inj_rates[i], tree.node(i)->injectionGuideRate(false));
+    }
+    BOOST_CHECK_EQUAL(prod_rates[0], 9.0);
+    BOOST_CHECK_EQUAL(inj_rates[0], 2.0);
+
+    // Reservoir rates for (water, oil) per well; producers negative.
+    const double flows[] = { -1.0, -2.0, 0.0, 0.0, -3.0, -4.0, -5.0, -6.0 };
+    std::vector<double> phase_flows(flows, flows + 8);
+    std::vector<double> oil_flows;
+    tree.totalProductionFlows(phase_flows, BlackoilPhases::Liquid, oil_flows);
+    for (int i = 0; i < tree.numNodes(); ++i) {
+        BOOST_CHECK_EQUAL(oil_flows[i], tree.node(i)->getTotalProductionFlow(phase_flows, BlackoilPhases::Liquid));
+    }
+    BOOST_CHECK_EQUAL(oil_flows[0], -12.0);
+
+    destroy_wells(wells);
+
+    // Group controls applied by the flat sweeps of WellCollection
+    // must equal those of the recursive methods on the root.
+    WellCollection recursive;
+    WellCollection flat;
+    Wells* recursive_wells = buildControlledHierarchy(recursive);
+    Wells* flat_wells = buildControlledHierarchy(flat);
+    WellsGroupInterface* recursive_field = recursive.findNode("FIELD");
+
+    recursive_field->applyProdGroupControls();
+    recursive_field->applyInjGroupControls();
+    flat.applyGroupControls();
+    BOOST_CHECK(well_controls_get_num(flat_wells->ctrls[0]) > 0);
+    BOOST_CHECK(well_controls_get_num(flat_wells->ctrls[4]) > 0);
+    checkSameControls(recursive_wells, flat_wells);
+    const char* controlled_groups[] = { "FIELD", "G1", "G2", "G3" };
+    for (int g = 0; g < 4; ++g) {
+        BOOST_CHECK_EQUAL(recursive.findNode(controlled_groups[g])->prodSpec().control_mode_,
+                          flat.findNode(controlled_groups[g])->prodSpec().control_mode_);
+        BOOST_CHECK_EQUAL(recursive.findNode(controlled_groups[g])->injSpec().control_mode_,
+                          flat.findNode(controlled_groups[g])->injSpec().control_mode_);
+    }
+
+    // Explicit reinjection only reaches wells under group control.
+    const char* injector_names[] = { "I1", "I2" };
+    for (int i = 0; i < 2; ++i) {
+        recursive.findNode(injector_names[i])->setIndividualControl(false);
+        flat.findNode(injector_names[i])->setIndividualControl(false);
+    }
+    const double reservoir[] = { -1.0, -2.0, 0.0, 0.0, -3.0, -4.0, -5.0, -6.0, 0.0, 0.0 };
+    const double surface[] = { -1.5, -2.5, 0.0, 0.0, -3.5, -4.5, -5.5, -6.5, 0.0, 0.0 };
+    const std::vector<double> reservoir_rates(reservoir, reservoir + 10);
+    const std::vector<double> surface_rates(surface, surface + 10);
+    const InjectionSpecification::ControlMode reinjection_modes[] = { InjectionSpecification::REIN,
+                                                                      InjectionSpecification::VREP };
+    for (int m = 0; m < 2; ++m) {
+        recursive_field->injSpec().control_mode_ = reinjection_modes[m];
+        flat.findNode("FIELD")->injSpec().control_mode_ = reinjection_modes[m];
+        recursive_field->applyExplicitReinjectionControls(reservoir_rates, surface_rates);
+        flat.applyExplicitReinjectionControls(reservoir_rates, surface_rates);
+        checkSameControls(recursive_wells, flat_wells);
+    }
+
+    destroy_wells(recursive_wells);
+    destroy_wells(flat_wells);
+}
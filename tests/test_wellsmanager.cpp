@@ -34,6 +34,7 @@
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 
 #include <opm/core/wells/WellsManager.hpp>
+#include <opm/core/wells/WellGeometryCache.hpp>
 #include <opm/core/wells.h>
 #include <opm/core/well_controls.h>
 
@@ -266,6 +267,53 @@ BOOST_AUTO_TEST_CASE(ControlsEqual) {
     BOOST_CHECK(!well_controls_equal( wellsManager1.c_wells()->ctrls[1] , wellsManager0.c_wells()->ctrls[1] , false));
 }
 
+BOOST_AUTO_TEST_CASE(GeometryCacheReused) {
+    const std::string filename = "wells_manager_data.data";
+    Opm::ParseContext parseContext;
+    Opm::Parser parser;
+    Opm::Deck deck(parser.parseFile(filename, parseContext));
+    Opm::EclipseState eclipseState(deck, parseContext);
+    Opm::GridManager gridManager(eclipseState.getInputGrid());
+    const auto& grid = eclipseState.getInputGrid();
+    const Opm::TableManager table ( deck );
+    const Opm::Eclipse3DProperties eclipseProperties ( deck , table, grid);
+    const Opm::Schedule sched(deck, grid, eclipseProperties, Opm::Phases(true, true, true), parseContext );
+    const UnstructuredGrid& g = *gridManager.c_grid();
+
+    // Cached wells must match wells built from scratch at every step.
+    Opm::WellGeometryCache cache;
+    for (size_t step : { 0, 1, 3 }) {
+        Opm::WellsManager cached(eclipseState, sched, step, g, cache);
+        Opm::WellsManager uncached(eclipseState, sched, step, g);
+        BOOST_CHECK(wells_equal(cached.c_wells(), uncached.c_wells(), false));
+    }
+
+    // Same content at a different address hits the cache.
+    std::vector<int> global_cell;
+    if (g.global_cell) {
+        global_cell.assign(g.global_cell, g.global_cell + g.number_of_cells);
+    }
+    const int* gc = global_cell.empty() ? 0 : global_cell.data();
+    BOOST_CHECK(!cache.init(eclipseState, g.number_of_cells, gc, g.cartdims));
+
+    // A different active cell map is extracted again.
+    std::vector<int> fewer_cells(g.number_of_cells - 1);
+    for (int c = 0; c < g.number_of_cells - 1; ++c) {
+        fewer_cells[c] = g.global_cell ? g.global_cell[c] : c;
+    }
+    BOOST_CHECK(cache.init(eclipseState, g.number_of_cells - 1, fewer_cells.data(), g.cartdims));
+    {
+        Opm::WellsManager cached(eclipseState, sched, 1, g, cache);
+        Opm::WellsManager uncached(eclipseState, sched, 1, g);
+        BOOST_CHECK(wells_equal(cached.c_wells(), uncached.c_wells(), false));
+    }
+
+    // Explicit invalidation.
+    BOOST_CHECK(!cache.init(eclipseState, g.number_of_cells, g.global_cell, g.cartdims));
+    cache.invalidate();
+    BOOST_CHECK(cache.init(eclipseState, g.number_of_cells, g.global_cell, g.cartdims));
+}
+
 BOOST_AUTO_TEST_CASE(WellShutOK) {
     const std::string filename = "wells_manager_data.data";
     Opm::ParseContext parseContext;